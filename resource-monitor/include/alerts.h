@@ -0,0 +1,116 @@
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/* ==================== REGRAS DE ALERTA ==================== */
+
+/*
+ * Regras avaliadas na thread de amostragem, a cada valor coletado:
+ *
+ *   <metrica> <op> <limiar> [for <dur>] [clear <valor>] [cooldown <dur>] [do <ação>]
+ *   <metrica> rising|falling <op> <taxa>/<s|min|h> [over <dur>] [...mesmas cláusulas]
+ *
+ * op: > >= < <=. Quantidades aceitam sufixo K/M/G (potências de 1024, com ou
+ * sem B); em métricas *_kb o valor é convertido para kB ("10MB" = 10240).
+ * Durações: 500ms, 5s, 2min, 1h (sem unidade = segundos).
+ *
+ *   for      a condição precisa se manter por esse tempo antes de disparar
+ *   clear    histerese: o alerta só volta ao normal ao cruzar este valor
+ *            (padrão: o próprio limiar)
+ *   cooldown intervalo mínimo entre duas notificações da mesma regra
+ *   over     janela da taxa de variação (padrão 10s)
+ *   do       log (padrão, linha em stderr) | exec:<comando> | fifo:<caminho>
+ *
+ * exec roda "/bin/sh -c <comando>" com $1 = regra, $2 = disparado|normalizado,
+ * $3 = valor e $4 = PID. fifo escreve uma linha por evento sem bloquear.
+ */
+typedef enum {
+    ALERTA_MAIOR = 0,
+    ALERTA_MAIOR_IGUAL,
+    ALERTA_MENOR,
+    ALERTA_MENOR_IGUAL
+} alerta_op_t;
+
+typedef enum {
+    ALERTA_VALOR = 0,   // o próprio valor da métrica
+    ALERTA_SUBINDO,     // taxa de variação por segundo
+    ALERTA_DESCENDO     // taxa de queda por segundo (positiva quando cai)
+} alerta_tipo_t;
+
+typedef enum {
+    ALERTA_ACAO_LOG = 0,
+    ALERTA_ACAO_EXEC,
+    ALERTA_ACAO_FIFO
+} alerta_acao_t;
+
+typedef enum {
+    ALERTA_OK = 0,
+    ALERTA_PENDENTE,    // condição verdadeira, aguardando 'for'
+    ALERTA_DISPARADO
+} alerta_estado_t;
+
+#define ALERTA_TEXTO_MAX   256
+#define ALERTA_METRICA_MAX 32
+#define ALERTA_FILHOS_MAX  16     // comandos exec ainda rodando
+#define ALERTA_JANELA_PADRAO_NS (10LL * 1000000000LL)
+
+typedef struct {
+    char            texto[ALERTA_TEXTO_MAX];      // regra como foi escrita
+    char            metrica[ALERTA_METRICA_MAX];
+    alerta_tipo_t   tipo;
+    alerta_op_t     op;
+    double          limiar;         // unidade da métrica (por segundo nas taxas)
+    double          limiar_normal;  // histerese
+    long long       durante_ns;
+    long long       espera_ns;      // cooldown
+    long long       janela_ns;      // taxas
+    alerta_acao_t   acao;
+    char            destino[ALERTA_TEXTO_MAX];    // comando ou caminho da FIFO
+
+    /* estado */
+    alerta_estado_t estado;
+    long long       desde_ns;       // início da condição (PENDENTE)
+    long long       ultimo_aviso_ns;
+    int             avisado;        // o disparo atual foi notificado (fora do cooldown)
+    long long       ref_ns;         // referência da taxa
+    double          ref_valor;
+    int             ref_valida;
+    double          taxa;
+    int             taxa_valida;
+    unsigned long   disparos;
+    unsigned long   suprimidos;     // disparos dentro do cooldown
+} alerta_regra_t;
+
+typedef struct {
+    alerta_regra_t *regras;
+    size_t          num;
+    size_t          cap;
+    pid_t           filhos[ALERTA_FILHOS_MAX];
+    int             num_filhos;
+    unsigned long   acoes_perdidas; // exec sem vaga ou FIFO sem leitor
+} alertas_t;
+
+/* Interpreta uma regra. Retorna -1 (com mensagem em stderr) se a sintaxe é inválida */
+int alerta_interpretar(const char *texto, alerta_regra_t *out);
+
+int  alertas_adicionar(alertas_t *al, const char *texto);
+/* Uma regra por linha; linhas vazias e iniciadas por '#' são ignoradas */
+int  alertas_carregar(alertas_t *al, const char *arquivo);
+void alertas_destruir(alertas_t *al);
+
+/*
+ * Avalia as regras da métrica com um novo valor (mono_ns = CLOCK_MONOTONIC da
+ * coleta). Retorna quantas regras dispararam nesta chamada.
+ */
+int alertas_observar(alertas_t *al, pid_t pid, const char *metrica,
+                     long long mono_ns, double valor);
+
+/* Regras das opções --alerta/--alertas (vazio até a primeira regra) */
+alertas_t *alertas_padrao(void);
+
+/* Linha de resumo em stderr (disparos por regra); nada se não houve disparo */
+void alertas_relatar(const alertas_t *al);
+
+#endif /* ALERTS_H */
@@ -3,6 +3,8 @@
 
 #include <sys/types.h>
 
+#include "psi.h"
+
 /* Estruturas para métricas de cgroup */
 typedef struct {
     char name[64];
@@ -12,6 +14,8 @@ typedef struct {
     unsigned long long io_read_bytes;
     unsigned long long io_write_bytes;
     unsigned long memory_failcnt;
+    psi_t pressao[PSI_NUM_RECURSOS];   /* cpu/memory/io.pressure (árvore v2) */
+    unsigned pressao_lida;             /* bit r: pressao[r] foi lido */
 } cgroup_metrics_t;
 
 /* API do Control Group Manager */
@@ -24,6 +28,8 @@ int cgroup_ler_cpu_usage(const char *cgroup_name, unsigned long long *cpu_usage)
 int cgroup_ler_memory_usage(const char *cgroup_name, unsigned long long *memory_usage);
 int cgroup_ler_io_stats(const char *cgroup_name, unsigned long long *read_bytes, unsigned long long *write_bytes);
 int cgroup_ler_metricas_completas(const char *cgroup_name, cgroup_metrics_t *metrics);
+// Cgroup de um processo ("" = raiz), no formato aceito pelas leituras acima
+int cgroup_do_processo(pid_t pid, char *out, size_t size);
 
 // Gerenciamento de cgroups
 int cgroup_criar(const char *cgroup_name, double cpu_limit_cores, unsigned long memory_limit_mb);
@@ -0,0 +1,66 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <sys/types.h>
+
+#include "psi.h"
+
+/* ==================== MODO DAEMON (SOCKET UNIX) ==================== */
+
+/*
+ * Processo de longa duração que amostra continuamente um conjunto de alvos
+ * (cada um com seu intervalo) e atende clientes em um socket Unix. O estado
+ * de delta, o histórico (timeseries.h), os percentis (quantile.h) e as regras
+ * de alerta de cada alvo vivem enquanto o daemon roda, então uma consulta não
+ * paga o sleep de aquecimento de um processo novo.
+ *
+ * Protocolo: uma linha de texto por comando; cada resposta é UMA linha JSON
+ * ({"ok":true,...} ou {"ok":false,"erro":"..."}).
+ *
+ *   add <pid> [intervalo_ms]          passa a amostrar o PID
+ *   remove <pid>
+ *   interval <pid> <intervalo_ms>
+ *   list                              alvos, intervalos e nº de amostras
+ *   latest <pid>                      última amostra (mesmas colunas do 'all')
+ *   history <pid> <metrica> [bruto|10s|1min] [max]
+ *   percentiles <pid>                 mín/p50/p90/p99/máx desde o add
+ *   subscribe [pid]                   passa a receber {"evento":"amostra",...} a cada tick
+ *   unsubscribe
+ *   shutdown
+ *
+ * Um único thread com poll(): socket de escuta, clientes, os pidfds dos
+ * alvos (término detectado na hora) e os gatilhos PSI (psi.h). Quando um
+ * gatilho dispara, todos os alvos são amostrados na hora, fora da grade, e
+ * os assinantes recebem {"evento":"pressao",...}. Clientes lentos não
+ * atrasam a coleta: linhas de stream que não cabem no buffer do cliente são
+ * descartadas e contadas.
+ */
+#define DAEMON_ALVOS_MAX        64
+#define DAEMON_CLIENTES_MAX     32
+#define DAEMON_HTTP_MAX         16     // conexões de scrape simultâneas
+#define DAEMON_GATILHOS_MAX     8      // gatilhos PSI (--psi)
+#define DAEMON_LINHA_MAX        1024
+#define DAEMON_SAIDA_CAP        (256 * 1024)
+#define DAEMON_INTERVALO_PADRAO 1000
+#define DAEMON_SOCKET_PADRAO    "/tmp/resource-monitor.sock"
+
+/*
+ * Roda até SIGINT/SIGTERM ou o comando shutdown. 'pids'/'intervalos' são os
+ * alvos iniciais (podem ser vazios). 'metricas' ("[host:]porta" ou caminho de
+ * socket Unix, NULL = desligado) abre o endpoint OpenMetrics (openmetrics.h),
+ * com a página remontada uma vez por tick. 'gatilhos' (até DAEMON_GATILHOS_MAX)
+ * são registrados no kernel antes do loop. Retorna 0 ou -1 se um dos sockets
+ * ou gatilhos não pôde ser criado.
+ */
+int daemon_executar(const char *caminho, const char *metricas,
+                    const pid_t *pids, const int *intervalos, int num_alvos,
+                    const psi_gatilho_t *gatilhos, int num_gatilhos);
+
+/*
+ * Cliente simples: envia um comando e imprime a resposta em stdout. Com
+ * subscribe, continua imprimindo o stream até o daemon fechar a conexão.
+ * Retorna 0 se a resposta foi "ok":true.
+ */
+int daemon_enviar(const char *caminho, const char *comando);
+
+#endif /* DAEMON_H */
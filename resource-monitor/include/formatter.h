@@ -0,0 +1,84 @@
+#ifndef FORMATTER_H
+#define FORMATTER_H
+
+#include <stddef.h>
+
+/* ==================== SAÍDA FORMATADA SEM ALOCAÇÃO ==================== */
+
+/*
+ * Camada de saída dos loops de alto volume: os valores são convertidos por
+ * rotinas próprias (sem printf) para um buffer reutilizado e vão para o fd
+ * com write() quando o buffer enche, quando vence o intervalo de flush ou
+ * em saida_descarregar. A mesma definição de registro gera CSV ou JSON Lines.
+ */
+typedef enum {
+    SAIDA_CSV = 0,
+    SAIDA_JSONL
+} saida_formato_t;
+
+typedef enum {
+    CAMPO_TEXTO = 0,    // CSV: ',' '"' e quebras viram '_'; JSON: string escapada
+    CAMPO_INT,          // inteiro com sinal
+    CAMPO_UINT,         // inteiro sem sinal
+    CAMPO_FIXO          // real com 'casas' decimais (NaN/inf viram null no JSON)
+} saida_campo_tipo_t;
+
+typedef struct {
+    const char         *nome;
+    saida_campo_tipo_t  tipo;
+    int                 casas;
+} saida_campo_t;
+
+#define SAIDA_BUF_PADRAO        (256 * 1024)
+#define SAIDA_FLUSH_PADRAO_MS   1000
+
+typedef struct {
+    int                  fd;
+    saida_formato_t      formato;
+    const saida_campo_t *campos;
+    size_t               num_campos;
+    size_t               campo_atual;     // próximo campo da linha em montagem
+    char                *buf;
+    size_t               tam;
+    size_t               cap;
+    long long            intervalo_ns;    // flush por tempo (0 = só por tamanho/explícito)
+    long long            ultimo_flush_ns; // CLOCK_MONOTONIC
+    unsigned long long   bytes_escritos;
+    unsigned long        chamadas_write;
+    int                  erro;            // errno da primeira falha de escrita
+} saida_t;
+
+/*
+ * Prepara a saída sobre 'fd' (não é fechado em saida_fechar). 'campos' deve
+ * viver até o fechamento. cap_buf = 0 usa SAIDA_BUF_PADRAO; intervalo_ms < 0
+ * usa SAIDA_FLUSH_PADRAO_MS.
+ */
+int saida_abrir(saida_t *s, int fd, saida_formato_t formato,
+                const saida_campo_t *campos, size_t num_campos,
+                size_t cap_buf, int intervalo_ms);
+
+/* Linha de cabeçalho com os nomes (só CSV; no JSON Lines os nomes vão em cada linha) */
+void saida_cabecalho(saida_t *s);
+
+/* Valores da linha atual, na ordem dos campos */
+void saida_texto(saida_t *s, const char *valor);
+void saida_int(saida_t *s, long long valor);
+void saida_uint(saida_t *s, unsigned long long valor);
+void saida_fixo(saida_t *s, double valor);
+void saida_nulo(saida_t *s);   // não medido: campo vazio no CSV, null no JSON
+
+/* Fecha a linha; descarrega se o buffer passou de 3/4 ou se venceu o intervalo */
+void saida_fim_linha(saida_t *s);
+
+/* Escreve tudo o que está no buffer. Retorna 0 ou -1 (erro de escrita) */
+int saida_descarregar(saida_t *s);
+
+/* Descarrega, libera o buffer e retorna -1 se alguma escrita falhou */
+int saida_fechar(saida_t *s);
+
+/* ==================== FORMATO PADRÃO (opção global --formato) ==================== */
+
+int             saida_selecionar(const char *nome);   // "csv" ou "jsonl"
+saida_formato_t saida_formato_padrao(void);
+
+#endif /* FORMATTER_H */
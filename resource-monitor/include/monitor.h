@@ -2,6 +2,7 @@
 #define MONITOR_H
 
 #include <stdio.h>
+#include <dirent.h>
 #include <sys/types.h> // pid_t
 
 /* ==================== ESTRUTURAS DE DADOS ==================== */
@@ -16,6 +17,8 @@ unsigned long long iowait;
 unsigned long long irq;
 unsigned long long softirq;
 unsigned long long steal;
+unsigned long long guest; // já contabilizado em user (não entra no total)
+unsigned long long guest_nice; // já contabilizado em nice (não entra no total)
 unsigned long long total;
 unsigned long long active;
 } cpu_times_t;
@@ -24,9 +27,41 @@ unsigned long long active;
 typedef struct {
 unsigned long long utime;
 unsigned long long stime;
-unsigned long long total_time;
+unsigned long long total_time; // /proc: + cutime/cstime (filhos recolhidos); taskstats: sem filhos
 } proc_cpu_t;
 
+/* Contadores do escalonador de um processo, somados em todas as threads
+ * (/proc/<pid>/task/<tid>/schedstat e as linhas *ctxt_switches do status) */
+typedef struct {
+unsigned long long run_ns; // tempo executando em CPU
+unsigned long long espera_ns; // pronto na run queue, esperando CPU
+unsigned long long fatias; // vezes que ganhou a CPU
+unsigned long long trocas_voluntarias; // bloqueou (I/O, lock, sleep)
+unsigned long long trocas_involuntarias; // preemptado com trabalho pendente
+int threads;
+} proc_sched_t;
+
+/* Última leitura de uma thread (base do delta) e seus arquivos mantidos abertos */
+typedef struct {
+pid_t tid;
+int fd_schedstat; // pread no offset 0 a cada amostra (-1: sem descritor livre)
+int fd_status;
+int visto; // marcado na varredura de /proc/<pid>/task
+int com_base; // v vale como base do próximo delta
+proc_sched_t v;
+} cpu_sched_thread_t;
+
+/* Estado entre amostras: /proc/<pid>/schedstat só cobre a thread principal,
+ * então o delta é feito por thread e somado */
+typedef struct {
+pid_t pid;
+DIR *dir; // /proc/<pid>/task mantido aberto (um getdents por amostra)
+cpu_sched_thread_t *threads; // ordenado por tid
+size_t num;
+size_t cap;
+int sem_fd; // threads fora da soma (limite de descritores)
+} cpu_sched_t;
+
 /* Estatísticas de I/O de processo/sistema */
 typedef struct {
 unsigned long long read_bytes;
@@ -62,17 +97,59 @@ unsigned long long swap_free_kb;
 /* Leitura da linha "cpu" de /proc/stat */
 int cpu_ler_times_sistema(cpu_times_t *out);
 
-/* Percentual de uso de CPU do sistema entre duas leituras */
+/* Interpreta a linha "cpu" a partir do conteúdo já lido de /proc/stat */
+int cpu_interpretar_stat_sistema(const char *conteudo, cpu_times_t *out);
+
+/* Leitura das linhas "cpuN" de /proc/stat: cores[N] recebe os tempos do core N.
+ * Retorna o número de posições preenchidas (maior N + 1, limitado a max_cores) ou -1 */
+int cpu_ler_times_por_core(cpu_times_t *cores, int max_cores);
+
+/* Interpreta as linhas "cpuN" a partir do conteúdo já lido de /proc/stat */
+int cpu_interpretar_stat_por_core(const char *conteudo, cpu_times_t *cores, int max_cores);
+
+/* Número de cores configurados (tamanho adequado para os vetores por core) */
+int cpu_num_cores(void);
+
+/* Percentual de uso de CPU do sistema (ou de um core) entre duas leituras */
 double cpu_calculo_percentual(const cpu_times_t *antes, const cpu_times_t *depois);
 
-/* Leitura de tempos de CPU de um processo específico (PID) */
+/* Leitura de tempos de CPU de um processo específico (PID), da origem de cpu_origem_processo */
 int cpu_ler_processo(pid_t pid, proc_cpu_t *out);
 
+/* Origem dos tempos de CPU para um run inteiro: 1 = taskstats (backend
+ * selecionado e respondendo para 'pid'), 0 = /proc. As duas não somam os
+ * mesmos tempos (total_time), então um delta nunca pode misturá-las */
+int cpu_origem_processo(pid_t pid);
+
+/* Lê só da origem dada, sem cair para a outra (-1 se ela falhar) */
+int cpu_ler_processo_de(pid_t pid, int origem_taskstats, proc_cpu_t *out);
+
+/* Interpreta tempos de CPU a partir do conteúdo já lido de /proc/<pid>/stat */
+int cpu_interpretar_stat_processo(const char *conteudo, proc_cpu_t *out);
+
 /* Percentual de CPU de um processo em relação ao total da máquina */
 double cpu_calculo_percentual_processo(const proc_cpu_t *antes, const proc_cpu_t *depois,
 const cpu_times_t *sys_antes, const cpu_times_t *sys_depois);
 
-/* Loop de monitoramento que grava CSV (timestamp, amostra, cpu_proc, cpu_sys) */
+/* Interpreta /proc/<pid>/schedstat ("run_ns espera_ns fatias") já lido */
+int cpu_interpretar_schedstat(const char *conteudo, proc_sched_t *out);
+
+/* Interpreta voluntary_ctxt_switches/nonvoluntary_ctxt_switches do status já lido */
+int cpu_interpretar_trocas_contexto(const char *status, proc_sched_t *out);
+
+/* Abre /proc/<pid>/task e os dois arquivos de cada thread e faz a primeira
+ * leitura (base). -1 se o processo não existe */
+int cpu_sched_iniciar(cpu_sched_t *s, pid_t pid);
+
+/* Soma dos deltas por thread desde a leitura anterior: threads novas entram
+ * inteiras, as que saíram perdem só o último intervalo. Só threads novas
+ * custam open; as demais são dois pread. -1 se o processo sumiu */
+int cpu_sched_delta(cpu_sched_t *s, proc_sched_t *delta);
+
+void cpu_sched_liberar(cpu_sched_t *s);
+
+/* Loop de monitoramento que grava CSV (timestamp, amostra, cpu_proc, cpu_sys, espera na run
+ * queue, trocas de contexto, cpu0..cpuN) */
 int cpu_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida);
 
 /* Uso "instantâneo" de CPU de um processo (mantém estado interno por PID) */
@@ -86,13 +163,27 @@ int cpu_gerar_relatorio(pid_t pid, FILE *out);
 
 /* ==================== API DE MONITORAMENTO DE I/O ==================== */
 
-/* Leitura de estatísticas de I/O de um processo */
+/* Leitura de estatísticas de I/O de um processo, da origem de io_origem_processo */
 int io_ler_stats_processo(pid_t pid, io_stats_t *stats);
 
-/* Cálculo de taxas de I/O entre duas leituras */
+/* Origem do I/O para um run inteiro: 1 = taskstats (backend selecionado e a
+ * consulta por TGID traz I/O), 0 = /proc/<pid>/io */
+int io_origem_processo(pid_t pid);
+
+/* Lê só da origem dada, sem cair para a outra (-1 se ela falhar) */
+int io_ler_stats_processo_de(pid_t pid, int origem_taskstats, io_stats_t *stats);
+
+/* Interpreta /proc/<pid>/io (+ /proc/<pid>/stat opcional, pode ser NULL) já lidos */
+int io_interpretar_processo(const char *io, const char *stat, io_stats_t *stats);
+
+/* Cálculo de taxas de I/O entre duas leituras (intervalo nominal em ms) */
 int io_calcular_taxas(const io_stats_t *antes, const io_stats_t *depois,
 int intervalo_ms, io_stats_t *taxas);
 
+/* Cálculo de taxas de I/O sobre o tempo realmente decorrido (CLOCK_MONOTONIC, ns) */
+int io_calcular_taxas_ns(const io_stats_t *antes, const io_stats_t *depois,
+long long decorrido_ns, io_stats_t *taxas);
+
 /* Monitoramento contínuo com saída CSV */
 int io_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida);
 
@@ -119,9 +210,15 @@ int io_gerar_relatorio(pid_t pid, FILE *saida);
 /* Leitura de estatísticas de memória de um processo */
 int mem_ler_processo(pid_t pid, mem_proc_stats_t *out);
 
+/* Interpreta /proc/<pid>/status (+ /proc/<pid>/stat opcional, pode ser NULL) já lidos */
+int mem_interpretar_processo(const char *status, const char *stat, mem_proc_stats_t *out);
+
 /* Leitura de estatísticas de memória do sistema */
 int mem_ler_sistema(mem_sys_stats_t *out);
 
+/* Interpreta o conteúdo já lido de /proc/meminfo */
+int mem_interpretar_sistema(const char *meminfo, mem_sys_stats_t *out);
+
 /* Cálculo de percentual de uso de memória */
 double mem_calcular_percentual_uso(const mem_proc_stats_t *proc,
 const mem_sys_stats_t *sys);
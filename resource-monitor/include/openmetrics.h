@@ -0,0 +1,82 @@
+#ifndef OPENMETRICS_H
+#define OPENMETRICS_H
+
+#include <stddef.h>
+
+/* ==================== EXPOSIÇÃO OPENMETRICS ==================== */
+
+/*
+ * Página de métricas no formato texto do OpenMetrics (aceito pelo Prometheus),
+ * montada UMA vez por tick e servida por HTTP a quantos scrapers houver. Cada
+ * scrape só copia bytes prontos para o socket: o custo não depende de quantos
+ * alvos existem nem de quantos scrapers batem no endpoint.
+ *
+ * A página publicada é imutável e tem contagem de referências: uma conexão
+ * que ainda está enviando a página anterior continua com ela, e a nova entra
+ * no lugar para os próximos scrapes.
+ */
+#define OM_CONTENT_TYPE   "application/openmetrics-text; version=1.0.0; charset=utf-8"
+#define OM_CAMINHO        "/metrics"
+#define OM_REQUISICAO_MAX 2048
+#define OM_ROTULO_MAX     256
+
+/* Texto em construção (cresce com realloc; a capacidade é reaproveitada entre ticks) */
+typedef struct {
+    char   *buf;
+    size_t  tam;
+    size_t  cap;
+    int     erro;   // faltou memória: a publicação falha e a página anterior continua valendo
+} om_texto_t;
+
+typedef struct {
+    int    refs;
+    size_t tam;
+    char   dados[];
+} om_pagina_t;
+
+/* Linhas "# TYPE" e "# HELP" (nome da família: sem o sufixo _total nos contadores) */
+void om_familia(om_texto_t *t, const char *nome, const char *tipo, const char *ajuda);
+
+/* Uma amostra: nome{rotulos} valor (rotulos pode ser NULL ou vazio) */
+void om_inteiro(om_texto_t *t, const char *nome, const char *rotulos, unsigned long long valor);
+void om_valor(om_texto_t *t, const char *nome, const char *rotulos, double valor);
+
+/* Escapa \ " e quebra de linha para uso dentro de um rótulo */
+void om_escapar(const char *src, char *dst, size_t tam);
+
+/* Fecha a página com "# EOF" e copia para uma página nova (refs = 1); o texto é zerado */
+om_pagina_t *om_publicar(om_texto_t *t);
+void om_pagina_soltar(om_pagina_t *p);
+void om_texto_liberar(om_texto_t *t);
+
+/* ==================== HTTP MÍNIMO ==================== */
+
+/*
+ * Uma requisição por conexão (Connection: close). GET/HEAD em /metrics
+ * responde a página; outros caminhos dão 404 e outros métodos 405.
+ */
+typedef struct {
+    int          fd;
+    char         req[OM_REQUISICAO_MAX];
+    size_t       tam_req;
+    char         cab[256];      // cabeçalho da resposta
+    size_t       tam_cab;
+    om_pagina_t *pagina;        // referência segurada até o fim do envio
+    const char  *corpo;
+    size_t       tam_corpo;
+    size_t       enviado;       // bytes de cab + corpo já enviados
+    int          respondendo;
+} om_conexao_t;
+
+/* "[host:]porta" (TCP, host padrão 127.0.0.1) ou caminho absoluto de socket Unix */
+int om_abrir_escuta(const char *endereco);
+
+/* Lê o que houver. 1 = resposta montada (passe a escrever), 0 = aguardando, -1 = fechar */
+int om_conexao_ler(om_conexao_t *c, om_pagina_t *pagina);
+
+/* Envia sem bloquear. 1 = terminou, 0 = falta (espere POLLOUT), -1 = erro */
+int om_conexao_escrever(om_conexao_t *c);
+
+void om_conexao_fechar(om_conexao_t *c);
+
+#endif /* OPENMETRICS_H */
@@ -0,0 +1,76 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+/* ==================== CONTADORES DE SOFTWARE (perf_event_open) ==================== */
+
+/*
+ * Eventos de software do kernel por thread: exatos e com resolução de ns, ao
+ * contrário de utime/stime do /proc/<pid>/stat, que andam em jiffies (10 ms
+ * com HZ=100). Com intervalos de 10-50 ms o CPU% em jiffies oscila entre 0 e
+ * múltiplos de 20-100%; o task-clock não.
+ *
+ * Cada thread do processo tem um grupo (líder task-clock + 4 membros) e o
+ * grupo inteiro sai em UM read() por tick (PERF_FORMAT_GROUP). As threads
+ * são reconciliadas com /proc/<pid>/task a cada leitura: novas ganham grupo,
+ * as que saíram têm a contagem final preservada, então os totais só crescem.
+ *
+ * Precisa de kernel.perf_event_paranoid <= 2 para processos do próprio
+ * usuário (ou CAP_PERFMON para os demais). Com paranoid = 2 só o modo
+ * usuário é contado: trocas de contexto e migrações acontecem no kernel e
+ * ficam indisponíveis (colunas vazias no CSV, null no JSON); task-clock e
+ * faltas continuam válidos.
+ */
+typedef enum {
+    PERF_EV_TASK_CLOCK = 0,     // ns de CPU
+    PERF_EV_TROCAS_CONTEXTO,
+    PERF_EV_MIGRACOES,
+    PERF_EV_FALTAS,
+    PERF_EV_FALTAS_MAIORES,
+    PERF_NUM_EVENTOS
+} perf_evento_t;
+
+typedef struct {
+    pid_t tid;
+    int   fds[PERF_NUM_EVENTOS];  // fds[0] é o líder do grupo
+    int   visto;                  // marcado na varredura de /proc/<pid>/task
+} perf_thread_t;
+
+typedef struct {
+    pid_t              pid;
+    perf_thread_t     *threads;     // ordenado por tid
+    size_t             num;
+    size_t             cap;
+    unsigned long long encerradas[PERF_NUM_EVENTOS];  // contagem final de threads que saíram
+    int                so_usuario;  // exclude_kernel: paranoid não permitiu contar o kernel
+    int                sem_fd;      // threads sem contador (limite de descritores)
+} perf_contadores_t;
+
+typedef struct {
+    unsigned long long valores[PERF_NUM_EVENTOS];  // acumulado desde perf_abrir
+    int                threads;                    // threads com contador nesta leitura
+} perf_leitura_t;
+
+/* Nome da coluna CSV de cada evento */
+const char *perf_nome_evento(perf_evento_t ev);
+
+/* 0 se o evento não é contado no modo de 'pc' (kernel-only com so_usuario) */
+int perf_evento_disponivel(const perf_contadores_t *pc, perf_evento_t ev);
+
+/* Abre os grupos das threads atuais (0 ou -1 com mensagem em stderr) */
+int  perf_abrir(perf_contadores_t *pc, pid_t pid);
+void perf_fechar(perf_contadores_t *pc);
+
+/* Reconcilia as threads e faz um read() de grupo por thread. -1 se o processo sumiu */
+int  perf_ler(perf_contadores_t *pc, perf_leitura_t *out);
+
+/*
+ * Loop CSV (ou JSON Lines, --formato): CPU% exato, task-clock e taxas de trocas
+ * de contexto/migrações/faltas. O fim do alvo (inclusive PID reciclado) é
+ * relatado em stderr e encerra o loop com 0.
+ */
+int  perf_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida);
+
+#endif /* PERF_COUNTERS_H */
@@ -0,0 +1,89 @@
+#ifndef PROC_BATCH_H
+#define PROC_BATCH_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "proc_cache.h"
+
+/* ==================== LEITURA EM LOTE DO /proc ==================== */
+
+/* Como as leituras de um tick são feitas */
+typedef enum {
+    LOTE_PREAD = 0,     // um pread por arquivo (sempre disponível)
+    LOTE_URING          // todos os reads do tick submetidos de uma vez via io_uring
+} lote_modo_t;
+
+/* Bit de um arquivo por PID na máscara do lote */
+#define LOTE_BIT(arq) (1u << (arq))
+
+/* Um PID do lote: descritores persistentes e o conteúdo da última leitura */
+typedef struct {
+    pid_t  pid;
+    int    fd[PROC_ARQ_POR_PID];    // -1 = fechado (aberto sob demanda)
+    char  *buf[PROC_ARQ_POR_PID];
+    size_t cap[PROC_ARQ_POR_PID];
+    long   tam[PROC_ARQ_POR_PID];   // bytes lidos no tick, ou -errno
+} lote_alvo_t;
+
+typedef struct {
+    lote_alvo_t *alvos;             // ordenados por PID
+    size_t       num_alvos;
+    size_t       cap_alvos;
+    unsigned     mascara;           // LOTE_BIT() dos arquivos lidos a cada tick
+    int          dirfd;             // base de "<pid>/<arquivo>" (não é fechado pelo lote)
+    lote_modo_t  modo;              // modo efetivo (LOTE_URING cai para LOTE_PREAD)
+    long         fds_abertos;
+    long         fds_max;           // acima disso: open/read/close a cada tick
+    void        *anel;              // estado do io_uring (NULL no modo pread)
+} proc_lote_t;
+
+/*
+ * Prepara um lote que lê, a cada tick, os arquivos de 'mascara' de cada PID
+ * relativo a 'dirfd' (dirfd de /proc, ou de /proc/<pid>/task para threads).
+ * Com LOTE_URING, tenta criar um io_uring via syscalls diretas (sem liburing);
+ * se o kernel não suportar ou estiver desabilitado, usa LOTE_PREAD.
+ * Mantém descritores persistentes até o limite flexível de RLIMIT_NOFILE (menos
+ * uma reserva); elevar o limite fica a cargo do programa (main.c o faz na partida).
+ */
+int  proc_lote_iniciar(proc_lote_t *l, int dirfd, unsigned mascara, lote_modo_t modo);
+void proc_lote_destruir(proc_lote_t *l);
+
+/*
+ * Define o conjunto de PIDs do lote. PIDs que continuam mantêm descritores e
+ * buffers; os que saíram são fechados. Repetições são aceitas (cada uma é uma
+ * entrada independente). Retorna 0 ou -1 (sem memória).
+ */
+int proc_lote_definir(proc_lote_t *l, const pid_t *pids, size_t n);
+
+/*
+ * Lê todos os arquivos de todos os PIDs. No modo uring, uma submissão por
+ * bloco de até PROC_LOTE_ANEL leituras, com as conclusões gravadas direto
+ * nos buffers de cada PID. PID reciclado (ESRCH no descritor antigo) é
+ * reaberto na hora. Retorna quantos PIDs tiveram o primeiro arquivo da
+ * máscara lido, ou -1 em erro do anel.
+ */
+int proc_lote_ler(proc_lote_t *l);
+
+/*
+ * Lê só os alvos [inicio, fim) com pread, qualquer que seja o modo. Pode ser
+ * chamada por várias threads ao mesmo tempo desde que as faixas não se
+ * sobreponham (o contador de descritores é atômico); proc_lote_definir não.
+ */
+void proc_lote_ler_faixa(proc_lote_t *l, size_t inicio, size_t fim);
+
+/* Conteúdo ('\0' no fim) do arquivo 'arq' do i-ésimo alvo no último tick, ou NULL */
+const char *proc_lote_conteudo(const proc_lote_t *l, size_t i, proc_arquivo_t arq);
+
+/*
+ * Modo usado pelos módulos que criam lotes (opção global --leitura).
+ * "pread" (padrão) ou "uring". O /proc não tem leitura não bloqueante, então
+ * o io_uring executa cada read em um worker do kernel: medir com 'make bench'
+ * antes de trocar. Retorna -1 (com mensagem) para nome desconhecido.
+ */
+int         proc_lote_selecionar(const char *nome);
+lote_modo_t proc_lote_padrao(void);
+
+const char *proc_lote_modo_nome(lote_modo_t modo);
+
+#endif /* PROC_BATCH_H */
@@ -0,0 +1,61 @@
+#ifndef PROC_CACHE_H
+#define PROC_CACHE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/* ==================== ARQUIVOS MANTIDOS ABERTOS ==================== */
+
+/* Arquivos por processo (/proc/<pid>/...) */
+typedef enum {
+    PROC_ARQ_STAT = 0,      // /proc/<pid>/stat
+    PROC_ARQ_STATUS,        // /proc/<pid>/status
+    PROC_ARQ_IO,            // /proc/<pid>/io
+    PROC_ARQ_POR_PID        // quantidade de arquivos por PID
+} proc_arquivo_t;
+
+/* Arquivos globais do sistema */
+typedef enum {
+    PROC_SIS_STAT = 0,      // /proc/stat
+    PROC_SIS_MEMINFO,       // /proc/meminfo
+    PROC_SIS_PSI_CPU,       // /proc/pressure/cpu
+    PROC_SIS_PSI_MEMORIA,   // /proc/pressure/memory
+    PROC_SIS_PSI_IO,        // /proc/pressure/io
+    PROC_SIS_TOTAL
+} proc_arquivo_sistema_t;
+
+/* ==================== API DO CACHE DE DESCRITORES ==================== */
+
+/**
+ * Lê /proc/<pid>/<arquivo> com pread(fd, buf, n, 0) sobre um descritor
+ * mantido aberto entre as amostras.
+ *
+ * Retorna um buffer interno terminado em '\0' (válido até a próxima leitura
+ * do mesmo arquivo/PID) ou NULL em caso de erro, com errno preservado.
+ * Se o processo deixou de existir (ESRCH/ENOENT), a entrada do PID é
+ * invalidada automaticamente.
+ *
+ * Não é thread-safe: deve ser usado por uma única thread de coleta.
+ */
+const char *proc_cache_ler_pid(pid_t pid, proc_arquivo_t arq, size_t *tamanho);
+
+/* Mesmo comportamento de proc_cache_ler_pid para os arquivos globais (/proc/stat, /proc/meminfo, PSI) */
+const char *proc_cache_ler_sistema(proc_arquivo_sistema_t arq, size_t *tamanho);
+
+/* Fecha os descritores de um PID (ex.: processo terminou) */
+void proc_cache_invalidar(pid_t pid);
+
+/* Fecha todos os descritores e libera os buffers */
+void proc_cache_limpar(void);
+
+/* ==================== LEITURA AVULSA ==================== */
+
+/**
+ * Leitura sem cache (open/read/close) para varreduras de muitos PIDs,
+ * onde manter descritores abertos esgotaria o limite de arquivos.
+ * 'caminho' é relativo a dirfd (ex.: dirfd de /proc e "1234/stat").
+ * Retorna bytes lidos (buf terminado em '\0') ou -1 com errno preservado.
+ */
+long proc_ler_arquivo(int dirfd, const char *caminho, char *buf, size_t cap);
+
+#endif /* PROC_CACHE_H */
@@ -0,0 +1,51 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+/* ==================== EVENTOS DO PROC CONNECTOR ==================== */
+
+typedef enum {
+    EVENTO_FORK = 1,    // pid = filho, ppid = pai
+    EVENTO_EXEC,        // pid trocou de imagem (comm novo)
+    EVENTO_EXIT         // pid terminou (codigo_saida no formato de wait())
+} evento_tipo_t;
+
+/* Só eventos de processo: criação/saída de threads são descartadas na leitura */
+typedef struct {
+    evento_tipo_t tipo;
+    pid_t         pid;
+    pid_t         ppid;
+    int           codigo_saida;
+} evento_proc_t;
+
+/*
+ * Abre o socket NETLINK_CONNECTOR, entra no grupo CN_IDX_PROC e liga o envio
+ * de eventos (PROC_CN_MCAST_LISTEN). Requer CAP_NET_ADMIN.
+ * Retorna o descritor (não bloqueante) ou -1.
+ */
+int  eventos_abrir(void);
+void eventos_fechar(int fd);
+
+/*
+ * Lê os eventos pendentes sem bloquear (até 'max').
+ * Retorna quantos foram lidos, 0 se não há nada, ou -1 em erro. Se o kernel
+ * descartou mensagens (buffer cheio), '*perdidos' é incrementado.
+ */
+int eventos_ler(int fd, evento_proc_t *eventos, int max, unsigned long *perdidos);
+
+/* ==================== MONITORAMENTO GUIADO POR EVENTOS ==================== */
+
+/*
+ * Acompanha um conjunto de processos sem varrer /proc:
+ *  - raiz > 0: a raiz e todo processo criado (fork) por um membro;
+ *  - nome != NULL: todo processo que fizer exec com esse comm
+ *    (os já existentes são encontrados em uma varredura inicial).
+ * Uma linha CSV por membro vivo a cada tick; membros que terminam têm os
+ * totais finais capturados no evento de saída e resumidos ao final.
+ */
+int eventos_monitorar_csv(pid_t raiz, const char *nome, int intervalo_ms, int amostras,
+                          FILE *saida);
+
+#endif /* PROC_EVENTS_H */
@@ -0,0 +1,78 @@
+#ifndef PROC_PARSER_H
+#define PROC_PARSER_H
+
+#include <stddef.h>
+
+/* ==================== CAMPOS DE /proc/<pid>/stat ==================== */
+
+/* Numeração igual à de proc(5): o campo 1 é o pid, o 2 é o comm */
+enum {
+    PSTAT_PID         = 1,
+    PSTAT_COMM        = 2,
+    PSTAT_STATE       = 3,
+    PSTAT_PPID        = 4,
+    PSTAT_PGRP        = 5,
+    PSTAT_SESSION     = 6,
+    PSTAT_TTY_NR      = 7,
+    PSTAT_TPGID       = 8,
+    PSTAT_FLAGS       = 9,
+    PSTAT_MINFLT      = 10,
+    PSTAT_CMINFLT     = 11,
+    PSTAT_MAJFLT      = 12,
+    PSTAT_CMAJFLT     = 13,
+    PSTAT_UTIME       = 14,
+    PSTAT_STIME       = 15,
+    PSTAT_CUTIME      = 16,
+    PSTAT_CSTIME      = 17,
+    PSTAT_PRIORITY    = 18,
+    PSTAT_NICE        = 19,
+    PSTAT_NUM_THREADS = 20,
+    PSTAT_STARTTIME   = 22,
+    PSTAT_VSIZE       = 23,
+    PSTAT_RSS         = 24,
+    PSTAT_PROCESSOR   = 39,
+    PSTAT_MAX_CAMPOS  = 52
+};
+
+/* Máscara de campos pedidos/preenchidos */
+#define PSTAT_BIT(campo) (1ULL << (campo))
+
+/*
+ * Resultado do tokenizador. Campos numéricos ficam em campos[numero];
+ * valores negativos (priority, nice...) são guardados em complemento de
+ * dois: use (long long)campos[i] para lê-los com sinal.
+ */
+typedef struct {
+    char               comm[32];
+    char               estado;
+    unsigned long long campos[PSTAT_MAX_CAMPOS + 1];
+    unsigned long long preenchidos;   // PSTAT_BIT de cada campo encontrado
+} proc_stat_campos_t;
+
+/* ==================== API DO TOKENIZADOR ==================== */
+
+/**
+ * Interpreta /proc/<pid>/stat (ou /proc/<pid>/task/<tid>/stat) em uma única
+ * passada, sem alocação e sem estado global (reentrante).
+ *
+ * O comm vai do primeiro '(' ao ÚLTIMO ')', então nomes com espaços ou ')'
+ * não deslocam os campos. A varredura para no maior campo pedido em
+ * 'pedidos' (máscara de PSTAT_BIT). Somente os campos pedidos são gravados;
+ * comm e estado são sempre preenchidos.
+ *
+ * Retorna 0 se todos os campos pedidos foram encontrados, -1 caso contrário.
+ */
+int proc_stat_interpretar(const char *buf, unsigned long long pedidos, proc_stat_campos_t *out);
+
+/**
+ * Interpreta uma linha "cpu"/"cpuN" de /proc/stat.
+ * Grava até 'max' contadores em 'valores' e, se 'indice_core' não for NULL,
+ * o N da linha (-1 para a linha agregada "cpu").
+ * Retorna quantos contadores foram lidos, ou -1 se a linha não é de CPU.
+ */
+int proc_stat_linha_cpu(const char *linha, unsigned long long *valores, int max, int *indice_core);
+
+/* Avança para o início da próxima linha (ou NULL no fim do texto) */
+const char *proc_proxima_linha(const char *linha);
+
+#endif /* PROC_PARSER_H */
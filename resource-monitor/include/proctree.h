@@ -0,0 +1,101 @@
+#ifndef PROCTREE_H
+#define PROCTREE_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <dirent.h>
+
+/* ==================== ESTRUTURAS DE DADOS ==================== */
+
+/* Estado de membro de um processo em relação à raiz da árvore */
+typedef enum {
+    ARVORE_INDEFINIDO = 0,
+    ARVORE_MEMBRO,
+    ARVORE_FORA
+} arvore_membro_t;
+
+/*
+ * Um processo conhecido. A tabela é indexada só pelo pid (o pai é procurado
+ * pelo ppid). A identidade é (pid, starttime), como no scanner: um PID
+ * reciclado tem outro starttime. O inode de /proc/<pid> não é estável (o
+ * dentry pode ser recriado), então só decide se um não membro, que não é
+ * relido a cada varredura, precisa ser relido para conferir o starttime.
+ */
+typedef struct arvore_proc {
+    pid_t              pid;
+    pid_t              ppid;
+    unsigned long long starttime;       // campo 22 de stat: identidade junto com o pid
+    ino_t              ino;             // d_ino de /proc/<pid> quando foi lido (só uma dica)
+    char               comm[32];
+
+    /*
+     * utime+stime+cutime+cstime: quando um membro recolhe (wait) um filho, o
+     * tempo do filho migra para cutime/cstime do pai, então a soma sobre a
+     * árvore não perde processos que nasceram e morreram dentro do intervalo.
+     */
+    unsigned long long cpu_ticks;
+    unsigned long long rss_kb;
+    unsigned long long read_bytes;      // rchar (inclui filhos recolhidos, como cutime)
+    unsigned long long write_bytes;     // wchar
+
+    arvore_membro_t    membro;
+    int                era_membro;      // membro na varredura anterior
+    int                lido;            // stat relido nesta varredura
+    unsigned long      geracao;
+    struct arvore_proc *prox;
+} arvore_proc_t;
+
+/* Somatórios da árvore em uma varredura */
+typedef struct {
+    size_t             processos;
+    unsigned long long cpu_ticks;
+    unsigned long long rss_kb;
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+} arvore_totais_t;
+
+typedef struct {
+    pid_t              raiz;
+    arvore_proc_t    **baldes;
+    size_t             num_baldes;      // potência de 2
+    size_t             num_procs;
+    unsigned long      geracao;
+    DIR               *dir;             // /proc mantido aberto
+
+    /* resultado da última varredura */
+    arvore_totais_t    totais;
+    size_t             novos;           // membros que entraram
+    size_t             encerrados;      // membros que saíram
+    size_t             leituras;        // arquivos stat lidos (custo da varredura)
+} arvore_t;
+
+/* Métricas de um intervalo entre duas varreduras */
+typedef struct {
+    double cpu_percent;                 // % da capacidade total da máquina
+    double read_bps;
+    double write_bps;
+} arvore_taxas_t;
+
+/* ==================== API DA ÁRVORE DE PROCESSOS ==================== */
+
+/* Inicializa/destrói o acompanhamento da árvore com raiz em 'raiz' */
+int  arvore_iniciar(arvore_t *arv, pid_t raiz);
+void arvore_destruir(arvore_t *arv);
+
+/*
+ * Atualiza a árvore de forma incremental: /proc é listado a cada chamada,
+ * mas stat/io só são relidos para membros da árvore e para PIDs novos,
+ * reciclados ou órfãos (pai sumiu). Preenche arv->totais.
+ * Retorna o número de membros vivos, 0 se a raiz terminou, ou -1 em erro.
+ */
+int arvore_varrer(arvore_t *arv);
+
+/* Calcula CPU% e taxas de I/O entre dois totais (delta de ticks do sistema e tempo em ns) */
+void arvore_calcular_taxas(const arvore_totais_t *antes, const arvore_totais_t *depois,
+                           unsigned long long delta_sys, long long decorrido_ns,
+                           arvore_taxas_t *out);
+
+/* Loop de monitoramento: uma linha CSV por tick com a soma da raiz e descendentes vivos */
+int arvore_monitorar_csv(pid_t raiz, int intervalo_ms, int amostras, FILE *saida);
+
+#endif /* PROCTREE_H */
@@ -0,0 +1,100 @@
+#ifndef PSI_H
+#define PSI_H
+
+#include <stdio.h>
+
+/* ==================== PRESSURE STALL INFORMATION ==================== */
+
+/*
+ * Tempo em que tarefas ficaram paradas esperando CPU, memória (reclaim,
+ * swap-in, thrashing) ou I/O: /proc/pressure/{cpu,memory,io} para a máquina
+ * e <recurso>.pressure em cada cgroup v2. Ao contrário de CPU% ou de bytes
+ * lidos, mede saturação diretamente: 100% de CPU com some = 0 é só uso;
+ * some = 30% é trabalho atrasado.
+ *
+ *   some  ao menos uma tarefa parada (perda de latência)
+ *   full  todas as tarefas não ociosas paradas ao mesmo tempo (perda de vazão)
+ *
+ * Os avgN são médias móveis do kernel (% do tempo); total é o acumulado em
+ * µs, de onde saem taxas exatas para qualquer intervalo.
+ */
+typedef enum {
+    PSI_CPU = 0,
+    PSI_MEMORIA,
+    PSI_IO,
+    PSI_NUM_RECURSOS
+} psi_recurso_t;
+
+typedef struct {
+    double             avg10;
+    double             avg60;
+    double             avg300;
+    unsigned long long total_us;
+} psi_linha_t;
+
+typedef struct {
+    psi_linha_t some;
+    psi_linha_t full;
+    int         tem_full;  // cpu sem a linha full (kernels < 5.13 na raiz)
+} psi_t;
+
+/* "cpu", "memory", "io" (nomes dos arquivos do kernel) */
+const char *psi_nome_recurso(psi_recurso_t r);
+
+/* Interpreta o conteúdo já lido de um arquivo de pressão (0 ou -1) */
+int psi_interpretar(const char *conteudo, psi_t *out);
+
+/* /proc/pressure/<recurso> (-1 se o kernel não tem PSI ou psi=0 no boot) */
+int psi_ler_sistema(psi_recurso_t r, psi_t *out);
+
+/* <cgroup>/<recurso>.pressure ("" = raiz). Em hierarquia híbrida (v1 +
+ * /sys/fs/cgroup/unified), o cgroup é procurado na árvore unified */
+int psi_ler_cgroup(const char *cgroup, psi_recurso_t r, psi_t *out);
+
+/* ==================== GATILHOS (POLLPRI) ==================== */
+
+/*
+ * Um gatilho pede ao kernel para acordar o poll() quando o tempo parado
+ * passar de 'limite' dentro de uma janela deslizante: o monitor dorme até
+ * haver saturação em vez de amostrar às cegas. O kernel notifica no máximo
+ * uma vez por janela.
+ *
+ *   <recurso> <some|full> <limite> <janela> [cgroup]
+ *   ex.: "memory some 150ms 2s", "io full 100ms 2s system.slice/db.service"
+ *
+ * Janela entre 500ms e 10s. Sem CAP_SYS_RESOURCE, o kernel só aceita
+ * janelas múltiplas de 2s.
+ */
+#define PSI_JANELA_MIN_US  500000U
+#define PSI_JANELA_MAX_US  10000000U
+#define PSI_CGROUP_MAX     256
+
+typedef struct {
+    psi_recurso_t recurso;
+    int           full;
+    unsigned      limite_us;
+    unsigned      janela_us;
+    char          cgroup[PSI_CGROUP_MAX];  // "" = máquina inteira (/proc/pressure)
+    int           de_cgroup;
+} psi_gatilho_t;
+
+/* Interpreta a especificação acima (0 ou -1 com mensagem em stderr) */
+int psi_gatilho_interpretar(const char *texto, psi_gatilho_t *g);
+
+/* Registra o gatilho; devolve o fd para poll() com POLLPRI (-1 com mensagem).
+ * POLLERR no fd: o cgroup foi removido e o gatilho não dispara mais */
+int psi_gatilho_abrir(const psi_gatilho_t *g);
+
+/* Lê a pressão atual do recurso/cgroup do gatilho */
+int psi_gatilho_ler(const psi_gatilho_t *g, psi_t *out);
+
+/* Texto curto para logs: "memory some 150ms/2000ms [cgroup]" */
+void psi_gatilho_descrever(const psi_gatilho_t *g, char *buf, size_t tam);
+
+/* Loop CSV: avg10 e tempo parado por segundo (some/full) dos três recursos */
+int psi_monitorar_csv(const char *cgroup, int intervalo_ms, int amostras, FILE *saida);
+
+/* Dorme até os gatilhos dispararem: uma linha CSV por evento (até 'eventos') */
+int psi_vigiar_csv(const psi_gatilho_t *gatilhos, int num, int eventos, FILE *saida);
+
+#endif /* PSI_H */
@@ -0,0 +1,48 @@
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* ==================== PERCENTIS EM FLUXO (HISTOGRAMA LOG-LINEAR) ==================== */
+
+/*
+ * Estimador de percentis com memória fixa, no estilo HDR: cada potência de 2
+ * é dividida em QUANTIL_SUB baldes iguais, então o erro relativo de qualquer
+ * percentil fica abaixo de 1/(2*QUANTIL_SUB) (~0,8%) em toda a faixa. Mínimo,
+ * máximo, soma e contagem são exatos. Dois estimadores se combinam somando os
+ * baldes (quantil_mesclar): cada thread ou alvo usa o seu e o resumo é mesclado.
+ */
+#define QUANTIL_SUB       64      // baldes por potência de 2
+#define QUANTIL_EXP_MIN   (-10)   // valores abaixo de 2^-10 (~0,001) contam como zero
+#define QUANTIL_EXP_MAX   54      // acima de 2^54 vão para o último balde
+#define QUANTIL_BALDES    ((QUANTIL_EXP_MAX - QUANTIL_EXP_MIN) * QUANTIL_SUB)
+
+typedef struct {
+    uint32_t           *baldes;     // QUANTIL_BALDES contadores
+    unsigned long long  zeros;      // valores <= 0 ou abaixo da faixa
+    unsigned long long  contagem;
+    double              min;
+    double              max;
+    double              soma;
+} quantil_t;
+
+int  quantil_iniciar(quantil_t *q);
+void quantil_liberar(quantil_t *q);
+void quantil_zerar(quantil_t *q);
+
+/* Conta uma amostra (NaN é ignorado) */
+void quantil_registrar(quantil_t *q, double valor);
+
+/* Acrescenta em 'dest' todas as amostras de 'orig' */
+int quantil_mesclar(quantil_t *dest, const quantil_t *orig);
+
+/* Valor estimado do percentil p (0..1); p <= 0 e p >= 1 devolvem min e max exatos. 0 sem amostras */
+double quantil_valor(const quantil_t *q, double p);
+
+double quantil_media(const quantil_t *q);
+
+/* Linha "rotulo: mín | p50 | p90 | p99 | máx unidade"; nada se não há amostras */
+void quantil_imprimir(FILE *out, const quantil_t *q, const char *rotulo, const char *unidade);
+
+#endif /* QUANTILE_H */
@@ -0,0 +1,92 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* ==================== FORMATO BINÁRIO COLUNAR ==================== */
+
+/*
+ * Arquivo:  "RMB1" | versão | descrição | esquema (nome, tipo, codificação e
+ *           casas decimais de cada coluna) | blocos até o fim do arquivo.
+ * Bloco:    0xB1 | nº de linhas | para cada coluna: nº de bytes + dados.
+ *
+ * Cada bloco guarda até GRAVACAO_LINHAS_BLOCO linhas e recomeça o estado dos
+ * codificadores, então um arquivo truncado perde só o último bloco.
+ * Inteiros usam varint (LEB128) com zigzag.
+ */
+#define GRAVACAO_LINHAS_BLOCO 4096
+#define GRAVACAO_NOME_MAX     32
+
+typedef enum {
+    GRAV_TEMPO = 1,     // ns desde a época (CLOCK_REALTIME); vira data/hora no CSV
+    GRAV_INT,           // inteiro com sinal de 64 bits
+    GRAV_FLOAT          // double
+} gravacao_tipo_t;
+
+typedef enum {
+    GRAV_DELTA = 1,     // diferença para a linha anterior (contadores, PIDs ordenados)
+    GRAV_DELTA2,        // delta-of-delta (timestamps e sequências a passo fixo)
+    GRAV_XOR            // XOR com o double anterior, estilo Gorilla (percentuais, taxas)
+} gravacao_codec_t;
+
+typedef struct {
+    char             nome[GRAVACAO_NOME_MAX];
+    gravacao_tipo_t  tipo;
+    gravacao_codec_t codec;
+    int              casas;     // casas decimais de GRAV_FLOAT na conversão para CSV
+} gravacao_coluna_t;
+
+typedef union {
+    long long i;
+    double    f;
+} gravacao_valor_t;
+
+/* ==================== ESCRITA ==================== */
+
+typedef struct {
+    FILE              *arq;
+    size_t             num_colunas;
+    gravacao_coluna_t *colunas;
+    gravacao_valor_t  *valores;     // [coluna * GRAVACAO_LINHAS_BLOCO + linha]
+    size_t             linhas;      // linhas no bloco atual
+    unsigned char     *buf;         // codificação de uma coluna
+    size_t             cap_buf;
+    unsigned long long total_linhas;
+    unsigned long long total_bytes;
+} gravador_t;
+
+/* Grava cabeçalho e esquema. 'descricao' é livre (ex.: "all pid=123 intervalo=1000ms") */
+int gravador_abrir(gravador_t *g, FILE *arq, const char *descricao,
+                   const gravacao_coluna_t *colunas, size_t num_colunas);
+
+/* Acrescenta uma linha (num_colunas valores); grava o bloco quando enche */
+int gravador_linha(gravador_t *g, const gravacao_valor_t *linha);
+
+/* Grava o bloco parcial e libera o gravador (não fecha o FILE) */
+int gravador_fechar(gravador_t *g);
+
+/* ==================== LEITURA ==================== */
+
+typedef struct {
+    FILE              *arq;
+    char               descricao[256];
+    size_t             num_colunas;
+    gravacao_coluna_t *colunas;
+    gravacao_valor_t  *valores;     // bloco decodificado
+    size_t             linhas;
+    size_t             proxima;
+    unsigned char     *buf;
+    size_t             cap_buf;
+} leitor_gravacao_t;
+
+int  leitor_abrir(leitor_gravacao_t *l, FILE *arq);
+void leitor_fechar(leitor_gravacao_t *l);
+
+/* Copia a próxima linha para 'linha'. Retorna 1, 0 no fim do arquivo ou -1 se corrompido */
+int leitor_proxima(leitor_gravacao_t *l, gravacao_valor_t *linha);
+
+/* Converte uma gravação inteira em CSV (ou JSON Lines, conforme --formato) */
+int gravacao_converter_csv(FILE *entrada, FILE *saida);
+
+#endif /* RECORDING_H */
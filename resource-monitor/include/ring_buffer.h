@@ -0,0 +1,69 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/* ==================== FILA SPSC SEM TRAVA ==================== */
+
+/*
+ * Anel de registros de tamanho fixo com um único produtor e um único
+ * consumidor. Cabeça e cauda ficam em linhas de cache separadas; o produtor
+ * nunca espera: com o anel cheio o registro é descartado e contado.
+ */
+typedef struct {
+    unsigned long long cauda;           // próxima posição escrita (só o produtor altera)
+    char               pad_cauda[56];
+    unsigned long long cabeca;          // próxima posição lida (só o consumidor altera)
+    char               pad_cabeca[56];
+    unsigned long      descartados;     // registros perdidos com o anel cheio
+    size_t             capacidade;      // potência de 2
+    size_t             tam_registro;
+    unsigned char     *dados;
+} fila_spsc_t;
+
+/* capacidade é arredondada para a próxima potência de 2 */
+int  fila_iniciar(fila_spsc_t *f, size_t capacidade, size_t tam_registro);
+void fila_destruir(fila_spsc_t *f);
+
+/* Produtor: copia o registro para o anel. Retorna 0, ou -1 se estava cheio (descartado) */
+int fila_publicar(fila_spsc_t *f, const void *registro);
+
+/* Consumidor: copia o registro mais antigo para 'destino'. Retorna 1, ou 0 se vazio */
+int fila_consumir(fila_spsc_t *f, void *destino);
+
+/* ==================== ESCRITOR EM THREAD PRÓPRIA ==================== */
+
+/* Registros em trânsito por escritor: ~minutos de folga a 10 Hz antes de descartar */
+#define ESCRITOR_CAPACIDADE_PADRAO 4096
+
+/* Formata um registro na saída (roda na thread do escritor) */
+typedef void (*escritor_formatar_t)(FILE *saida, const void *registro, void *ctx);
+
+typedef struct {
+    fila_spsc_t         fila;
+    pthread_t           thread;
+    sem_t               sinal;          // um post por registro publicado (ou no encerramento)
+    FILE               *saida;
+    escritor_formatar_t formatar;
+    void               *ctx;
+    int                 encerrar;
+} escritor_t;
+
+/*
+ * Inicia a thread que esvazia a fila, formata cada registro em 'saida' e dá
+ * fflush ao esvaziar. A thread de amostragem só faz escritor_enviar, então
+ * um disco lento ou um pipe cheio não atrasa a próxima amostra.
+ */
+int escritor_iniciar(escritor_t *e, FILE *saida, size_t tam_registro, size_t capacidade,
+                     escritor_formatar_t formatar, void *ctx);
+
+/* Publica sem bloquear. Retorna -1 se o registro foi descartado (fila cheia) */
+int escritor_enviar(escritor_t *e, const void *registro);
+
+/* Escreve o que restou na fila, encerra a thread e retorna o total de descartados */
+unsigned long escritor_encerrar(escritor_t *e);
+
+#endif /* RING_BUFFER_H */
@@ -0,0 +1,57 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "monitor.h"
+#include "alerts.h"
+
+/* ==================== SNAPSHOT POR AMOSTRA ==================== */
+
+/*
+ * Fotografia de um tick: cada arquivo do /proc é lido UMA vez e o mesmo
+ * conteúdo alimenta os três módulos (CPU, memória e I/O).
+ *
+ * Arquivos lidos por tick: /proc/stat, /proc/meminfo, /proc/<pid>/stat,
+ * /proc/<pid>/status e /proc/<pid>/io.
+ */
+typedef struct {
+    pid_t            pid;
+    long long        mono_ns;         // instante da coleta (CLOCK_MONOTONIC): intervalos das taxas
+    long long        real_ns;         // mesmo instante em CLOCK_REALTIME: coluna timestamp
+    cpu_times_t      cpu_sistema;
+    proc_cpu_t       cpu_processo;
+    mem_proc_stats_t mem_processo;
+    mem_sys_stats_t  mem_sistema;
+    io_stats_t       io_processo;
+    int              io_disponivel;   // 0 se /proc/<pid>/io não pôde ser lido (permissão)
+} sampler_snapshot_t;
+
+/* Métricas derivadas de dois snapshots consecutivos */
+typedef struct {
+    double     cpu_processo_percent;
+    double     cpu_sistema_percent;
+    double     mem_processo_percent;
+    io_stats_t io_taxas;
+} sampler_metricas_t;
+
+/* ==================== API DO AMOSTRADOR UNIFICADO ==================== */
+
+/* Coleta um snapshot completo do PID (retorna -1 se o processo não pôde ser lido) */
+int sampler_coletar(pid_t pid, sampler_snapshot_t *out);
+
+/* Calcula CPU%, memória% e taxas de I/O (sobre o tempo medido) entre dois snapshots */
+int sampler_calcular(const sampler_snapshot_t *antes, const sampler_snapshot_t *depois,
+                     sampler_metricas_t *out);
+
+/* Entrega as colunas do CSV (taxas de I/O por segundo) ao motor de alertas */
+void sampler_observar_alertas(alertas_t *al, const sampler_snapshot_t *s, const sampler_metricas_t *m);
+
+/* Loop de monitoramento que grava uma linha CSV alinhada (CPU + memória + I/O) por tick */
+int sampler_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida);
+
+/* Mesmas colunas do CSV, no formato binário colunar de recording.h */
+int sampler_gravar_pid(pid_t pid, int intervalo_ms, int amostras, FILE *arq);
+
+#endif /* SAMPLER_H */
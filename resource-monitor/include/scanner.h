@@ -0,0 +1,132 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <dirent.h>
+
+#include "proc_batch.h"
+#include "worker_pool.h"
+
+/* ==================== ESTRUTURAS DE DADOS ==================== */
+
+/* Métrica usada para ordenar o top-N */
+typedef enum {
+    SCANNER_ORDEM_CPU = 0,     // % de CPU no intervalo
+    SCANNER_ORDEM_RSS,         // memória residente (kB)
+    SCANNER_ORDEM_IO,          // leitura + escrita (bytes/s)
+    SCANNER_ORDEM_READ,        // leitura (bytes/s)
+    SCANNER_ORDEM_WRITE        // escrita (bytes/s)
+} scanner_ordem_t;
+
+/*
+ * Estado de um processo (ou thread, no modo threads) na varredura. A
+ * identidade é o par (pid, starttime): um PID/TID reciclado tem outro
+ * starttime e vira uma entrada nova, sem herdar os contadores anteriores.
+ */
+typedef struct scanner_proc {
+    pid_t              pid;
+    pid_t              ppid;
+    unsigned long long starttime;        // campo 22 de /proc/<pid>/stat (ticks desde o boot)
+    char               comm[32];
+    char               estado;           // R, S, D, Z...
+
+    /* contadores absolutos da última leitura */
+    unsigned long long utime;
+    unsigned long long stime;
+    unsigned long long cpu_ticks;        // utime + stime
+    unsigned long long rss_kb;
+    unsigned long long read_bytes;       // rchar
+    unsigned long long write_bytes;      // wchar
+    int                io_disponivel;
+
+    /* métricas do último intervalo */
+    double             cpu_percent;
+    double             cpu_user_percent; // parcela de utime
+    double             cpu_sys_percent;  // parcela de stime
+    double             read_bps;
+    double             write_bps;
+    int                tem_anterior;     // já existe delta calculado
+
+    unsigned long      geracao;          // última varredura em que foi visto
+    struct scanner_proc *prox;           // encadeamento na tabela hash
+} scanner_proc_t;
+
+/* Tabela de processos conhecidos entre varreduras */
+typedef struct {
+    scanner_proc_t   **baldes;
+    size_t             num_baldes;       // potência de 2
+    size_t             num_procs;
+    unsigned long      geracao;
+    unsigned long long sys_total_antes;  // total de /proc/stat na varredura anterior
+    long long          mono_ns_antes;    // instante da varredura anterior (CLOCK_MONOTONIC)
+    long long          real_ns;          // instante da última varredura (CLOCK_REALTIME)
+    double             intervalo_s;      // tempo real medido entre as duas últimas varreduras
+    DIR               *dir;              // /proc (ou /proc/<pid>/task) mantido aberto
+    pid_t              pid_alvo;         // > 0 no modo threads: entradas são TIDs desse PID
+    proc_lote_t        lote;             // stat+io de todos os PIDs, lidos em lote a cada varredura
+    pid_t             *pids;             // PIDs listados pelo readdir da varredura atual
+    size_t             cap_pids;
+    scanner_proc_t    *lidos;            // snapshot do tick: lidos[k] = alvo k do lote (pid 0 = falhou)
+    pool_t             pool;             // workers que leem e interpretam shards de PIDs
+} scanner_t;
+
+/* ==================== API DO SCANNER DE SISTEMA ==================== */
+
+/*
+ * Workers da varredura do sistema (opção global --workers). 0 = um por CPU
+ * permitida; 1 = tudo na thread principal. Vale para os scanners criados
+ * depois da chamada; o modo threads sempre usa 1.
+ */
+void scanner_definir_workers(int num_workers);
+
+/* Inicializa/destrói a tabela */
+int  scanner_iniciar(scanner_t *sc);
+void scanner_destruir(scanner_t *sc);
+
+/*
+ * Inicializa a tabela para varrer /proc/<pid>/task: cada entrada é uma
+ * thread do processo (pid = TID, comm = nome da thread). Threads que
+ * surgem ou terminam entre varreduras entram e saem da tabela como
+ * processos no modo sistema.
+ */
+int scanner_iniciar_threads(scanner_t *sc, pid_t pid);
+
+/*
+ * Percorre /proc (ou /proc/<pid>/task) uma vez, atualiza a tabela e calcula CPU%, RSS e taxas de
+ * I/O de todos os processos. Processos que sumiram são removidos.
+ * Retorna a quantidade de processos vivos ou -1 em erro.
+ */
+int scanner_varrer(scanner_t *sc);
+
+/*
+ * Seleciona os N processos com maior valor da métrica na última varredura.
+ * 'saida' deve ter espaço para n ponteiros; retorna quantos foram preenchidos.
+ */
+size_t scanner_top(const scanner_t *sc, scanner_ordem_t ordem,
+                   scanner_proc_t **saida, size_t n);
+
+/* Busca um processo vivo pela identidade (pid, starttime); NULL se não existir */
+scanner_proc_t *scanner_buscar(const scanner_t *sc, pid_t pid, unsigned long long starttime);
+
+/* Converte "cpu", "rss", "io", "read", "write" para a enumeração (-1 se inválido) */
+int scanner_ordem_de_texto(const char *texto, scanner_ordem_t *ordem);
+
+/* Loop "top": varre a cada intervalo e grava em CSV os top-N de cada iteração */
+int scanner_monitorar_top_csv(int intervalo_ms, int iteracoes, size_t top_n,
+                              scanner_ordem_t ordem, FILE *saida);
+
+/*
+ * Loop "record top": varre a cada intervalo e grava TODOS os processos vivos
+ * (uma linha por processo, em ordem de PID) no formato binário de recording.h
+ */
+int scanner_gravar_top(int intervalo_ms, int iteracoes, FILE *arq);
+
+/*
+ * Loop "threads": varre /proc/<pid>/task a cada intervalo e grava em CSV as
+ * N threads mais quentes. Termina sem erro quando o processo encerra.
+ */
+int scanner_monitorar_threads_csv(pid_t pid, int intervalo_ms, int iteracoes, size_t top_n,
+                                  scanner_ordem_t ordem, FILE *saida);
+
+#endif /* SCANNER_H */
@@ -0,0 +1,45 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* ==================== AGENDADOR DE AMOSTRAGEM ==================== */
+
+/*
+ * Agendador com prazos ABSOLUTOS sobre CLOCK_MONOTONIC: o prazo k é sempre
+ * inicio + k * periodo, então o tempo gasto lendo o /proc não se acumula
+ * como deriva entre as amostras.
+ */
+typedef struct {
+    long long     inicio_ns;         // instante de referência (CLOCK_MONOTONIC)
+    long long     periodo_ns;
+    long long     proximo_ns;        // próximo prazo absoluto
+    unsigned long ticks;             // prazos já atendidos (no horário ou atrasados)
+    unsigned long prazos_perdidos;   // prazos em que a coleta começou atrasada ou foi pulada
+} agendador_t;
+
+/* Instante atual em nanossegundos (CLOCK_MONOTONIC) */
+long long agendador_agora_ns(void);
+
+/* Define a grade de prazos a partir de agora */
+void agendador_iniciar(agendador_t *ag, int intervalo_ms);
+
+/*
+ * Dorme (clock_nanosleep + TIMER_ABSTIME) até o próximo prazo e retorna o
+ * instante monotônico ao acordar. Se o prazo já passou, não dorme: conta o
+ * atraso em prazos_perdidos e, se passou mais de um período inteiro, pula
+ * para o prazo mais recente da grade em vez de disparar uma rajada de coletas.
+ */
+long long agendador_esperar(agendador_t *ag);
+
+/*
+ * Nanossegundos até o próximo prazo (<= 0 se já venceu). Para loops que
+ * atendem outro descritor (poll) enquanto esperam o tick.
+ */
+long long agendador_restante_ns(const agendador_t *ag);
+
+/* Pausa avulsa de 'ms' milissegundos (relatórios e formação de delta) */
+void agendador_dormir_ms(int ms);
+
+/* Mensagem de resumo em stderr quando houve prazos perdidos */
+void agendador_relatar(const agendador_t *ag, const char *rotulo);
+
+#endif /* SCHEDULER_H */
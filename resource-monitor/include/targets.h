@@ -0,0 +1,41 @@
+#ifndef TARGETS_H
+#define TARGETS_H
+
+#include <sys/types.h>
+
+/* ==================== REGISTRO DE ALVOS (pidfd) ==================== */
+
+/* Situação de um PID registrado */
+typedef enum {
+    ALVO_VIVO = 0,
+    ALVO_ENCERRADO,     // o processo original terminou
+    ALVO_RECICLADO,     // o PID agora pertence a outro processo
+    ALVO_DESCONHECIDO   // PID nunca registrado
+} alvo_estado_t;
+
+/*
+ * Registra um PID monitorado. Abre um pidfd (pidfd_open, Linux >= 5.3), que
+ * fica legível quando o processo termina e nunca passa a apontar para outro
+ * processo. Em kernels sem pidfd, a identidade é o starttime de
+ * /proc/<pid>/stat. Registrar de novo o mesmo PID não faz nada.
+ * Retorna 0, ou -1 se o processo não existe.
+ */
+int alvo_registrar(pid_t pid);
+
+/*
+ * Consulta sem bloquear se o alvo ainda é o mesmo processo. Os loops de
+ * amostragem chamam DEPOIS de ler o /proc: se o processo terminou (e o PID
+ * foi reaproveitado) durante a leitura, a amostra é descartada.
+ */
+alvo_estado_t alvo_estado(pid_t pid);
+
+/* Descritor pollable (POLLIN no término) ou -1 sem pidfd/não registrado */
+int alvo_fd(pid_t pid);
+
+/* Mensagem de fim de monitoramento em stderr (evento de saída ou reciclagem) */
+void alvo_relatar_fim(pid_t pid, alvo_estado_t estado, int amostra);
+
+/* Fecha o pidfd e esquece o PID */
+void alvo_remover(pid_t pid);
+
+#endif /* TARGETS_H */
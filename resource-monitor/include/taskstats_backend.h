@@ -0,0 +1,87 @@
+#ifndef TASKSTATS_BACKEND_H
+#define TASKSTATS_BACKEND_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "monitor.h"
+
+/* ==================== SELEÇÃO DE BACKEND ==================== */
+
+/* Origem dos dados de CPU/I/O por processo */
+typedef enum {
+    BACKEND_PROC = 0,      // texto de /proc/<pid>/stat e /proc/<pid>/io (padrão)
+    BACKEND_TASKSTATS      // mensagem binária do genetlink TASKSTATS
+} backend_t;
+
+/*
+ * Seleciona o backend pelo nome ("proc", "taskstats" ou "auto").
+ * "taskstats" e "auto" testam a família netlink; se não houver suporte
+ * (kernel sem CONFIG_TASKSTATS ou sem CAP_NET_ADMIN) o backend volta a
+ * ser /proc. Retorna -1 apenas para nome desconhecido.
+ */
+int backend_selecionar(const char *nome);
+
+/* Backend em uso e seu nome legível */
+backend_t   backend_atual(void);
+const char *backend_nome(backend_t b);
+
+/* ==================== TASKSTATS ==================== */
+
+/*
+ * Contadores de um processo (soma de todas as threads do TGID) em uma única
+ * mensagem. Os atrasos (delay accounting) só são preenchidos pelo kernel
+ * com kernel.task_delayacct=1 (ou delayacct na linha de boot).
+ */
+typedef struct {
+    /* CPU */
+    unsigned long long utime_us;
+    unsigned long long stime_us;
+    unsigned long long cpu_run_real_ns;     // tempo executando
+    unsigned long long cpu_delay_ns;        // tempo pronto esperando CPU (run queue)
+    unsigned long long cpu_count;
+
+    /* atrasos de I/O e memória */
+    unsigned long long blkio_delay_ns;      // esperando I/O de bloco síncrono
+    unsigned long long blkio_count;
+    unsigned long long swapin_delay_ns;     // esperando páginas voltarem do swap
+    unsigned long long swapin_count;
+
+    /* I/O (mesma semântica de /proc/<pid>/io) */
+    unsigned long long read_char;
+    unsigned long long write_char;
+    unsigned long long read_syscalls;
+    unsigned long long write_syscalls;
+    unsigned long long read_bytes;          // bytes que chegaram ao dispositivo
+    unsigned long long write_bytes;
+
+    /* memória */
+    unsigned long long minflt;
+    unsigned long long majflt;
+
+    /*
+     * Na consulta por TGID vários kernels somam só CPU e atrasos das threads;
+     * I/O e faults vêm zerados. Nesse caso io_disponivel = 0 e o módulo de
+     * I/O continua usando /proc/<pid>/io, que é agregado pelo processo.
+     */
+    int io_disponivel;
+} taskstats_info_t;
+
+/* Abre o socket genetlink e resolve a família TASKSTATS (0 ou -1) */
+int  taskstats_abrir(void);
+void taskstats_fechar(void);
+
+/* Consulta os contadores agregados do processo 'pid' (0 ou -1) */
+int taskstats_ler_pid(pid_t pid, taskstats_info_t *out);
+
+/* Conversões para as estruturas usadas pelos módulos de CPU e I/O */
+void taskstats_para_proc_cpu(const taskstats_info_t *ts, proc_cpu_t *out);
+void taskstats_para_io(const taskstats_info_t *ts, io_stats_t *out);
+
+/* Indica se o kernel está contabilizando atrasos (kernel.task_delayacct) */
+int taskstats_atrasos_ativos(void);
+
+/* Loop CSV com os atrasos por segundo (CPU, block I/O, swap-in) de um PID */
+int taskstats_monitorar_atrasos_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida);
+
+#endif /* TASKSTATS_BACKEND_H */
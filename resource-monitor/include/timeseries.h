@@ -0,0 +1,107 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/* ==================== HISTÓRICO EM MEMÓRIA (MULTIRRESOLUÇÃO) ==================== */
+
+/*
+ * Cada série (alvo + métrica) guarda as amostras recentes em três anéis de
+ * tamanho fixo: bruto (uma posição por amostra), 10 s e 1 min. Os níveis
+ * agregados mantêm min/max/soma/último do intervalo aberto e o fecham quando
+ * chega uma amostra do intervalo seguinte, então a memória por série não
+ * cresce com o tempo de execução.
+ */
+typedef enum {
+    HIST_BRUTO = 0,
+    HIST_10S,
+    HIST_1MIN,
+    HIST_NUM_NIVEIS
+} hist_nivel_t;
+
+/* Capacidade padrão de cada nível: 10 min a 1 Hz, 1 h e 24 h */
+#define HIST_CAP_BRUTO     600
+#define HIST_CAP_10S       360
+#define HIST_CAP_1MIN      1440
+#define HIST_SERIES_PADRAO 256
+#define HIST_METRICA_MAX   24
+
+typedef struct {
+    long long inicio_ns;    // CLOCK_REALTIME: instante da amostra ou início do intervalo
+    double    min;
+    double    max;
+    double    soma;
+    double    ultimo;
+    unsigned  contagem;     // amostras no intervalo (1 no nível bruto)
+} hist_ponto_t;
+
+typedef struct {
+    hist_ponto_t *pontos;
+    size_t        cap;
+    size_t        num;          // pontos fechados no anel (<= cap)
+    size_t        proximo;      // posição do próximo ponto fechado
+    long long     passo_ns;     // 0 = bruto
+    hist_ponto_t  aberto;       // intervalo em formação (níveis agregados)
+} hist_anel_t;
+
+typedef struct hist_serie {
+    pid_t              pid;
+    char               metrica[HIST_METRICA_MAX];
+    hist_anel_t        niveis[HIST_NUM_NIVEIS];
+    struct hist_serie *prox;
+} hist_serie_t;
+
+typedef struct {
+    hist_serie_t **baldes;
+    size_t         num_baldes;      // potência de 2
+    size_t         num_series;
+    size_t         max_series;      // limite de memória: novas séries acima disso são recusadas
+    unsigned long  recusadas;
+} historico_t;
+
+/* max_series = 0 usa HIST_SERIES_PADRAO */
+int  hist_iniciar(historico_t *h, size_t max_series);
+void hist_destruir(historico_t *h);
+
+/*
+ * Acrescenta uma amostra (real_ns vem do carimbo da coleta). Amostras fora
+ * de ordem (relógio de parede que voltou) entram no nível bruto com o
+ * instante da última, para o anel continuar ordenado, e não reabrem
+ * intervalos já fechados.
+ * Retorna -1 se a série não existe e o limite de séries foi atingido.
+ */
+int hist_registrar(historico_t *h, pid_t pid, const char *metrica,
+                   long long real_ns, double valor);
+
+/*
+ * Copia para 'saida' (do mais antigo ao mais recente) até 'max' pontos do
+ * nível com inicio_ns >= desde_ns, incluindo o intervalo ainda aberto.
+ * Retorna quantos foram copiados.
+ */
+size_t hist_consultar(const historico_t *h, pid_t pid, const char *metrica,
+                      hist_nivel_t nivel, long long desde_ns,
+                      hist_ponto_t *saida, size_t max);
+
+/* Agrega em 'resumo' todos os pontos do nível a partir de desde_ns. Retorna -1 sem dados */
+int hist_resumo(const historico_t *h, pid_t pid, const char *metrica,
+                hist_nivel_t nivel, long long desde_ns, hist_ponto_t *resumo);
+
+/* Descarta todas as séries de um alvo (processo encerrado) */
+void hist_remover_alvo(historico_t *h, pid_t pid);
+
+/* Média de um ponto (soma / contagem) */
+double hist_media(const hist_ponto_t *p);
+
+/* Histórico do processo, criado no primeiro uso (relatórios interativos) */
+historico_t *hist_padrao(void);
+
+/*
+ * Linha "Tendência" dos relatórios: min/média/máx das leituras anteriores do
+ * mesmo alvo. Não escreve nada se ainda não há pelo menos duas leituras.
+ */
+void hist_imprimir_tendencia(FILE *out, const historico_t *h, pid_t pid,
+                             const char *metrica, const char *rotulo, const char *unidade);
+
+#endif /* TIMESERIES_H */
@@ -0,0 +1,45 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stddef.h>
+
+/* ==================== CARIMBO DE TEMPO COMPARTILHADO ==================== */
+
+/*
+ * Cada amostra leva os dois relógios lidos no mesmo instante: o de parede
+ * (CLOCK_REALTIME), que vira o texto das colunas "timestamp", e o monotônico
+ * (CLOCK_MONOTONIC), que mede os intervalos das taxas sem sofrer com ajustes
+ * de NTP ou mudança manual da hora.
+ */
+typedef struct {
+    long long real_ns;
+    long long mono_ns;
+} carimbo_t;
+
+typedef enum {
+    CARIMBO_SEG = 0,    // 2026-01-31 12:00:00
+    CARIMBO_MS,         // 2026-01-31 12:00:00.123 (padrão)
+    CARIMBO_US          // 2026-01-31 12:00:00.123456
+} carimbo_precisao_t;
+
+/* Suficiente para qualquer precisão, com folga */
+#define CARIMBO_TAM 32
+
+/* Lê os dois relógios */
+void carimbo_agora(carimbo_t *c);
+
+/*
+ * Texto local "AAAA-MM-DD HH:MM:SS[.fração]" de 'real_ns' na precisão
+ * padrão. O prefixo até os segundos fica em cache por thread, então
+ * localtime_r/strftime só rodam quando o segundo muda.
+ */
+void carimbo_formatar(long long real_ns, char *buf, size_t tam);
+
+/* Atalho: lê os relógios e formata; 'c' pode ser NULL */
+void carimbo_texto_agora(char *buf, size_t tam, carimbo_t *c);
+
+/* Precisão das colunas de timestamp (opção global --precisao s|ms|us) */
+int                carimbo_selecionar(const char *nome);
+carimbo_precisao_t carimbo_precisao(void);
+
+#endif /* TIMESTAMP_H */
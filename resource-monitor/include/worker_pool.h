@@ -0,0 +1,62 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+/* ==================== POOL DE WORKERS COM ROUBO DE SHARDS ==================== */
+
+/*
+ * Processa os itens [inicio, fim) de um shard. 'worker' é o índice da thread
+ * (0 = a thread que chamou pool_executar). Shards diferentes nunca se
+ * sobrepõem, então cada item pode ser escrito sem trava.
+ */
+typedef void (*pool_tarefa_t)(void *ctx, size_t inicio, size_t fim, int worker);
+
+/* Fila de shards de um worker: [inicio, fim) empacotados em 64 bits (CAS único) */
+typedef struct {
+    unsigned long long faixa;
+    char               preenchimento[56];   // uma linha de cache por worker
+} pool_fila_t;
+
+typedef struct {
+    int               num_workers;    // inclui a thread chamadora
+    pthread_t        *threads;        // num_workers - 1 threads auxiliares
+    pool_fila_t      *filas;
+    pthread_mutex_t   trava;          // só largada/chegada do tick; os shards não usam trava
+    pthread_cond_t    largada;
+    pthread_cond_t    chegada;
+    unsigned long     geracao;        // incrementada a cada pool_executar
+    int               pendentes;      // threads auxiliares ainda trabalhando no tick
+    int               encerrar;
+
+    /* trabalho do tick atual */
+    pool_tarefa_t     tarefa;
+    void             *ctx;
+    size_t            num_itens;
+    size_t            tam_shard;
+
+    unsigned long     roubos;         // shards roubados desde o início
+} pool_t;
+
+/*
+ * Cria o pool. num_workers <= 0 usa um worker por CPU permitida
+ * (sched_getaffinity). Cada thread auxiliar i é fixada na i-ésima CPU da
+ * máscara; a thread chamadora não é fixada. Com 1 worker não há threads.
+ */
+int  pool_iniciar(pool_t *p, int num_workers);
+void pool_destruir(pool_t *p);
+
+/*
+ * Divide num_itens em shards de tam_shard, distribui faixas contíguas de
+ * shards entre os workers e espera todos terminarem. Um worker sem shards
+ * rouba metade dos que restam na fila de outro, então uma leitura lenta
+ * (processo em estado D) só atrasa o próprio shard.
+ */
+void pool_executar(pool_t *p, size_t num_itens, size_t tam_shard,
+                   pool_tarefa_t tarefa, void *ctx);
+
+/* Número de CPUs na máscara de afinidade do processo (>= 1) */
+int pool_cpus_disponiveis(void);
+
+#endif /* WORKER_POOL_H */
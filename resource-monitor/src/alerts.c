@@ -0,0 +1,441 @@
+// alerts.c - regras de limiar e de taxa de variação, com histerese, cooldown e ações
+#define _POSIX_C_SOURCE 200809L  // sigaction, O_CLOEXEC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../include/alerts.h"
+#include "../include/timestamp.h"
+
+#define NS_POR_SEG 1000000000LL
+
+/* Colunas que os loops cpu/mem/io/all entregam ao motor */
+static const char *const METRICAS[] = {
+    "cpu_processo_percent", "cpu_sistema_percent",
+    "cpu_wait_ms_s", "voluntary_ctxsw_ps", "nonvoluntary_ctxsw_ps",
+    "rss_kb", "vsz_kb", "shared_kb", "swap_kb", "minor_faults", "major_faults",
+    "proc_mem_percent",
+    "read_bps", "write_bps", "read_syscalls_ps", "write_syscalls_ps", "disk_ops_ps",
+};
+#define NUM_METRICAS (sizeof(METRICAS) / sizeof(METRICAS[0]))
+
+static alertas_t padrao;
+
+/* ==================== INTERPRETAÇÃO ==================== */
+
+/* Copia o próximo token (separado por espaços) e avança *p; 0 se acabou */
+static int proximo_token(const char **p, char *tok, size_t tam) {
+    const char *c = *p;
+    while (isspace((unsigned char)*c)) c++;
+    size_t n = 0;
+    while (*c && !isspace((unsigned char)*c)) {
+        if (n + 1 < tam) tok[n++] = *c;
+        c++;
+    }
+    tok[n] = '\0';
+    *p = c;
+    return n > 0;
+}
+
+static int termina_com(const char *s, const char *sufixo) {
+    size_t a = strlen(s), b = strlen(sufixo);
+    return a >= b && strcmp(s + a - b, sufixo) == 0;
+}
+
+/* "10", "90%", "10MB", "512K/s", "10MB/min"; taxas sem unidade de tempo são por segundo */
+static int ler_quantidade(const char *tok, const char *metrica, int taxa, double *out) {
+    char *fim;
+    double v = strtod(tok, &fim);
+    if (fim == tok) return -1;
+
+    double mult = 1.0;
+    switch (toupper((unsigned char)*fim)) {
+        case 'K': mult = 1024.0;                   fim++; break;
+        case 'M': mult = 1024.0 * 1024.0;          fim++; break;
+        case 'G': mult = 1024.0 * 1024.0 * 1024.0; fim++; break;
+        default: break;
+    }
+    int bytes = mult != 1.0;
+    if (toupper((unsigned char)*fim) == 'B') {
+        bytes = 1;
+        fim++;
+    }
+    if (bytes && termina_com(metrica, "_kb")) mult /= 1024.0;
+    if (*fim == '%') fim++;
+
+    double por_seg = 1.0;
+    if (*fim == '/') {
+        if (!taxa) return -1;
+        fim++;
+        if      (strcmp(fim, "s") == 0)   por_seg = 1.0;
+        else if (strcmp(fim, "min") == 0) por_seg = 60.0;
+        else if (strcmp(fim, "h") == 0)   por_seg = 3600.0;
+        else return -1;
+        fim += strlen(fim);
+    }
+    if (*fim != '\0') return -1;
+
+    *out = v * mult / por_seg;
+    return 0;
+}
+
+/* "500ms", "5s", "2min", "1h"; sem unidade = segundos */
+static int ler_duracao(const char *tok, long long *out_ns) {
+    char *fim;
+    double v = strtod(tok, &fim);
+    if (fim == tok || v < 0) return -1;
+
+    double escala;
+    if      (*fim == '\0' || strcmp(fim, "s") == 0) escala = 1e9;
+    else if (strcmp(fim, "ms") == 0)                escala = 1e6;
+    else if (strcmp(fim, "min") == 0)               escala = 60e9;
+    else if (strcmp(fim, "h") == 0)                 escala = 3600e9;
+    else return -1;
+
+    *out_ns = (long long)(v * escala);
+    return 0;
+}
+
+static int ler_operador(const char *tok, alerta_op_t *op) {
+    if      (strcmp(tok, ">") == 0)  *op = ALERTA_MAIOR;
+    else if (strcmp(tok, ">=") == 0) *op = ALERTA_MAIOR_IGUAL;
+    else if (strcmp(tok, "<") == 0)  *op = ALERTA_MENOR;
+    else if (strcmp(tok, "<=") == 0) *op = ALERTA_MENOR_IGUAL;
+    else return -1;
+    return 0;
+}
+
+static int ler_acao(const char *acao, alerta_regra_t *r) {
+    if (strcmp(acao, "log") == 0) {
+        r->acao = ALERTA_ACAO_LOG;
+    } else if (strncmp(acao, "exec:", 5) == 0 && acao[5]) {
+        r->acao = ALERTA_ACAO_EXEC;
+        snprintf(r->destino, sizeof(r->destino), "%s", acao + 5);
+    } else if (strncmp(acao, "fifo:", 5) == 0 && acao[5]) {
+        r->acao = ALERTA_ACAO_FIFO;
+        snprintf(r->destino, sizeof(r->destino), "%s", acao + 5);
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int invalida(const char *texto, const char *motivo) {
+    fprintf(stderr, "Regra de alerta inválida (%s): %s\n", motivo, texto);
+    return -1;
+}
+
+int alerta_interpretar(const char *texto, alerta_regra_t *out) {
+    if (!texto || !out) return -1;
+    if (strlen(texto) >= ALERTA_TEXTO_MAX) return invalida(texto, "longa demais");
+
+    memset(out, 0, sizeof(*out));
+    snprintf(out->texto, sizeof(out->texto), "%s", texto);
+    out->janela_ns = ALERTA_JANELA_PADRAO_NS;
+
+    const char *p = texto;
+    char tok[ALERTA_TEXTO_MAX];
+
+    if (!proximo_token(&p, tok, sizeof(tok))) return invalida(texto, "vazia");
+    size_t m;
+    for (m = 0; m < NUM_METRICAS; m++) {
+        if (strcmp(tok, METRICAS[m]) == 0) break;
+    }
+    if (m == NUM_METRICAS) return invalida(texto, "métrica desconhecida");
+    snprintf(out->metrica, sizeof(out->metrica), "%s", METRICAS[m]);
+
+    if (!proximo_token(&p, tok, sizeof(tok))) return invalida(texto, "falta o operador");
+    if (strcmp(tok, "rising") == 0 || strcmp(tok, "falling") == 0) {
+        out->tipo = tok[0] == 'r' ? ALERTA_SUBINDO : ALERTA_DESCENDO;
+        if (!proximo_token(&p, tok, sizeof(tok))) return invalida(texto, "falta o operador");
+    }
+    if (ler_operador(tok, &out->op) != 0) return invalida(texto, "operador deve ser > >= < <=");
+
+    int taxa = out->tipo != ALERTA_VALOR;
+    if (!proximo_token(&p, tok, sizeof(tok)) ||
+        ler_quantidade(tok, out->metrica, taxa, &out->limiar) != 0) {
+        return invalida(texto, "limiar");
+    }
+    out->limiar_normal = out->limiar;
+
+    int com_normal = 0;
+    while (proximo_token(&p, tok, sizeof(tok))) {
+        if (strcmp(tok, "do") == 0) {
+            // a ação é o resto da linha (exec pode ter espaços)
+            while (isspace((unsigned char)*p)) p++;
+            char acao[ALERTA_TEXTO_MAX];
+            snprintf(acao, sizeof(acao), "%s", p);
+            size_t n = strlen(acao);
+            while (n > 0 && isspace((unsigned char)acao[n - 1])) acao[--n] = '\0';
+            if (ler_acao(acao, out) != 0) return invalida(texto, "ação deve ser log, exec:<cmd> ou fifo:<caminho>");
+            break;
+        }
+
+        char valor[ALERTA_TEXTO_MAX];
+        if (!proximo_token(&p, valor, sizeof(valor))) return invalida(texto, "cláusula sem valor");
+
+        if (strcmp(tok, "for") == 0) {
+            if (ler_duracao(valor, &out->durante_ns) != 0) return invalida(texto, "duração de for");
+        } else if (strcmp(tok, "cooldown") == 0) {
+            if (ler_duracao(valor, &out->espera_ns) != 0) return invalida(texto, "duração de cooldown");
+        } else if (strcmp(tok, "over") == 0) {
+            if (!taxa) return invalida(texto, "over só vale para rising/falling");
+            if (ler_duracao(valor, &out->janela_ns) != 0 || out->janela_ns <= 0) {
+                return invalida(texto, "duração de over");
+            }
+        } else if (strcmp(tok, "clear") == 0) {
+            if (ler_quantidade(valor, out->metrica, taxa, &out->limiar_normal) != 0) {
+                return invalida(texto, "valor de clear");
+            }
+            com_normal = 1;
+        } else {
+            return invalida(texto, "cláusula desconhecida");
+        }
+    }
+
+    // histerese só faz sentido do lado "bom" do limiar
+    if (com_normal) {
+        int acima = out->op == ALERTA_MAIOR || out->op == ALERTA_MAIOR_IGUAL;
+        if (acima ? out->limiar_normal > out->limiar : out->limiar_normal < out->limiar) {
+            return invalida(texto, "clear deve ficar do lado normal do limiar");
+        }
+    }
+    return 0;
+}
+
+/* ==================== AÇÕES ==================== */
+
+static void colher_filhos(alertas_t *al) {
+    for (int k = 0; k < al->num_filhos; ) {
+        pid_t r = waitpid(al->filhos[k], NULL, WNOHANG);
+        if (r == al->filhos[k] || (r < 0 && errno == ECHILD)) {
+            al->filhos[k] = al->filhos[--al->num_filhos];
+        } else {
+            k++;
+        }
+    }
+}
+
+static void notificar(alertas_t *al, const alerta_regra_t *r, pid_t pid,
+                      const char *evento, double valor) {
+    char ts[CARIMBO_TAM];
+    carimbo_texto_agora(ts, sizeof(ts), NULL);
+
+    if (r->acao == ALERTA_ACAO_LOG) {
+        fprintf(stderr, "[ALERTA %s] %s PID %d: %s (valor %.2f)\n",
+                ts, evento, pid, r->texto, valor);
+        return;
+    }
+
+    char txt_valor[32], txt_pid[16];
+    snprintf(txt_valor, sizeof(txt_valor), "%.2f", valor);
+    snprintf(txt_pid, sizeof(txt_pid), "%d", pid);
+
+    if (r->acao == ALERTA_ACAO_EXEC) {
+        if (al->num_filhos >= ALERTA_FILHOS_MAX) {
+            al->acoes_perdidas++;  // comandos anteriores ainda rodando
+            return;
+        }
+        pid_t filho = fork();
+        if (filho == 0) {
+            // só chamadas seguras após fork: há outras threads (escritora) no processo
+            execl("/bin/sh", "sh", "-c", r->destino, "alerta",
+                  r->texto, evento, txt_valor, txt_pid, (char *)NULL);
+            _exit(127);
+        }
+        if (filho < 0) {
+            al->acoes_perdidas++;
+            return;
+        }
+        al->filhos[al->num_filhos++] = filho;
+        return;
+    }
+
+    // FIFO: sem leitor (ENXIO) ou cheia (EAGAIN), o evento é descartado em vez de travar a coleta
+    char linha[ALERTA_TEXTO_MAX + 96];
+    int n = snprintf(linha, sizeof(linha), "%s %s %s %s %s\n", ts, evento, txt_pid, txt_valor, r->texto);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(linha)) n = (int)sizeof(linha) - 1;
+    int fd = open(r->destino, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0 || write(fd, linha, (size_t)n) != n) al->acoes_perdidas++;
+    if (fd >= 0) close(fd);
+}
+
+/* ==================== AVALIAÇÃO ==================== */
+
+static int condicao(const alerta_regra_t *r, double v) {
+    switch (r->op) {
+        case ALERTA_MAIOR:       return v >  r->limiar;
+        case ALERTA_MAIOR_IGUAL: return v >= r->limiar;
+        case ALERTA_MENOR:       return v <  r->limiar;
+        case ALERTA_MENOR_IGUAL: return v <= r->limiar;
+    }
+    return 0;
+}
+
+static int normalizou(const alerta_regra_t *r, double v) {
+    switch (r->op) {
+        case ALERTA_MAIOR:       return v <= r->limiar_normal;
+        case ALERTA_MAIOR_IGUAL: return v <  r->limiar_normal;
+        case ALERTA_MENOR:       return v >= r->limiar_normal;
+        case ALERTA_MENOR_IGUAL: return v >  r->limiar_normal;
+    }
+    return 1;
+}
+
+/* Máquina OK -> PENDENTE -> DISPARADO -> OK; retorna 1 no disparo */
+static int avaliar(alertas_t *al, alerta_regra_t *r, pid_t pid, long long mono_ns, double v) {
+    if (r->estado == ALERTA_DISPARADO) {
+        if (normalizou(r, v)) {
+            r->estado = ALERTA_OK;
+            if (r->avisado) notificar(al, r, pid, "NORMALIZADO", v);
+            r->avisado = 0;
+        }
+        return 0;
+    }
+
+    if (!condicao(r, v)) {
+        r->estado = ALERTA_OK;  // 'for' exige a condição contínua
+        return 0;
+    }
+    if (r->estado == ALERTA_OK) {
+        r->estado   = ALERTA_PENDENTE;
+        r->desde_ns = mono_ns;
+    }
+    if (mono_ns - r->desde_ns < r->durante_ns) return 0;
+
+    r->estado = ALERTA_DISPARADO;
+    r->disparos++;
+    if (r->ultimo_aviso_ns == 0 || mono_ns - r->ultimo_aviso_ns >= r->espera_ns) {
+        notificar(al, r, pid, "DISPARADO", v);
+        r->avisado         = 1;
+        r->ultimo_aviso_ns = mono_ns;
+    } else {
+        r->avisado = 0;
+        r->suprimidos++;
+    }
+    return 1;
+}
+
+int alertas_observar(alertas_t *al, pid_t pid, const char *metrica,
+                     long long mono_ns, double valor) {
+    if (!al || al->num == 0 || !metrica || valor != valor) return 0;
+    if (al->num_filhos > 0) colher_filhos(al);
+
+    int disparos = 0;
+    for (size_t k = 0; k < al->num; k++) {
+        alerta_regra_t *r = &al->regras[k];
+        if (strcmp(r->metrica, metrica) != 0) continue;
+
+        double v = valor;
+        if (r->tipo != ALERTA_VALOR) {
+            // taxa recalculada a cada janela: o ruído entre amostras vizinhas não dispara
+            if (!r->ref_valida) {
+                r->ref_ns     = mono_ns;
+                r->ref_valor  = valor;
+                r->ref_valida = 1;
+                continue;
+            }
+            long long dt = mono_ns - r->ref_ns;
+            if (dt >= r->janela_ns) {
+                r->taxa        = (valor - r->ref_valor) * (double)NS_POR_SEG / (double)dt;
+                r->taxa_valida = 1;
+                r->ref_ns      = mono_ns;
+                r->ref_valor   = valor;
+            }
+            if (!r->taxa_valida) continue;
+            v = r->tipo == ALERTA_SUBINDO ? r->taxa : -r->taxa;
+        }
+        disparos += avaliar(al, r, pid, mono_ns, v);
+    }
+    return disparos;
+}
+
+/* ==================== CONJUNTO DE REGRAS ==================== */
+
+int alertas_adicionar(alertas_t *al, const char *texto) {
+    if (!al) return -1;
+    alerta_regra_t r;
+    if (alerta_interpretar(texto, &r) != 0) return -1;
+
+    if (al->num == al->cap) {
+        size_t cap = al->cap ? al->cap * 2 : 4;
+        alerta_regra_t *novo = (alerta_regra_t *)realloc(al->regras, cap * sizeof(*novo));
+        if (!novo) {
+            fprintf(stderr, "alertas_adicionar: sem memória\n");
+            return -1;
+        }
+        al->regras = novo;
+        al->cap    = cap;
+    }
+    if (r.acao == ALERTA_ACAO_FIFO) {
+        // leitor que fecha a FIFO no meio do write não pode derrubar o monitor
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = SIG_IGN;
+        sigaction(SIGPIPE, &sa, NULL);
+    }
+    al->regras[al->num++] = r;
+    return 0;
+}
+
+int alertas_carregar(alertas_t *al, const char *arquivo) {
+    FILE *fp = fopen(arquivo, "r");
+    if (!fp) {
+        fprintf(stderr, "Não foi possível abrir o arquivo de alertas %s: %s\n",
+                arquivo, strerror(errno));
+        return -1;
+    }
+
+    char linha[ALERTA_TEXTO_MAX + 2];
+    int num_linha = 0, rc = 0;
+    while (fgets(linha, sizeof(linha), fp)) {
+        num_linha++;
+        char *c = linha;
+        while (isspace((unsigned char)*c)) c++;
+        size_t n = strlen(c);
+        while (n > 0 && isspace((unsigned char)c[n - 1])) c[--n] = '\0';
+        if (n == 0 || *c == '#') continue;
+
+        if (alertas_adicionar(al, c) != 0) {
+            fprintf(stderr, "  em %s:%d\n", arquivo, num_linha);
+            rc = -1;
+            break;
+        }
+    }
+    fclose(fp);
+    return rc;
+}
+
+void alertas_destruir(alertas_t *al) {
+    if (!al) return;
+    colher_filhos(al);
+    free(al->regras);
+    memset(al, 0, sizeof(*al));
+}
+
+alertas_t *alertas_padrao(void) {
+    return &padrao;
+}
+
+void alertas_relatar(const alertas_t *al) {
+    if (!al) return;
+    for (size_t k = 0; k < al->num; k++) {
+        const alerta_regra_t *r = &al->regras[k];
+        if (r->disparos == 0) continue;
+        fprintf(stderr, "Alerta '%s': %lu disparo(s), %lu suprimido(s) pelo cooldown\n",
+                r->texto, r->disparos, r->suprimidos);
+    }
+    if (al->acoes_perdidas > 0) {
+        fprintf(stderr, "Alertas: %lu ação(ões) não executada(s) (exec ocupado ou FIFO sem leitor)\n",
+                al->acoes_perdidas);
+    }
+}
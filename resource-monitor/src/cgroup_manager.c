@@ -350,9 +350,48 @@ int cgroup_ler_metricas_completas(const char *cgroup_name,
         }
     }
 
+    /* Sinal de contenção: tempo parado por CPU, memória e I/O (PSI).
+     * Sem PSI (kernel antigo, psi=0, v1 sem árvore unified) os bits ficam em 0 */
+    for (int r = 0; r < PSI_NUM_RECURSOS; r++) {
+        if (psi_ler_cgroup(cgroup_name, (psi_recurso_t)r, &metrics->pressao[r]) == 0)
+            metrics->pressao_lida |= 1U << r;
+    }
+
     return 0;
 }
 
+/* ==================== CGROUP DE UM PROCESSO ==================== */
+
+int cgroup_do_processo(pid_t pid, char *out, size_t size) {
+    if (!out || size == 0) return -1;
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    /* v2: linha "0::/caminho"; v1: a hierarquia do controlador memory
+     * (as leituras acima usam o mesmo nome em todos os controladores) */
+    const char *alvo = cgroup_detectar_versao() == 2 ? "" : "memory";
+    char line[PATH_MAX];
+    int rc = -1;
+    while (rc != 0 && fgets(line, sizeof(line), fp)) {
+        char *ctrl = strchr(line, ':');
+        char *cg   = ctrl ? strchr(ctrl + 1, ':') : NULL;
+        if (!cg) continue;
+        *cg++ = '\0';
+        ctrl++;
+        if (strcmp(ctrl, alvo) != 0) continue;
+
+        cg[strcspn(cg, "\n")] = '\0';
+        while (*cg == '/') cg++;   /* nomes relativos a /sys/fs/cgroup[/controlador] */
+        snprintf(out, size, "%s", cg);
+        rc = 0;
+    }
+    fclose(fp);
+    return rc;
+}
+
 /* ==================== CRIAÇÃO E CONFIGURAÇÃO ==================== */
 
 int cgroup_criar(const char *cgroup_name,
@@ -538,6 +577,15 @@ int cgroup_relatorio_usage(const char *cgroup_name) {
     printf("Memory Fails: %lu\n", metrics.memory_failcnt);
     printf("I/O Read:     %llu bytes\n", metrics.io_read_bytes);
     printf("I/O Write:    %llu bytes\n", metrics.io_write_bytes);
+    for (int r = 0; r < PSI_NUM_RECURSOS; r++) {
+        if (!(metrics.pressao_lida & (1U << r))) continue;
+        const psi_t *p = &metrics.pressao[r];
+        printf("Pressão %-6s some avg10/60/300: %5.2f/%5.2f/%5.2f %%",
+               psi_nome_recurso((psi_recurso_t)r), p->some.avg10, p->some.avg60, p->some.avg300);
+        if (p->tem_full)
+            printf("  full: %5.2f/%5.2f/%5.2f %%", p->full.avg10, p->full.avg60, p->full.avg300);
+        printf("\n");
+    }
     printf("====================================\n");
 
     return 0;
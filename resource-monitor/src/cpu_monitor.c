@@ -1,5 +1,5 @@
 // cpu_monitor.c
-#define _POSIX_C_SOURCE 200809L  // garante nanosleep/localtime_r em alguns ambientes
+#define _POSIX_C_SOURCE 200809L  // garante nanosleep em alguns ambientes
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,7 +8,19 @@
 #include <time.h>
 #include <sys/types.h>
 #include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/scheduler.h"
+#include "../include/taskstats_backend.h"
+#include "../include/targets.h"
+#include "../include/ring_buffer.h"
+#include "../include/timestamp.h"
+#include "../include/timeseries.h"
+#include "../include/quantile.h"
+#include "../include/alerts.h"
 
 /* -------------------- Estado para uso instantâneo -------------------- */
 
@@ -16,38 +28,12 @@ typedef struct {
     pid_t        pid;
     cpu_times_t  sys_antes;
     proc_cpu_t   proc_antes;
+    int          origem;      // fixada na primeira leitura do PID (cpu_origem_processo)
     int          iniciado;
 } cpu_monitor_state_t;
 
 static cpu_monitor_state_t monitor_state = { .pid = -1, .iniciado = 0 };
 
-/* -------------------- Utilitários internos -------------------- */
-
-/* Timestamp legível (thread-safe) */
-static void obter_timestamp(char *buffer, size_t size) {
-    time_t now = time(NULL);
-    if (now == (time_t)-1) {
-        snprintf(buffer, size, "ERRO_TIMESTAMP");
-        return;
-    }
-    struct tm tm_info;
-    localtime_r(&now, &tm_info);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &tm_info);
-}
-
-/* Sleep em milissegundos com retry em EINTR */
-static void dormir_ms(int intervalo_ms) {
-    struct timespec req = {
-        .tv_sec  = intervalo_ms / 1000,
-        .tv_nsec = (long)(intervalo_ms % 1000) * 1000000L
-    };
-    struct timespec rem = req;
-
-    while (nanosleep(&req, &rem) == -1 && errno == EINTR) {
-        req = rem;  // continua de onde parou
-    }
-}
-
 /* -------------------- Leitura de tempos do sistema -------------------- */
 
 int cpu_ler_times_sistema(cpu_times_t *out) {
@@ -56,54 +42,113 @@ int cpu_ler_times_sistema(cpu_times_t *out) {
         return -1;
     }
 
-    FILE *fp = fopen("/proc/stat", "r");
-    if (!fp) {
-        fprintf(stderr, "Erro ao abrir /proc/stat: %s\n", strerror(errno));
+    // Descritor de /proc/stat fica aberto entre amostras (pread no offset 0)
+    const char *buffer = proc_cache_ler_sistema(PROC_SIS_STAT, NULL);
+    if (!buffer) {
+        fprintf(stderr, "Erro ao ler /proc/stat: %s\n", strerror(errno));
         return -1;
     }
 
-    char buffer[512];
-    if (!fgets(buffer, sizeof(buffer), fp)) {
-        fprintf(stderr, "Erro ao ler /proc/stat\n");
-        fclose(fp);
+    return cpu_interpretar_stat_sistema(buffer, out);
+}
+
+/* Converte os contadores de uma linha "cpu"/"cpuN" (ordem do proc(5)) em cpu_times_t */
+static void montar_cpu_times(const unsigned long long v[10], cpu_times_t *out) {
+    cpu_times_t t = {0};
+    t.user       = v[0];
+    t.nice       = v[1];
+    t.system     = v[2];
+    t.idle       = v[3];
+    t.iowait     = v[4];
+    t.irq        = v[5];
+    t.softirq    = v[6];
+    t.steal      = v[7];
+    t.guest      = v[8];
+    t.guest_nice = v[9];
+
+    // total = todas as colunas principais (guest/guest_nice já estão em user/nice)
+    t.total  = t.user + t.nice + t.system + t.idle +
+               t.iowait + t.irq + t.softirq + t.steal;
+
+    // active = total - (idle + iowait) → iowait conta como “inativo”
+    t.active = t.total - (t.idle + t.iowait);
+
+    *out = t;
+}
+
+int cpu_interpretar_stat_sistema(const char *buffer, cpu_times_t *out) {
+    if (!buffer || !out) {
+        fprintf(stderr, "Erro: ponteiro nulo em cpu_interpretar_stat_sistema\n");
         return -1;
     }
-    fclose(fp);
 
     // Tenta ler até 10 campos: user nice system idle iowait irq softirq steal guest guest_nice
-    unsigned long long user=0, nice=0, system=0, idle=0;
-    unsigned long long iowait=0, irq=0, softirq=0, steal=0, guest=0, guest_nice=0;
-
-    int n = sscanf(buffer,
-                   "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                   &user, &nice, &system, &idle,
-                   &iowait, &irq, &softirq, &steal,
-                   &guest, &guest_nice);
+    // (kernels antigos expõem menos colunas; as ausentes ficam em 0)
+    unsigned long long v[10] = {0};
+    int n = proc_stat_linha_cpu(buffer, v, 10, NULL);
 
     if (n < 4) {
         fprintf(stderr, "Formato inesperado em /proc/stat (lidos=%d)\n", n);
         return -1;
     }
 
-    cpu_times_t t = {0};
-    t.user    = user;
-    t.nice    = nice;
-    t.system  = system;
-    t.idle    = idle;
-    t.iowait  = (n > 4) ? iowait  : 0;
-    t.irq     = (n > 5) ? irq     : 0;
-    t.softirq = (n > 6) ? softirq : 0;
-    t.steal   = (n > 7) ? steal   : 0;
-
-    // total = todas as colunas principais
-    t.total  = t.user + t.nice + t.system + t.idle +
-               t.iowait + t.irq + t.softirq + t.steal;
+    montar_cpu_times(v, out);
+    return 0;
+}
 
-    // active = total - (idle + iowait) → iowait conta como “inativo”
-    t.active = t.total - (t.idle + t.iowait);
+/* -------------------- Leitura por core -------------------- */
 
-    *out = t;
-    return 0;
+int cpu_num_cores(void) {
+    long n = sysconf(_SC_NPROCESSORS_CONF);
+    return (n < 1) ? 1 : (int)n;
+}
+
+int cpu_ler_times_por_core(cpu_times_t *cores, int max_cores) {
+    if (!cores || max_cores <= 0) {
+        fprintf(stderr, "Erro: parâmetros inválidos em cpu_ler_times_por_core\n");
+        return -1;
+    }
+
+    const char *buffer = proc_cache_ler_sistema(PROC_SIS_STAT, NULL);
+    if (!buffer) {
+        fprintf(stderr, "Erro ao ler /proc/stat: %s\n", strerror(errno));
+        return -1;
+    }
+
+    return cpu_interpretar_stat_por_core(buffer, cores, max_cores);
+}
+
+int cpu_interpretar_stat_por_core(const char *buffer, cpu_times_t *cores, int max_cores) {
+    if (!buffer || !cores || max_cores <= 0) {
+        fprintf(stderr, "Erro: parâmetros inválidos em cpu_interpretar_stat_por_core\n");
+        return -1;
+    }
+
+    // Cores offline não aparecem em /proc/stat: suas posições ficam zeradas
+    memset(cores, 0, sizeof(cpu_times_t) * (size_t)max_cores);
+
+    int preenchidos = 0;
+    for (const char *linha = buffer; linha; linha = proc_proxima_linha(linha)) {
+        // As linhas "cpu"/"cpuN" vêm juntas no início do arquivo
+        if (strncmp(linha, "cpu", 3) != 0) {
+            if (preenchidos > 0) break;
+            continue;
+        }
+
+        unsigned long long v[10] = {0};
+        int core = -1;
+        int n = proc_stat_linha_cpu(linha, v, 10, &core);
+        if (n < 4 || core < 0 || core >= max_cores) continue;
+
+        montar_cpu_times(v, &cores[core]);
+        if (core + 1 > preenchidos) preenchidos = core + 1;
+    }
+
+    if (preenchidos == 0) {
+        fprintf(stderr, "Nenhuma linha cpuN encontrada em /proc/stat\n");
+        return -1;
+    }
+    return preenchidos;
 }
 
 double cpu_calculo_percentual(const cpu_times_t *antes, const cpu_times_t *depois) {
@@ -123,7 +168,19 @@ double cpu_calculo_percentual(const cpu_times_t *antes, const cpu_times_t *depoi
 
 /* -------------------- Leitura de tempos do processo -------------------- */
 
+int cpu_origem_processo(pid_t pid) {
+    if (backend_atual() != BACKEND_TASKSTATS) return 0;
+    taskstats_info_t ts;
+    if (taskstats_ler_pid(pid, &ts) == 0) return 1;
+    fprintf(stderr, "Aviso: taskstats não respondeu para o PID %d; CPU lida de /proc neste run\n", pid);
+    return 0;
+}
+
 int cpu_ler_processo(pid_t pid, proc_cpu_t *out) {
+    return cpu_ler_processo_de(pid, cpu_origem_processo(pid), out);
+}
+
+int cpu_ler_processo_de(pid_t pid, int origem_taskstats, proc_cpu_t *out) {
     if (!out) {
         fprintf(stderr, "Erro: ponteiro nulo em cpu_ler_processo\n");
         return -1;
@@ -133,43 +190,50 @@ int cpu_ler_processo(pid_t pid, proc_cpu_t *out) {
         return -1;
     }
 
-    char caminho[64];
-    snprintf(caminho, sizeof(caminho), "/proc/%d/stat", pid);
+    // Backend netlink: uma mensagem binária, sem filhos recolhidos em total_time
+    if (origem_taskstats) {
+        taskstats_info_t ts;
+        if (taskstats_ler_pid(pid, &ts) != 0) {
+            fprintf(stderr, "Erro ao consultar taskstats do processo %d\n", pid);
+            return -1;
+        }
+        taskstats_para_proc_cpu(&ts, out);
+        return 0;
+    }
 
-    FILE *fp = fopen(caminho, "r");
-    if (!fp) {
-        fprintf(stderr, "Erro ao abrir %s: %s\n", caminho, strerror(errno));
+    const char *linha = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+    if (!linha) {
+        fprintf(stderr, "Erro ao ler /proc/%d/stat: %s\n", pid, strerror(errno));
         return -1;
     }
 
-    char linha[1024];
-    if (!fgets(linha, sizeof(linha), fp)) {
-        fprintf(stderr, "Erro ao ler %s\n", caminho);
-        fclose(fp);
+    if (cpu_interpretar_stat_processo(linha, out) != 0) {
+        fprintf(stderr, "Não foi possível ler tempos do processo %d\n", pid);
         return -1;
     }
-    fclose(fp);
+    return 0;
+}
 
-    // /proc/<pid>/stat: o nome do processo vai até o último ')'
-    char *p = strrchr(linha, ')');
-    if (!p) {
-        fprintf(stderr, "Formato inesperado em %s (não encontrou ')')\n", caminho);
+int cpu_interpretar_stat_processo(const char *linha, proc_cpu_t *out) {
+    if (!linha || !out) {
+        fprintf(stderr, "Erro: ponteiro nulo em cpu_interpretar_stat_processo\n");
         return -1;
     }
-    p++;  // depois do ')'
-
-    // Campos 14–17: utime, stime, cutime, cstime
-    unsigned long long utime=0, stime=0, cutime=0, cstime=0;
-    int lidos = sscanf(p,
-        " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %llu %llu",
-        &utime, &stime, &cutime, &cstime);
 
-    if (lidos < 2) {
-        fprintf(stderr, "Não foi possível ler tempos do processo %d (lidos=%d)\n",
-                pid, lidos);
+    // Campos 14–17: utime, stime, cutime, cstime (comm pode conter ')' e espaços)
+    proc_stat_campos_t c;
+    const unsigned long long pedidos = PSTAT_BIT(PSTAT_UTIME) | PSTAT_BIT(PSTAT_STIME) |
+                                       PSTAT_BIT(PSTAT_CUTIME) | PSTAT_BIT(PSTAT_CSTIME);
+    if (proc_stat_interpretar(linha, pedidos, &c) != 0) {
+        fprintf(stderr, "Formato inesperado em /proc/<pid>/stat\n");
         return -1;
     }
 
+    unsigned long long utime  = c.campos[PSTAT_UTIME];
+    unsigned long long stime  = c.campos[PSTAT_STIME];
+    unsigned long long cutime = c.campos[PSTAT_CUTIME];
+    unsigned long long cstime = c.campos[PSTAT_CSTIME];
+
     out->utime      = utime;
     out->stime      = stime;
     out->total_time = utime + stime + cutime + cstime;
@@ -204,8 +268,273 @@ double cpu_calculo_percentual_processo(const proc_cpu_t *antes, const proc_cpu_t
     return pct;
 }
 
+/* -------------------- Latência de escalonamento -------------------- */
+
+/* Sem mensagens: também usadas por thread, onde uma thread que saiu não é erro */
+static int extrair_schedstat(const char *conteudo, proc_sched_t *out) {
+    // Três campos: ns em CPU, ns esperando na run queue, número de fatias (sched_info)
+    return sscanf(conteudo, "%llu %llu %llu", &out->run_ns, &out->espera_ns, &out->fatias) == 3 ? 0 : -1;
+}
+
+static int extrair_trocas(const char *status, proc_sched_t *out) {
+    // "\n" no padrão: "voluntary_ctxt_switches:" também casa dentro de "nonvoluntary..."
+    static const char VOL[]   = "\nvoluntary_ctxt_switches:";
+    static const char INVOL[] = "\nnonvoluntary_ctxt_switches:";
+    const char *vol   = strstr(status, VOL);
+    const char *invol = strstr(status, INVOL);
+    if (!vol || !invol) return -1;
+    out->trocas_voluntarias   = strtoull(vol + sizeof(VOL) - 1, NULL, 10);
+    out->trocas_involuntarias = strtoull(invol + sizeof(INVOL) - 1, NULL, 10);
+    return 0;
+}
+
+int cpu_interpretar_schedstat(const char *conteudo, proc_sched_t *out) {
+    if (!conteudo || !out) {
+        fprintf(stderr, "Erro: ponteiro nulo em cpu_interpretar_schedstat\n");
+        return -1;
+    }
+    if (extrair_schedstat(conteudo, out) != 0) {
+        fprintf(stderr, "Formato inesperado em schedstat\n");
+        return -1;
+    }
+    return 0;
+}
+
+int cpu_interpretar_trocas_contexto(const char *status, proc_sched_t *out) {
+    if (!status || !out) {
+        fprintf(stderr, "Erro: ponteiro nulo em cpu_interpretar_trocas_contexto\n");
+        return -1;
+    }
+    if (extrair_trocas(status, out) != 0) {
+        fprintf(stderr, "Trocas de contexto ausentes em /proc/<pid>/status\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int comparar_tid_sched(const void *a, const void *b) {
+    pid_t x = ((const cpu_sched_thread_t *)a)->tid;
+    pid_t y = ((const cpu_sched_thread_t *)b)->tid;
+    return (x > y) - (x < y);
+}
+
+static unsigned long long avanco(unsigned long long depois, unsigned long long antes) {
+    // contador menor que a base: TID reciclado entre leituras, conta a thread nova inteira
+    return depois >= antes ? depois - antes : depois;
+}
+
+static void fechar_thread_sched(cpu_sched_thread_t *t) {
+    if (t->fd_schedstat >= 0) close(t->fd_schedstat);
+    if (t->fd_status >= 0) close(t->fd_status);
+    t->fd_schedstat = t->fd_status = -1;
+}
+
+/* Abre <tid>/schedstat e <tid>/status relativos ao diretório task já aberto */
+static int abrir_thread_sched(const cpu_sched_t *s, cpu_sched_thread_t *t) {
+    char rel[48];
+    snprintf(rel, sizeof(rel), "%d/schedstat", t->tid);
+    t->fd_schedstat = openat(dirfd(s->dir), rel, O_RDONLY | O_CLOEXEC);
+    snprintf(rel, sizeof(rel), "%d/status", t->tid);
+    t->fd_status = t->fd_schedstat < 0 ? -1 : openat(dirfd(s->dir), rel, O_RDONLY | O_CLOEXEC);
+    if (t->fd_status >= 0) return 0;
+
+    int erro = errno;
+    fechar_thread_sched(t);
+    errno = erro;
+    return -1;
+}
+
+static long ler_aberto(int fd, char *buf, size_t cap) {
+    ssize_t n;
+    do {
+        n = pread(fd, buf, cap - 1, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return -1;
+    buf[n] = '\0';
+    return (long)n;
+}
+
+/* Dois pread nos descritores da thread; -1 (ESRCH) se ela saiu */
+static int ler_thread_sched(const cpu_sched_thread_t *t, proc_sched_t *out) {
+    char buf[4096];
+    memset(out, 0, sizeof(*out));
+    if (ler_aberto(t->fd_schedstat, buf, sizeof(buf)) < 0 || extrair_schedstat(buf, out) != 0) return -1;
+    if (ler_aberto(t->fd_status, buf, sizeof(buf)) < 0) return -1;
+    extrair_trocas(buf, out);  // kernels sem as linhas: trocas ficam em 0
+    return 0;
+}
+
+/*
+ * Um getdents no diretório task mantido aberto reconcilia as threads: novas
+ * ganham descritores, as que sumiram são fechadas. Depois, dois pread por
+ * thread. Com 'delta' != NULL, soma o avanço de cada thread desde a base.
+ * -1 se não sobrou nenhuma thread (processo terminou).
+ */
+static int atualizar_threads_sched(cpu_sched_t *s, proc_sched_t *delta) {
+    for (size_t k = 0; k < s->num; k++) s->threads[k].visto = 0;
+    size_t conhecidas = s->num;
+
+    rewinddir(s->dir);
+    struct dirent *ent;
+    while ((ent = readdir(s->dir)) != NULL) {
+        char *fim;
+        long tid = strtol(ent->d_name, &fim, 10);
+        if (*fim != '\0' || tid <= 0) continue;
+
+        cpu_sched_thread_t chave;
+        chave.tid = (pid_t)tid;
+        cpu_sched_thread_t *t = conhecidas == 0 ? NULL
+                              : (cpu_sched_thread_t *)bsearch(&chave, s->threads, conhecidas,
+                                                              sizeof(cpu_sched_thread_t), comparar_tid_sched);
+        if (t) {
+            t->visto = 1;
+            continue;
+        }
+
+        if (s->num == s->cap) {
+            size_t cap = s->cap ? s->cap * 2 : 16;
+            cpu_sched_thread_t *novo = (cpu_sched_thread_t *)realloc(s->threads, cap * sizeof(*novo));
+            if (!novo) break;
+            s->threads = novo;
+            s->cap     = cap;
+        }
+        t = &s->threads[s->num++];
+        memset(t, 0, sizeof(*t));
+        t->tid          = (pid_t)tid;
+        t->fd_schedstat = t->fd_status = -1;
+        t->visto        = 1;
+        t->com_base     = 1;  // thread nova: a base é zero, tudo é do intervalo
+    }
+
+    if (delta) memset(delta, 0, sizeof(*delta));
+    s->sem_fd = 0;
+    size_t j = 0;
+    for (size_t k = 0; k < s->num; k++) {
+        cpu_sched_thread_t *t = &s->threads[k];
+        if (!t->visto) {
+            fechar_thread_sched(t);
+            continue;
+        }
+
+        proc_sched_t atual;
+        if (t->fd_schedstat < 0 && abrir_thread_sched(s, t) != 0) {
+            if (errno != EMFILE && errno != ENFILE) continue;  // a thread saiu após o readdir
+            t->com_base = 0;  // quando houver descritor, a primeira leitura só vira base
+            s->sem_fd++;
+            s->threads[j++] = *t;
+            continue;
+        }
+        if (ler_thread_sched(t, &atual) != 0) {
+            // ESRCH: a thread saiu; se o TID já voltou ao readdir, é uma thread nova
+            fechar_thread_sched(t);
+            memset(&t->v, 0, sizeof(t->v));
+            if (abrir_thread_sched(s, t) != 0 || ler_thread_sched(t, &atual) != 0) {
+                fechar_thread_sched(t);
+                continue;
+            }
+        }
+
+        if (delta && t->com_base) {
+            delta->run_ns               += avanco(atual.run_ns, t->v.run_ns);
+            delta->espera_ns            += avanco(atual.espera_ns, t->v.espera_ns);
+            delta->fatias               += avanco(atual.fatias, t->v.fatias);
+            delta->trocas_voluntarias   += avanco(atual.trocas_voluntarias, t->v.trocas_voluntarias);
+            delta->trocas_involuntarias += avanco(atual.trocas_involuntarias, t->v.trocas_involuntarias);
+        }
+        t->v        = atual;
+        t->com_base = 1;
+        s->threads[j++] = *t;
+    }
+    s->num = j;
+
+    if (s->num > conhecidas) qsort(s->threads, s->num, sizeof(cpu_sched_thread_t), comparar_tid_sched);
+    if (delta) delta->threads = (int)(s->num - (size_t)s->sem_fd);
+    return s->num > 0 ? 0 : -1;
+}
+
+int cpu_sched_iniciar(cpu_sched_t *s, pid_t pid) {
+    if (!s || pid <= 0) {
+        fprintf(stderr, "Erro: parâmetros inválidos em cpu_sched_iniciar\n");
+        return -1;
+    }
+    memset(s, 0, sizeof(*s));
+    s->pid = pid;
+
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/task", pid);
+    s->dir = opendir(caminho);
+    if (!s->dir || atualizar_threads_sched(s, NULL) != 0) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        cpu_sched_liberar(s);
+        return -1;
+    }
+    return 0;
+}
+
+int cpu_sched_delta(cpu_sched_t *s, proc_sched_t *delta) {
+    if (!s || !delta || !s->dir) {
+        fprintf(stderr, "Erro: ponteiro nulo em cpu_sched_delta\n");
+        return -1;
+    }
+    return atualizar_threads_sched(s, delta);
+}
+
+void cpu_sched_liberar(cpu_sched_t *s) {
+    if (!s) return;
+    for (size_t k = 0; k < s->num; k++) fechar_thread_sched(&s->threads[k]);
+    free(s->threads);
+    s->threads = NULL;
+    s->num = s->cap = 0;
+    if (s->dir) closedir(s->dir);
+    s->dir = NULL;
+}
+
 /* -------------------- Loop de monitoramento CSV -------------------- */
 
+/* Uma leitura de /proc/stat alimenta o agregado e o vetor por core */
+static int ler_stat_completo(cpu_times_t *sys, cpu_times_t *cores, int ncores) {
+    const char *buffer = proc_cache_ler_sistema(PROC_SIS_STAT, NULL);
+    if (!buffer) {
+        fprintf(stderr, "Erro ao ler /proc/stat: %s\n", strerror(errno));
+        return -1;
+    }
+    if (cpu_interpretar_stat_sistema(buffer, sys) != 0) return -1;
+    return cpu_interpretar_stat_por_core(buffer, cores, ncores) < 0 ? -1 : 0;
+}
+
+/* Uma linha do CSV, montada na amostragem e formatada na thread escritora */
+typedef struct {
+    long long real_ns;       // formatado na thread escritora
+    int    amostra;
+    int    ncores;
+    double cpu_processo;
+    double cpu_sistema;
+    int    com_sched;        // 0: colunas de espera/trocas vazias nesta linha
+    double espera_ms_s;      // pronto mas esperando CPU, ms por segundo (somado nas threads)
+    double espera_media_us;  // espera média por fatia de CPU
+    double trocas_vol_ps;
+    double trocas_invol_ps;
+    double cores[];          // ncores valores
+} registro_cpu_t;
+
+static void formatar_registro_cpu(FILE *saida, const void *registro, void *ctx) {
+    const registro_cpu_t *r = (const registro_cpu_t *)registro;
+    (void)ctx;
+    char ts[CARIMBO_TAM];
+    carimbo_formatar(r->real_ns, ts, sizeof(ts));
+    fprintf(saida, "%s,%d,%.2f,%.2f", ts, r->amostra, r->cpu_processo, r->cpu_sistema);
+    if (r->com_sched) {
+        fprintf(saida, ",%.3f,%.1f,%.1f,%.1f", r->espera_ms_s, r->espera_media_us,
+                r->trocas_vol_ps, r->trocas_invol_ps);
+    } else {
+        fprintf(saida, ",,,,");
+    }
+    for (int c = 0; c < r->ncores; c++) {
+        fprintf(saida, ",%.2f", r->cores[c]);
+    }
+    fprintf(saida, "\n");
+}
+
 int cpu_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
     if (pid <= 0) {
         fprintf(stderr, "PID inválido: %d\n", pid);
@@ -225,17 +554,45 @@ int cpu_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
     cpu_times_t sys_antes, sys_depois;
     proc_cpu_t  proc_antes, proc_depois;
 
-    if (cpu_ler_times_sistema(&sys_antes) != 0) {
+    int ncores = cpu_num_cores();
+    cpu_times_t *cores_antes  = (cpu_times_t *)calloc((size_t)ncores, sizeof(cpu_times_t));
+    cpu_times_t *cores_depois = (cpu_times_t *)calloc((size_t)ncores, sizeof(cpu_times_t));
+    if (!cores_antes || !cores_depois) {
+        perror("cpu_monitorar_pid_csv: calloc");
+        free(cores_antes);
+        free(cores_depois);
+        return -1;
+    }
+
+    if (ler_stat_completo(&sys_antes, cores_antes, ncores) != 0) {
         fprintf(stderr, "Falha na leitura inicial do sistema\n");
+        free(cores_antes);
+        free(cores_depois);
         return -1;
     }
-    if (cpu_ler_processo(pid, &proc_antes) != 0) {
+    // a origem é escolhida uma vez: todos os deltas do run vêm da mesma fonte
+    int origem = cpu_origem_processo(pid);
+    if (cpu_ler_processo_de(pid, origem, &proc_antes) != 0) {
         fprintf(stderr, "Processo %d não encontrado ou sem permissão\n", pid);
+        free(cores_antes);
+        free(cores_depois);
         return -1;
     }
-
-    // Cabeçalho do CSV
-    fprintf(saida, "timestamp,amostra,cpu_processo_percent,cpu_sistema_percent\n");
+    // espera na run queue e trocas de contexto por thread (schedstat do PID só cobre a principal)
+    cpu_sched_t sched;
+    proc_sched_t sched_delta;
+    int com_sched = cpu_sched_iniciar(&sched, pid) == 0;
+    if (!com_sched) fprintf(stderr, "Aviso: schedstat indisponível; colunas de espera ficam vazias\n");
+    long long sched_antes_ns = agendador_agora_ns();
+    alvo_registrar(pid);  // sem isso, processo_existe/alvo_estado não detectam reciclagem
+
+    // Cabeçalho do CSV (uma coluna por core após as colunas agregadas)
+    fprintf(saida, "timestamp,amostra,cpu_processo_percent,cpu_sistema_percent,"
+                   "cpu_wait_ms_s,cpu_wait_medio_us,voluntary_ctxsw_ps,nonvoluntary_ctxsw_ps");
+    for (int c = 0; c < ncores; c++) {
+        fprintf(saida, ",cpu%d_percent", c);
+    }
+    fprintf(saida, "\n");
     fflush(saida);
 
     if (saida != stdout) {
@@ -243,43 +600,162 @@ int cpu_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
                 pid, amostras, intervalo_ms);
     }
 
+    // a escrita fica em outra thread: um stdout lento não atrasa a próxima amostra
+    size_t tam_registro = sizeof(registro_cpu_t) + (size_t)ncores * sizeof(double);
+    registro_cpu_t *reg = (registro_cpu_t *)malloc(tam_registro);
+    escritor_t escritor;
+    if (!reg || escritor_iniciar(&escritor, saida, tam_registro, ESCRITOR_CAPACIDADE_PADRAO,
+                                 formatar_registro_cpu, NULL) != 0) {
+        free(reg);
+        free(cores_antes);
+        free(cores_depois);
+        cpu_sched_liberar(&sched);
+        alvo_remover(pid);
+        return -1;
+    }
+    reg->ncores = ncores;
+
+    // percentis do run inteiro com memória fixa (resumo no fim, em stderr)
+    quantil_t q_processo, q_sistema, q_espera, q_latencia;
+    // '&' e não '&&': todos são iniciados (e depois liberados) mesmo se um falhar
+    int com_percentis = (quantil_iniciar(&q_processo) == 0) & (quantil_iniciar(&q_sistema) == 0) &
+                        (quantil_iniciar(&q_espera) == 0) & (quantil_iniciar(&q_latencia) == 0);
+    alertas_t *alertas = alertas_padrao();
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    int coletadas = 0;
+    int sched_avisado = 0;
     for (int i = 0; i < amostras; i++) {
-        dormir_ms(intervalo_ms);
+        long long acordou = agendador_esperar(&ag);
 
-        if (cpu_ler_times_sistema(&sys_depois) != 0) {
+        if (ler_stat_completo(&sys_depois, cores_depois, ncores) != 0) {
             fprintf(stderr, "Falha ao ler /proc/stat na amostra %d\n", i);
-            return -1;
+            rc = -1;
+            break;
         }
-        if (cpu_ler_processo(pid, &proc_depois) != 0) {
-            fprintf(stderr, "Processo %d terminou durante o monitoramento (amostra %d)\n",
-                    pid, i);
-            return -1;
+        int falhou = cpu_ler_processo_de(pid, origem, &proc_depois) != 0;
+        // schedstat é complementar: uma falha só esvazia as colunas dela nesta amostra
+        int sched_ok = !falhou && com_sched && cpu_sched_delta(&sched, &sched_delta) == 0;
+        long long sched_depois_ns = agendador_agora_ns();
+
+        // consultado depois da leitura: uma amostra de um PID reciclado é descartada
+        alvo_estado_t estado = alvo_estado(pid);
+        if (estado == ALVO_ENCERRADO || estado == ALVO_RECICLADO) {
+            alvo_relatar_fim(pid, estado, i);
+            break;
         }
+        if (falhou) {
+            fprintf(stderr, "Falha ao ler processo %d (amostra %d)\n", pid, i);
+            rc = -1;
+            break;
+        }
+        coletadas++;
 
         double cpu_sistema  = cpu_calculo_percentual(&sys_antes, &sys_depois);
         double cpu_processo = cpu_calculo_percentual_processo(&proc_antes, &proc_depois,
                                                               &sys_antes, &sys_depois);
 
-        char ts[64];
-        obter_timestamp(ts, sizeof(ts));
-        fprintf(saida, "%s,%d,%.2f,%.2f\n", ts, i, cpu_processo, cpu_sistema);
-        fflush(saida);
+        carimbo_t quando;
+        carimbo_agora(&quando);
+        reg->real_ns      = quando.real_ns;
+        reg->amostra      = i;
+        reg->cpu_processo = cpu_processo;
+        reg->cpu_sistema  = cpu_sistema;
+
+        // taxas sobre o tempo real entre as leituras de schedstat, não sobre o intervalo nominal
+        double seg = (double)(sched_depois_ns - sched_antes_ns) / 1e9;
+        if (seg <= 0.0) seg = 1e-9;
+        sched_antes_ns = sched_depois_ns;
+        if (com_sched && !sched_ok && !sched_avisado) {
+            fprintf(stderr, "Aviso: falha ao ler schedstat do processo %d (amostra %d); "
+                            "colunas de espera ficam vazias\n", pid, i);
+            sched_avisado = 1;
+        } else if (sched_ok && sched.sem_fd > 0 && !sched_avisado) {
+            fprintf(stderr, "Aviso: %d thread(s) fora de espera/trocas (limite de descritores, "
+                            "ulimit -n)\n", sched.sem_fd);
+            sched_avisado = 1;
+        }
+        reg->com_sched = sched_ok;
+        if (sched_ok) {
+            reg->espera_ms_s     = (double)sched_delta.espera_ns / 1e6 / seg;
+            reg->espera_media_us = sched_delta.fatias > 0
+                                   ? (double)sched_delta.espera_ns / 1e3 / (double)sched_delta.fatias : 0.0;
+            reg->trocas_vol_ps   = (double)sched_delta.trocas_voluntarias / seg;
+            reg->trocas_invol_ps = (double)sched_delta.trocas_involuntarias / seg;
+        } else {
+            reg->espera_ms_s = reg->espera_media_us = reg->trocas_vol_ps = reg->trocas_invol_ps = 0.0;
+        }
+
+        quantil_registrar(&q_processo, cpu_processo);
+        quantil_registrar(&q_sistema, cpu_sistema);
+        if (sched_ok) quantil_registrar(&q_espera, reg->espera_ms_s);
+        quantil_registrar(&q_latencia, (quando.mono_ns - acordou) / 1000.0);
+        alertas_observar(alertas, pid, "cpu_processo_percent", quando.mono_ns, cpu_processo);
+        alertas_observar(alertas, pid, "cpu_sistema_percent",  quando.mono_ns, cpu_sistema);
+        if (sched_ok) {
+            alertas_observar(alertas, pid, "cpu_wait_ms_s", quando.mono_ns, reg->espera_ms_s);
+            alertas_observar(alertas, pid, "voluntary_ctxsw_ps", quando.mono_ns, reg->trocas_vol_ps);
+            alertas_observar(alertas, pid, "nonvoluntary_ctxsw_ps", quando.mono_ns, reg->trocas_invol_ps);
+        }
+
+        double maior_core = 0.0;
+        int    core_maior = 0;
+        for (int c = 0; c < ncores; c++) {
+            double pct = cpu_calculo_percentual(&cores_antes[c], &cores_depois[c]);
+            reg->cores[c] = pct;
+            if (pct > maior_core) {
+                maior_core = pct;
+                core_maior = c;
+            }
+        }
+        escritor_enviar(&escritor, reg);
 
         // Atualiza bases
         sys_antes  = sys_depois;
         proc_antes = proc_depois;
+        cpu_times_t *tmp = cores_antes;
+        cores_antes  = cores_depois;
+        cores_depois = tmp;
 
         // Feedback (sem poluir CSV se for stdout)
         if (saida != stdout && (amostras <= 10 || (i + 1) % 10 == 0)) {
-            fprintf(stderr, "Amostra %d/%d: processo=%.2f%%, sistema=%.2f%%\n",
-                    i + 1, amostras, cpu_processo, cpu_sistema);
+            fprintf(stderr, "Amostra %d/%d: processo=%.2f%%, sistema=%.2f%%, espera=%.1f ms/s, "
+                            "core mais ocupado=cpu%d (%.2f%%)\n",
+                    i + 1, amostras, cpu_processo, cpu_sistema, reg->espera_ms_s, core_maior, maior_core);
         }
     }
 
-    if (saida != stdout) {
-        fprintf(stderr, "Monitoramento de CPU concluído: %d amostras coletadas\n", amostras);
+    unsigned long descartados = escritor_encerrar(&escritor);
+    if (descartados > 0) {
+        fprintf(stderr, "Saída lenta: %lu amostras de CPU descartadas\n", descartados);
     }
-    return 0;
+    free(reg);
+    free(cores_antes);
+    free(cores_depois);
+    cpu_sched_liberar(&sched);
+    alvo_remover(pid);
+    if (rc == 0) {
+        agendador_relatar(&ag, "Monitoramento de CPU");
+        if (saida != stdout) {
+            fprintf(stderr, "Monitoramento de CPU concluído: %d amostras coletadas\n", coletadas);
+        }
+        if (com_percentis && q_processo.contagem > 0) {
+            fprintf(stderr, "Percentis de CPU (%llu amostras):\n", q_processo.contagem);
+            quantil_imprimir(stderr, &q_processo, "processo", "%");
+            quantil_imprimir(stderr, &q_sistema,  "sistema", "%");
+            if (q_espera.contagem > 0) quantil_imprimir(stderr, &q_espera, "espera", "ms/s");
+            quantil_imprimir(stderr, &q_latencia, "coleta", "µs");
+        }
+        alertas_relatar(alertas);
+    }
+    quantil_liberar(&q_processo);
+    quantil_liberar(&q_sistema);
+    quantil_liberar(&q_espera);
+    quantil_liberar(&q_latencia);
+    return rc;
 }
 
 /* -------------------- Uso instantâneo -------------------- */
@@ -299,14 +775,15 @@ double cpu_obter_uso_instantaneo(pid_t pid) {
             fprintf(stderr, "Falha na leitura inicial do sistema para uso instantâneo\n");
             return -1.0;
         }
-        if (cpu_ler_processo(pid, &monitor_state.proc_antes) != 0) {
+        monitor_state.origem = cpu_origem_processo(pid);
+        if (cpu_ler_processo_de(pid, monitor_state.origem, &monitor_state.proc_antes) != 0) {
             fprintf(stderr, "Falha na leitura inicial do processo %d para uso instantâneo\n", pid);
             return -1.0;
         }
         monitor_state.pid      = pid;
         monitor_state.iniciado = 1;
 
-        dormir_ms(100);  // pequena espera para formar delta
+        agendador_dormir_ms(100);  // pequena espera para formar delta
         fprintf(stderr, "Estado do monitor inicializado para PID %d\n", pid);
     }
 
@@ -314,7 +791,7 @@ double cpu_obter_uso_instantaneo(pid_t pid) {
         fprintf(stderr, "Falha na leitura do sistema para uso instantâneo\n");
         return -1.0;
     }
-    if (cpu_ler_processo(pid, &proc_depois) != 0) {
+    if (cpu_ler_processo_de(pid, monitor_state.origem, &proc_depois) != 0) {
         fprintf(stderr, "Processo %d não encontrado para uso instantâneo\n", pid);
         return -1.0;
     }
@@ -345,25 +822,49 @@ int cpu_gerar_relatorio(pid_t pid, FILE *out) {
     cpu_times_t sys_antes, sys_depois;
     proc_cpu_t proc_antes, proc_depois;
 
-    if (cpu_ler_times_sistema(&sys_antes) != 0) {
-        fprintf(stderr, "Falha ao ler tempos de CPU do sistema.\n");
+    int ncores = cpu_num_cores();
+    cpu_times_t *cores_antes  = (cpu_times_t *)calloc((size_t)ncores, sizeof(cpu_times_t));
+    cpu_times_t *cores_depois = (cpu_times_t *)calloc((size_t)ncores, sizeof(cpu_times_t));
+    if (!cores_antes || !cores_depois) {
+        perror("cpu_gerar_relatorio: calloc");
+        free(cores_antes);
+        free(cores_depois);
         return -1;
     }
 
-    if (cpu_ler_processo(pid, &proc_antes) != 0) {
-        fprintf(stderr, "Falha ao ler tempos de CPU do processo %d.\n", pid);
-        return -1;
-    }
+    cpu_sched_t sched;
+    proc_sched_t sched_delta;
+    int com_sched = 0;
+    long long sched_ns = 0;
 
-    dormir_ms(500);
+    int rc = -1;
+    int origem = cpu_origem_processo(pid);
+    if (ler_stat_completo(&sys_antes, cores_antes, ncores) != 0) {
+        fprintf(stderr, "Falha ao ler tempos de CPU do sistema.\n");
+    } else if (cpu_ler_processo_de(pid, origem, &proc_antes) != 0) {
+        fprintf(stderr, "Falha ao ler tempos de CPU do processo %d.\n", pid);
+    } else {
+        com_sched = cpu_sched_iniciar(&sched, pid) == 0;
+        sched_ns  = agendador_agora_ns();
+        agendador_dormir_ms(500);
+        if (com_sched) {
+            com_sched = cpu_sched_delta(&sched, &sched_delta) == 0;
+            sched_ns  = agendador_agora_ns() - sched_ns;
+            cpu_sched_liberar(&sched);
+        }
 
-    if (cpu_ler_times_sistema(&sys_depois) != 0) {
-        fprintf(stderr, "Falha ao ler tempos de CPU do sistema (segunda leitura).\n");
-        return -1;
+        if (ler_stat_completo(&sys_depois, cores_depois, ncores) != 0) {
+            fprintf(stderr, "Falha ao ler tempos de CPU do sistema (segunda leitura).\n");
+        } else if (cpu_ler_processo_de(pid, origem, &proc_depois) != 0) {
+            fprintf(stderr, "Processo %d terminou durante a medição.\n", pid);
+        } else {
+            rc = 0;
+        }
     }
 
-    if (cpu_ler_processo(pid, &proc_depois) != 0) {
-        fprintf(stderr, "Processo %d terminou durante a medição.\n", pid);
+    if (rc != 0) {
+        free(cores_antes);
+        free(cores_depois);
         return -1;
     }
 
@@ -371,8 +872,13 @@ int cpu_gerar_relatorio(pid_t pid, FILE *out) {
     double cpu_processo = cpu_calculo_percentual_processo(&proc_antes, &proc_depois,
                                                           &sys_antes, &sys_depois);
 
-    char ts[64];
-    obter_timestamp(ts, sizeof(ts));
+    char ts[CARIMBO_TAM];
+    carimbo_t quando;
+    carimbo_texto_agora(ts, sizeof(ts), &quando);
+
+    // relatórios repetidos do mesmo PID formam a série usada na linha de tendência
+    historico_t *hist = hist_padrao();
+    hist_registrar(hist, pid, "cpu_percent", quando.real_ns, cpu_processo);
 
     fprintf(out,
             "============================================================\n"
@@ -382,19 +888,39 @@ int cpu_gerar_relatorio(pid_t pid, FILE *out) {
             "  Timestamp      : %s\n"
             "------------------------------------------------------------\n"
             "  Uso de CPU do processo : %6.2f %%\n"
-            "  Uso de CPU do sistema  : %6.2f %%\n"
-            "============================================================\n\n",
+            "  Uso de CPU do sistema  : %6.2f %%\n",
             pid, ts, cpu_processo, cpu_sistema);
+    if (com_sched && sched_ns > 0) {
+        double seg = (double)sched_ns / 1e9;
+        fprintf(out,
+                "  Espera na run queue    : %6.1f ms/s (%.1f µs por fatia, %d threads)\n"
+                "  Trocas de contexto     : %6.1f/s voluntárias, %.1f/s involuntárias\n",
+                (double)sched_delta.espera_ns / 1e6 / seg,
+                sched_delta.fatias > 0 ? (double)sched_delta.espera_ns / 1e3 / (double)sched_delta.fatias : 0.0,
+                sched_delta.threads,
+                (double)sched_delta.trocas_voluntarias / seg, (double)sched_delta.trocas_involuntarias / seg);
+    }
+    hist_imprimir_tendencia(out, hist, pid, "cpu_percent", "CPU", "%");
+    fprintf(out,
+            "------------------------------------------------------------\n"
+            "  Uso por core:\n");
 
-    return 0;
-}
-
-
-
-
-
+    // Barra de 40 colunas: um core saturado se destaca da carga espalhada
+    for (int c = 0; c < ncores; c++) {
+        double pct = cpu_calculo_percentual(&cores_antes[c], &cores_depois[c]);
+        int cheio = (int)(pct * 40.0 / 100.0 + 0.5);
+        if (cheio > 40) cheio = 40;
 
+        fprintf(out, "  cpu%-4d %6.2f %% |", c, pct);
+        for (int k = 0; k < 40; k++) fputc(k < cheio ? '#' : ' ', out);
+        fprintf(out, "|\n");
+    }
+    fprintf(out, "============================================================\n\n");
 
+    free(cores_antes);
+    free(cores_depois);
+    return 0;
+}
 
 /* -------------------- Estado & utilitários -------------------- */
 
@@ -408,7 +934,16 @@ void cpu_resetar_estado(void) {
 
 int processo_existe(pid_t pid) {
     if (pid <= 0) return 0;
+
+    // PID registrado: o pidfd responde sem tocar no /proc e detecta reciclagem
+    alvo_estado_t estado = alvo_estado(pid);
+    if (estado != ALVO_DESCONHECIDO) return estado == ALVO_VIVO;
+
     char caminho[64];
     snprintf(caminho, sizeof(caminho), "/proc/%d", pid);
-    return access(caminho, F_OK) == 0;
+    if (access(caminho, F_OK) == 0) return 1;
+
+    proc_cache_invalidar(pid);  // libera descritores de um PID que sumiu
+    hist_remover_alvo(hist_padrao(), pid);  // um PID reciclado não herda a tendência
+    return 0;
 }
\ No newline at end of file
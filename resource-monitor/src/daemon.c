@@ -0,0 +1,1144 @@
+// daemon.c - amostragem contínua de vários alvos com API de consulta em socket Unix
+#define _GNU_SOURCE  // accept4, SOCK_CLOEXEC, SOCK_NONBLOCK, MSG_NOSIGNAL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "../include/daemon.h"
+#include "../include/sampler.h"
+#include "../include/targets.h"
+#include "../include/timeseries.h"
+#include "../include/quantile.h"
+#include "../include/alerts.h"
+#include "../include/timestamp.h"
+#include "../include/scheduler.h"
+#include "../include/openmetrics.h"
+#include "../include/cgroup.h"
+
+/* Métricas com histórico e percentis (nomes das colunas do 'all') */
+enum {
+    M_CPU_PROCESSO = 0,
+    M_CPU_SISTEMA,
+    M_RSS,
+    M_MEM_PERCENT,
+    M_LEITURA,
+    M_ESCRITA,
+    NUM_METRICAS
+};
+static const char *const NOMES_METRICAS[NUM_METRICAS] = {
+    "cpu_processo_percent", "cpu_sistema_percent", "rss_kb",
+    "proc_mem_percent", "read_bps", "write_bps",
+};
+
+typedef struct {
+    pid_t              pid;
+    char               comm[32];
+    char               cgroup[256];       // lido no add; "" = raiz
+    int                intervalo_ms;
+    long long          proximo_ns;        // próximo prazo (CLOCK_MONOTONIC)
+    sampler_snapshot_t antes;             // base do delta, mantida entre consultas
+    sampler_metricas_t metricas;
+    int                tem_metricas;
+    unsigned long      amostras;
+    unsigned long      prazos_perdidos;
+    quantil_t          quantis[NUM_METRICAS];
+    alertas_t          alertas;           // cópia das regras globais, com estado próprio
+} daemon_alvo_t;
+
+typedef struct {
+    int           fd;
+    char          entrada[DAEMON_LINHA_MAX];
+    size_t        tam_entrada;
+    char         *saida;                  // DAEMON_SAIDA_CAP bytes
+    size_t        tam_saida;
+    int           assinante;
+    pid_t         filtro;                 // 0 = todos os alvos
+    unsigned long descartadas;            // linhas de stream que não couberam
+    int           fechar;
+} daemon_cliente_t;
+
+typedef struct {
+    int              escuta;
+    daemon_alvo_t    alvos[DAEMON_ALVOS_MAX];
+    int              num_alvos;
+    daemon_cliente_t clientes[DAEMON_CLIENTES_MAX];
+    int              num_clientes;
+    historico_t      hist;
+    int              escuta_http;         // -1 sem --metricas
+    om_conexao_t     http[DAEMON_HTTP_MAX];
+    int              num_http;
+    om_texto_t       om;
+    om_pagina_t     *pagina;
+    int              pagina_suja;
+    psi_gatilho_t    gatilhos[DAEMON_GATILHOS_MAX];
+    int              gatilho_fd[DAEMON_GATILHOS_MAX];   // -1 depois de POLLERR (cgroup removido)
+    unsigned long    disparos[DAEMON_GATILHOS_MAX];
+    int              num_gatilhos;
+    int              parar;
+} daemon_t;
+
+static volatile sig_atomic_t sinal_parar = 0;
+
+static void tratar_sinal(int sig) {
+    (void)sig;
+    sinal_parar = 1;
+}
+
+/* ==================== TEXTO DAS RESPOSTAS ==================== */
+
+typedef struct {
+    char   *buf;
+    size_t  cap;
+    size_t  tam;
+    int     estouro;
+} texto_t;
+
+static void texto_add(texto_t *t, const char *fmt, ...) {
+    if (t->estouro) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(t->buf + t->tam, t->cap - t->tam, fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= t->cap - t->tam) t->estouro = 1;
+    else t->tam += (size_t)n;
+}
+
+static texto_t texto_do_cliente(daemon_cliente_t *c) {
+    texto_t t = { c->saida, DAEMON_SAIDA_CAP, c->tam_saida, 0 };
+    return t;
+}
+
+/* Confirma a linha montada; resposta que não cabe vira erro, stream é descartado */
+static void concluir(daemon_cliente_t *c, texto_t *t, int stream) {
+    if (!t->estouro) {
+        c->tam_saida = t->tam;
+        return;
+    }
+    if (stream) {
+        c->descartadas++;
+        return;
+    }
+    texto_t erro = texto_do_cliente(c);
+    texto_add(&erro, "{\"ok\":false,\"erro\":\"resposta não coube no buffer do cliente\"}\n");
+    if (erro.estouro) c->fechar = 1;
+    else c->tam_saida = erro.tam;
+}
+
+static void responder_erro(daemon_cliente_t *c, const char *msg) {
+    texto_t t = texto_do_cliente(c);
+    texto_add(&t, "{\"ok\":false,\"erro\":\"%s\"}\n", msg);
+    concluir(c, &t, 0);
+}
+
+static void responder_ok(daemon_cliente_t *c) {
+    texto_t t = texto_do_cliente(c);
+    texto_add(&t, "{\"ok\":true}\n");
+    concluir(c, &t, 0);
+}
+
+static void valores_metricas(const daemon_alvo_t *a, double v[NUM_METRICAS]) {
+    v[M_CPU_PROCESSO] = a->metricas.cpu_processo_percent;
+    v[M_CPU_SISTEMA]  = a->metricas.cpu_sistema_percent;
+    v[M_RSS]          = (double)a->antes.mem_processo.rss_kb;
+    v[M_MEM_PERCENT]  = a->metricas.mem_processo_percent;
+    v[M_LEITURA]      = (double)a->metricas.io_taxas.read_bytes;
+    v[M_ESCRITA]      = (double)a->metricas.io_taxas.write_bytes;
+}
+
+/* Texto livre dentro de uma string JSON: aspas, barra invertida e controles escapados */
+static void json_escapar(const char *src, char *dst, size_t tam) {
+    size_t j = 0;
+    for (const unsigned char *c = (const unsigned char *)src; *c && j + 7 < tam; c++) {
+        if (*c == '"' || *c == '\\') {
+            dst[j++] = '\\';
+            dst[j++] = (char)*c;
+        } else if (*c < 0x20) {
+            j += (size_t)snprintf(dst + j, tam - j, "\\u%04x", *c);
+        } else {
+            dst[j++] = (char)*c;
+        }
+    }
+    if (tam > 0) dst[j] = '\0';
+}
+
+/* Campos da última amostra: as mesmas colunas do comando 'all' */
+static void json_amostra(texto_t *t, const daemon_alvo_t *a) {
+    const sampler_snapshot_t *s = &a->antes;
+    const sampler_metricas_t *m = &a->metricas;
+    char ts[CARIMBO_TAM];
+    carimbo_formatar(s->real_ns, ts, sizeof(ts));
+    texto_add(t,
+              "\"pid\":%d,\"timestamp\":\"%s\",\"amostra\":%lu,"
+              "\"cpu_processo_percent\":%.2f,\"cpu_sistema_percent\":%.2f,"
+              "\"rss_kb\":%llu,\"vsz_kb\":%llu,\"shared_kb\":%llu,\"swap_kb\":%llu,"
+              "\"minor_faults\":%llu,\"major_faults\":%llu,\"proc_mem_percent\":%.2f,"
+              "\"read_bps\":%llu,\"write_bps\":%llu,\"read_syscalls_ps\":%llu,"
+              "\"write_syscalls_ps\":%llu,\"disk_ops_ps\":%llu",
+              a->pid, ts, a->amostras,
+              m->cpu_processo_percent, m->cpu_sistema_percent,
+              s->mem_processo.rss_kb, s->mem_processo.vsz_kb,
+              s->mem_processo.shared_kb, s->mem_processo.swap_kb,
+              s->mem_processo.minor_faults, s->mem_processo.major_faults,
+              m->mem_processo_percent,
+              m->io_taxas.read_bytes, m->io_taxas.write_bytes,
+              m->io_taxas.read_syscalls, m->io_taxas.write_syscalls,
+              m->io_taxas.disk_operations);
+}
+
+/* ==================== ALVOS ==================== */
+
+static daemon_alvo_t *buscar_alvo(daemon_t *d, pid_t pid, int *idx) {
+    for (int k = 0; k < d->num_alvos; k++) {
+        if (d->alvos[k].pid == pid) {
+            if (idx) *idx = k;
+            return &d->alvos[k];
+        }
+    }
+    return NULL;
+}
+
+static void difundir_fim(daemon_t *d, pid_t pid, const char *motivo) {
+    for (int k = 0; k < d->num_clientes; k++) {
+        daemon_cliente_t *c = &d->clientes[k];
+        if (!c->assinante || (c->filtro && c->filtro != pid)) continue;
+        texto_t t = texto_do_cliente(c);
+        texto_add(&t, "{\"evento\":\"fim\",\"pid\":%d,\"motivo\":\"%s\"}\n", pid, motivo);
+        concluir(c, &t, 1);
+    }
+}
+
+static void remover_alvo(daemon_t *d, int idx, const char *motivo) {
+    daemon_alvo_t *a = &d->alvos[idx];
+    pid_t pid = a->pid;
+
+    alvo_remover(pid);
+    hist_remover_alvo(&d->hist, pid);
+    for (int m = 0; m < NUM_METRICAS; m++) quantil_liberar(&a->quantis[m]);
+    alertas_destruir(&a->alertas);
+
+    d->alvos[idx] = d->alvos[--d->num_alvos];
+    d->pagina_suja = 1;
+    if (motivo) {
+        fprintf(stderr, "daemon: alvo %d removido (%s)\n", pid, motivo);
+        difundir_fim(d, pid, motivo);
+    }
+}
+
+static void ler_comm(pid_t pid, char *out, size_t tam) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/comm", pid);
+    FILE *f = fopen(caminho, "r");
+    out[0] = '\0';
+    if (f) {
+        if (fgets(out, (int)tam, f)) out[strcspn(out, "\n")] = '\0';
+        fclose(f);
+    }
+}
+
+static const char *adicionar_alvo(daemon_t *d, pid_t pid, int intervalo_ms) {
+    if (pid <= 0 || intervalo_ms < 1) return "pid ou intervalo inválido";
+    if (buscar_alvo(d, pid, NULL)) return "alvo já monitorado";
+    if (d->num_alvos >= DAEMON_ALVOS_MAX) return "limite de alvos atingido";
+    if (alvo_registrar(pid) != 0) return "processo não existe";
+
+    daemon_alvo_t *a = &d->alvos[d->num_alvos];
+    memset(a, 0, sizeof(*a));
+    if (sampler_coletar(pid, &a->antes) != 0) {
+        alvo_remover(pid);
+        return "processo não pôde ser lido";
+    }
+    for (int m = 0; m < NUM_METRICAS; m++) {
+        if (quantil_iniciar(&a->quantis[m]) != 0) {
+            for (int k = 0; k < m; k++) quantil_liberar(&a->quantis[k]);
+            alvo_remover(pid);
+            return "sem memória";
+        }
+    }
+    // regras de --alerta/--alertas valem para cada alvo, com estado separado
+    const alertas_t *globais = alertas_padrao();
+    for (size_t r = 0; r < globais->num; r++) {
+        alertas_adicionar(&a->alertas, globais->regras[r].texto);
+    }
+
+    a->pid          = pid;
+    a->intervalo_ms = intervalo_ms;
+    ler_comm(pid, a->comm, sizeof(a->comm));
+    if (cgroup_do_processo(pid, a->cgroup, sizeof(a->cgroup)) != 0) a->cgroup[0] = '\0';
+    a->proximo_ns   = agendador_agora_ns() + (long long)intervalo_ms * 1000000LL;
+    d->num_alvos++;
+    d->pagina_suja = 1;
+    fprintf(stderr, "daemon: alvo %d adicionado (intervalo %d ms)\n", pid, intervalo_ms);
+    return NULL;
+}
+
+static void amostrar(daemon_t *d, int idx) {
+    daemon_alvo_t *a = &d->alvos[idx];
+    sampler_snapshot_t depois;
+
+    int falhou = sampler_coletar(a->pid, &depois) != 0;
+    alvo_estado_t estado = alvo_estado(a->pid);
+    if (estado == ALVO_RECICLADO) {
+        remover_alvo(d, idx, "reciclado");
+        return;
+    }
+    if (falhou || estado == ALVO_ENCERRADO) {
+        remover_alvo(d, idx, "encerrado");
+        return;
+    }
+    if (sampler_calcular(&a->antes, &depois, &a->metricas) != 0) return;
+
+    a->antes        = depois;
+    a->tem_metricas = 1;
+    a->amostras++;
+    d->pagina_suja  = 1;
+
+    double v[NUM_METRICAS];
+    valores_metricas(a, v);
+    for (int m = 0; m < NUM_METRICAS; m++) {
+        hist_registrar(&d->hist, a->pid, NOMES_METRICAS[m], depois.real_ns, v[m]);
+        quantil_registrar(&a->quantis[m], v[m]);
+    }
+    sampler_observar_alertas(&a->alertas, &depois, &a->metricas);
+
+    for (int k = 0; k < d->num_clientes; k++) {
+        daemon_cliente_t *c = &d->clientes[k];
+        if (!c->assinante || (c->filtro && c->filtro != a->pid)) continue;
+        texto_t t = texto_do_cliente(c);
+        texto_add(&t, "{\"evento\":\"amostra\",");
+        json_amostra(&t, a);
+        texto_add(&t, "}\n");
+        concluir(c, &t, 1);
+    }
+}
+
+/* ==================== COMANDOS ==================== */
+
+static int ler_inteiro(const char *s, long min, long max, long *out) {
+    if (!s) return -1;
+    char *fim;
+    errno = 0;
+    long v = strtol(s, &fim, 10);
+    if (errno || *fim != '\0' || fim == s || v < min || v > max) return -1;
+    *out = v;
+    return 0;
+}
+
+static daemon_alvo_t *alvo_do_argumento(daemon_t *d, daemon_cliente_t *c, const char *arg) {
+    long pid;
+    if (ler_inteiro(arg, 1, 0x7fffffff, &pid) != 0) {
+        responder_erro(c, "pid inválido");
+        return NULL;
+    }
+    daemon_alvo_t *a = buscar_alvo(d, (pid_t)pid, NULL);
+    if (!a) responder_erro(c, "alvo não monitorado");
+    return a;
+}
+
+static void cmd_history(daemon_t *d, daemon_cliente_t *c, char *args[], int n) {
+    static hist_ponto_t pontos[HIST_CAP_1MIN + 1];  // thread única
+
+    daemon_alvo_t *a = alvo_do_argumento(d, c, n > 1 ? args[1] : NULL);
+    if (!a) return;
+    if (n < 3) {
+        responder_erro(c, "uso: history <pid> <metrica> [bruto|10s|1min] [max]");
+        return;
+    }
+    int m;
+    for (m = 0; m < NUM_METRICAS; m++) {
+        if (strcmp(args[2], NOMES_METRICAS[m]) == 0) break;
+    }
+    if (m == NUM_METRICAS) {
+        responder_erro(c, "métrica sem histórico (cpu_processo_percent, cpu_sistema_percent, "
+                          "rss_kb, proc_mem_percent, read_bps, write_bps)");
+        return;
+    }
+
+    static const char *const NIVEIS[HIST_NUM_NIVEIS] = { "bruto", "10s", "1min" };
+    int nivel = HIST_BRUTO;
+    if (n > 3) {
+        for (nivel = 0; nivel < HIST_NUM_NIVEIS; nivel++) {
+            if (strcmp(args[3], NIVEIS[nivel]) == 0) break;
+        }
+        if (nivel == HIST_NUM_NIVEIS) {
+            responder_erro(c, "nível deve ser bruto, 10s ou 1min");
+            return;
+        }
+    }
+    long max = 60;
+    if (n > 4 && ler_inteiro(args[4], 1, HIST_CAP_1MIN + 1, &max) != 0) {
+        responder_erro(c, "max inválido");
+        return;
+    }
+
+    size_t num = hist_consultar(&d->hist, a->pid, NOMES_METRICAS[m], (hist_nivel_t)nivel, 0,
+                                pontos, (size_t)max);
+    texto_t t = texto_do_cliente(c);
+    texto_add(&t, "{\"ok\":true,\"pid\":%d,\"metrica\":\"%s\",\"nivel\":\"%s\",\"pontos\":[",
+              a->pid, NOMES_METRICAS[m], NIVEIS[nivel]);
+    for (size_t k = 0; k < num; k++) {
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(pontos[k].inicio_ns, ts, sizeof(ts));
+        texto_add(&t, "%s{\"timestamp\":\"%s\",\"min\":%.2f,\"media\":%.2f,\"max\":%.2f,"
+                      "\"ultimo\":%.2f,\"n\":%u}",
+                  k ? "," : "", ts, pontos[k].min, hist_media(&pontos[k]), pontos[k].max,
+                  pontos[k].ultimo, pontos[k].contagem);
+    }
+    texto_add(&t, "]}\n");
+    concluir(c, &t, 0);
+}
+
+static void cmd_percentiles(daemon_cliente_t *c, const daemon_alvo_t *a) {
+    texto_t t = texto_do_cliente(c);
+    texto_add(&t, "{\"ok\":true,\"pid\":%d,\"amostras\":%lu", a->pid, a->amostras);
+    for (int m = 0; m < NUM_METRICAS; m++) {
+        const quantil_t *q = &a->quantis[m];
+        texto_add(&t, ",\"%s\":{\"min\":%.2f,\"p50\":%.2f,\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f}",
+                  NOMES_METRICAS[m], quantil_valor(q, 0.0), quantil_valor(q, 0.50),
+                  quantil_valor(q, 0.90), quantil_valor(q, 0.99), quantil_valor(q, 1.0));
+    }
+    texto_add(&t, "}\n");
+    concluir(c, &t, 0);
+}
+
+static void executar_comando(daemon_t *d, daemon_cliente_t *c, char *linha) {
+    char *args[8];
+    int n = 0;
+    char *salvo = NULL;
+    for (char *tok = strtok_r(linha, " \t\r", &salvo); tok && n < 8;
+         tok = strtok_r(NULL, " \t\r", &salvo)) {
+        args[n++] = tok;
+    }
+    if (n == 0) return;
+    const char *cmd = args[0];
+
+    if (strcmp(cmd, "add") == 0) {
+        long pid, ms = DAEMON_INTERVALO_PADRAO;
+        if (n < 2 || ler_inteiro(args[1], 1, 0x7fffffff, &pid) != 0 ||
+            (n > 2 && ler_inteiro(args[2], 1, 3600000, &ms) != 0)) {
+            responder_erro(c, "uso: add <pid> [intervalo_ms]");
+            return;
+        }
+        const char *erro = adicionar_alvo(d, (pid_t)pid, (int)ms);
+        if (erro) responder_erro(c, erro);
+        else      responder_ok(c);
+    } else if (strcmp(cmd, "remove") == 0) {
+        daemon_alvo_t *a = alvo_do_argumento(d, c, n > 1 ? args[1] : NULL);
+        if (!a) return;
+        remover_alvo(d, (int)(a - d->alvos), "removido");
+        responder_ok(c);
+    } else if (strcmp(cmd, "interval") == 0) {
+        daemon_alvo_t *a = alvo_do_argumento(d, c, n > 1 ? args[1] : NULL);
+        if (!a) return;
+        long ms;
+        if (n < 3 || ler_inteiro(args[2], 1, 3600000, &ms) != 0) {
+            responder_erro(c, "uso: interval <pid> <intervalo_ms>");
+            return;
+        }
+        a->intervalo_ms = (int)ms;
+        a->proximo_ns   = agendador_agora_ns() + ms * 1000000LL;
+        responder_ok(c);
+    } else if (strcmp(cmd, "list") == 0) {
+        texto_t t = texto_do_cliente(c);
+        texto_add(&t, "{\"ok\":true,\"alvos\":[");
+        for (int k = 0; k < d->num_alvos; k++) {
+            const daemon_alvo_t *a = &d->alvos[k];
+            texto_add(&t, "%s{\"pid\":%d,\"intervalo_ms\":%d,\"amostras\":%lu,\"prazos_perdidos\":%lu}",
+                      k ? "," : "", a->pid, a->intervalo_ms, a->amostras, a->prazos_perdidos);
+        }
+        texto_add(&t, "]}\n");
+        concluir(c, &t, 0);
+    } else if (strcmp(cmd, "latest") == 0) {
+        daemon_alvo_t *a = alvo_do_argumento(d, c, n > 1 ? args[1] : NULL);
+        if (!a) return;
+        if (!a->tem_metricas) {
+            responder_erro(c, "ainda sem amostra");
+            return;
+        }
+        texto_t t = texto_do_cliente(c);
+        texto_add(&t, "{\"ok\":true,");
+        json_amostra(&t, a);
+        texto_add(&t, "}\n");
+        concluir(c, &t, 0);
+    } else if (strcmp(cmd, "history") == 0) {
+        cmd_history(d, c, args, n);
+    } else if (strcmp(cmd, "percentiles") == 0) {
+        daemon_alvo_t *a = alvo_do_argumento(d, c, n > 1 ? args[1] : NULL);
+        if (a) cmd_percentiles(c, a);
+    } else if (strcmp(cmd, "subscribe") == 0) {
+        long pid = 0;
+        if (n > 1 && ler_inteiro(args[1], 1, 0x7fffffff, &pid) != 0) {
+            responder_erro(c, "uso: subscribe [pid]");
+            return;
+        }
+        c->assinante = 1;
+        c->filtro    = (pid_t)pid;
+        responder_ok(c);
+    } else if (strcmp(cmd, "unsubscribe") == 0) {
+        c->assinante = 0;
+        responder_ok(c);
+    } else if (strcmp(cmd, "shutdown") == 0) {
+        d->parar = 1;
+        responder_ok(c);
+    } else {
+        responder_erro(c, "comando desconhecido (add, remove, interval, list, latest, history, "
+                          "percentiles, subscribe, unsubscribe, shutdown)");
+    }
+}
+
+/* ==================== CLIENTES ==================== */
+
+static void cliente_descarregar(daemon_cliente_t *c) {
+    size_t feito = 0;
+    while (feito < c->tam_saida) {
+        ssize_t n = send(c->fd, c->saida + feito, c->tam_saida - feito, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) c->fechar = 1;
+            break;
+        }
+        feito += (size_t)n;
+    }
+    memmove(c->saida, c->saida + feito, c->tam_saida - feito);
+    c->tam_saida -= feito;
+}
+
+static void cliente_ler(daemon_t *d, daemon_cliente_t *c) {
+    for (;;) {
+        ssize_t n = recv(c->fd, c->entrada + c->tam_entrada,
+                         sizeof(c->entrada) - 1 - c->tam_entrada, 0);
+        if (n == 0) {
+            c->fechar = 1;
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) c->fechar = 1;
+            return;
+        }
+        c->tam_entrada += (size_t)n;
+        c->entrada[c->tam_entrada] = '\0';
+
+        char *inicio = c->entrada, *nl;
+        while ((nl = strchr(inicio, '\n')) != NULL) {
+            *nl = '\0';
+            executar_comando(d, c, inicio);
+            inicio = nl + 1;
+        }
+        size_t resto = c->tam_entrada - (size_t)(inicio - c->entrada);
+        memmove(c->entrada, inicio, resto + 1);
+        c->tam_entrada = resto;
+
+        if (c->tam_entrada >= sizeof(c->entrada) - 1) {
+            responder_erro(c, "linha longa demais");
+            c->fechar = 1;
+            return;
+        }
+    }
+}
+
+static void aceitar_cliente(daemon_t *d) {
+    int fd = accept4(d->escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    char *saida = d->num_clientes < DAEMON_CLIENTES_MAX ? (char *)malloc(DAEMON_SAIDA_CAP) : NULL;
+    if (!saida) {
+        static const char CHEIO[] = "{\"ok\":false,\"erro\":\"limite de clientes atingido\"}\n";
+        ssize_t ignorado = send(fd, CHEIO, sizeof(CHEIO) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+        (void)ignorado;  // a conexão é fechada de qualquer forma
+        close(fd);
+        return;
+    }
+    daemon_cliente_t *c = &d->clientes[d->num_clientes++];
+    memset(c, 0, sizeof(*c));
+    c->fd    = fd;
+    c->saida = saida;
+}
+
+static void remover_cliente(daemon_t *d, int idx) {
+    daemon_cliente_t *c = &d->clientes[idx];
+    if (c->descartadas > 0) {
+        fprintf(stderr, "daemon: cliente lento perdeu %lu linha(s) do stream\n", c->descartadas);
+    }
+    close(c->fd);
+    free(c->saida);
+    d->clientes[idx] = d->clientes[--d->num_clientes];
+}
+
+/* ==================== MÉTRICAS (OPENMETRICS) ==================== */
+
+#define OM_PREFIXO "resource_monitor_"
+
+static void rotulos_alvo(const daemon_alvo_t *a, const char *extra, char *out, size_t tam) {
+    char comm[2 * sizeof(a->comm)];
+    om_escapar(a->comm, comm, sizeof(comm));
+    snprintf(out, tam, "pid=\"%d\",comm=\"%s\"%s%s", a->pid, comm, extra ? "," : "", extra ? extra : "");
+}
+
+static void metricas_processos(daemon_t *d, om_texto_t *t, double hz) {
+    char r[OM_ROTULO_MAX];
+
+    om_familia(t, OM_PREFIXO "process_cpu_seconds", "counter", "Tempo de CPU do processo (user/system).");
+    for (int k = 0; k < d->num_alvos; k++) {
+        const daemon_alvo_t *a = &d->alvos[k];
+        rotulos_alvo(a, "mode=\"user\"", r, sizeof(r));
+        om_valor(t, OM_PREFIXO "process_cpu_seconds_total", r, (double)a->antes.cpu_processo.utime / hz);
+        rotulos_alvo(a, "mode=\"system\"", r, sizeof(r));
+        om_valor(t, OM_PREFIXO "process_cpu_seconds_total", r, (double)a->antes.cpu_processo.stime / hz);
+    }
+
+    om_familia(t, OM_PREFIXO "process_cpu_percent", "gauge",
+               "CPU do processo no último intervalo (% da máquina, como cpu_processo_percent).");
+    for (int k = 0; k < d->num_alvos; k++) {
+        const daemon_alvo_t *a = &d->alvos[k];
+        if (!a->tem_metricas) continue;
+        rotulos_alvo(a, NULL, r, sizeof(r));
+        om_valor(t, OM_PREFIXO "process_cpu_percent", r, a->metricas.cpu_processo_percent);
+    }
+
+    om_familia(t, OM_PREFIXO "process_memory_bytes", "gauge", "Memória do processo por tipo.");
+    for (int k = 0; k < d->num_alvos; k++) {
+        const daemon_alvo_t *a = &d->alvos[k];
+        const mem_proc_stats_t *m = &a->antes.mem_processo;
+        static const char *const TIPOS[] = { "type=\"rss\"", "type=\"vsz\"", "type=\"shared\"", "type=\"swap\"" };
+        const unsigned long long kb[] = { m->rss_kb, m->vsz_kb, m->shared_kb, m->swap_kb };
+        for (int j = 0; j < 4; j++) {
+            rotulos_alvo(a, TIPOS[j], r, sizeof(r));
+            om_inteiro(t, OM_PREFIXO "process_memory_bytes", r, kb[j] * 1024ULL);
+        }
+    }
+
+    om_familia(t, OM_PREFIXO "process_page_faults", "counter", "Page faults do processo.");
+    for (int k = 0; k < d->num_alvos; k++) {
+        const daemon_alvo_t *a = &d->alvos[k];
+        rotulos_alvo(a, "type=\"minor\"", r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_page_faults_total", r, a->antes.mem_processo.minor_faults);
+        rotulos_alvo(a, "type=\"major\"", r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_page_faults_total", r, a->antes.mem_processo.major_faults);
+    }
+
+    om_familia(t, OM_PREFIXO "process_io_bytes", "counter",
+               "Bytes lidos/escritos pelo processo (/proc/<pid>/io; ausente sem permissão).");
+    for (int k = 0; k < d->num_alvos; k++) {
+        const daemon_alvo_t *a = &d->alvos[k];
+        if (!a->antes.io_disponivel) continue;
+        rotulos_alvo(a, "direction=\"read\"", r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_io_bytes_total", r, a->antes.io_processo.read_bytes);
+        rotulos_alvo(a, "direction=\"write\"", r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_io_bytes_total", r, a->antes.io_processo.write_bytes);
+    }
+
+    om_familia(t, OM_PREFIXO "process_samples", "counter", "Amostras coletadas pelo daemon.");
+    for (int k = 0; k < d->num_alvos; k++) {
+        rotulos_alvo(&d->alvos[k], NULL, r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_samples_total", r, d->alvos[k].amostras);
+    }
+
+    om_familia(t, OM_PREFIXO "process_missed_deadlines", "counter", "Ticks pulados por atraso.");
+    for (int k = 0; k < d->num_alvos; k++) {
+        rotulos_alvo(&d->alvos[k], NULL, r, sizeof(r));
+        om_inteiro(t, OM_PREFIXO "process_missed_deadlines_total", r, d->alvos[k].prazos_perdidos);
+    }
+}
+
+/* Um bloco por cgroup distinto entre os alvos (lidos aqui, uma vez por tick) */
+static void metricas_cgroups(daemon_t *d, om_texto_t *t) {
+    cgroup_metrics_t cg[DAEMON_ALVOS_MAX];
+    const char      *nomes[DAEMON_ALVOS_MAX];
+    int              num = 0;
+
+    for (int k = 0; k < d->num_alvos; k++) {
+        const char *nome = d->alvos[k].cgroup;
+        int j;
+        for (j = 0; j < num && strcmp(nomes[j], nome) != 0; j++) {}
+        if (j < num) continue;
+        nomes[num] = nome;
+        cgroup_ler_metricas_completas(nome, &cg[num]);
+        num++;
+    }
+
+    char r[OM_ROTULO_MAX], nome[OM_ROTULO_MAX - 64];  // folga para os demais rótulos (direction, resource/kind)
+    om_familia(t, OM_PREFIXO "cgroup_cpu_seconds", "counter", "Tempo de CPU do cgroup dos alvos.");
+    for (int j = 0; j < num; j++) {
+        om_escapar(nomes[j], nome, sizeof(nome));
+        snprintf(r, sizeof(r), "cgroup=\"/%s\"", nome);
+        om_valor(t, OM_PREFIXO "cgroup_cpu_seconds_total", r, (double)cg[j].cpu_usage / 1e9);
+    }
+    om_familia(t, OM_PREFIXO "cgroup_memory_bytes", "gauge", "Memória em uso pelo cgroup.");
+    for (int j = 0; j < num; j++) {
+        om_escapar(nomes[j], nome, sizeof(nome));
+        snprintf(r, sizeof(r), "cgroup=\"/%s\"", nome);
+        om_inteiro(t, OM_PREFIXO "cgroup_memory_bytes", r, cg[j].memory_usage);
+    }
+    om_familia(t, OM_PREFIXO "cgroup_memory_limit_bytes", "gauge", "Limite de memória do cgroup (ausente sem limite).");
+    for (int j = 0; j < num; j++) {
+        if (cg[j].memory_limit == 0 || cg[j].memory_limit >= (1ULL << 60)) continue;  // v1 usa ~2^63 como "sem limite"
+        om_escapar(nomes[j], nome, sizeof(nome));
+        snprintf(r, sizeof(r), "cgroup=\"/%s\"", nome);
+        om_inteiro(t, OM_PREFIXO "cgroup_memory_limit_bytes", r, cg[j].memory_limit);
+    }
+    om_familia(t, OM_PREFIXO "cgroup_io_bytes", "counter", "Bytes lidos/escritos em disco pelo cgroup.");
+    for (int j = 0; j < num; j++) {
+        om_escapar(nomes[j], nome, sizeof(nome));
+        snprintf(r, sizeof(r), "cgroup=\"/%s\",direction=\"read\"", nome);
+        om_inteiro(t, OM_PREFIXO "cgroup_io_bytes_total", r, cg[j].io_read_bytes);
+        snprintf(r, sizeof(r), "cgroup=\"/%s\",direction=\"write\"", nome);
+        om_inteiro(t, OM_PREFIXO "cgroup_io_bytes_total", r, cg[j].io_write_bytes);
+    }
+    om_familia(t, OM_PREFIXO "cgroup_pressure_stall_seconds", "counter",
+               "Tempo com tarefas do cgroup paradas por recurso (PSI; ausente fora da árvore v2).");
+    for (int j = 0; j < num; j++) {
+        om_escapar(nomes[j], nome, sizeof(nome));
+        for (int p = 0; p < PSI_NUM_RECURSOS; p++) {
+            if (!(cg[j].pressao_lida & (1U << p))) continue;
+            const psi_t *ps = &cg[j].pressao[p];
+            const char *rec = psi_nome_recurso((psi_recurso_t)p);
+            snprintf(r, sizeof(r), "cgroup=\"/%s\",resource=\"%s\",kind=\"some\"", nome, rec);
+            om_valor(t, OM_PREFIXO "cgroup_pressure_stall_seconds_total", r, (double)ps->some.total_us / 1e6);
+            if (!ps->tem_full) continue;
+            snprintf(r, sizeof(r), "cgroup=\"/%s\",resource=\"%s\",kind=\"full\"", nome, rec);
+            om_valor(t, OM_PREFIXO "cgroup_pressure_stall_seconds_total", r, (double)ps->full.total_us / 1e6);
+        }
+    }
+}
+
+/* /proc/stat e /proc/meminfo da amostra mais recente: nenhuma leitura extra */
+static void metricas_sistema(daemon_t *d, om_texto_t *t, double hz) {
+    const sampler_snapshot_t *s = NULL;
+    for (int k = 0; k < d->num_alvos; k++) {
+        if (!s || d->alvos[k].antes.mono_ns > s->mono_ns) s = &d->alvos[k].antes;
+    }
+
+    om_familia(t, OM_PREFIXO "daemon_targets", "gauge", "Alvos monitorados pelo daemon.");
+    om_inteiro(t, OM_PREFIXO "daemon_targets", NULL, (unsigned long long)d->num_alvos);
+
+    om_familia(t, OM_PREFIXO "system_cpu_seconds", "counter", "Tempo de CPU da máquina por modo (/proc/stat).");
+    if (s) {
+        static const char *const MODOS[] = {
+            "mode=\"user\"", "mode=\"nice\"", "mode=\"system\"", "mode=\"idle\"",
+            "mode=\"iowait\"", "mode=\"irq\"", "mode=\"softirq\"", "mode=\"steal\"",
+        };
+        const cpu_times_t *c = &s->cpu_sistema;
+        const unsigned long long v[] = { c->user, c->nice, c->system, c->idle,
+                                         c->iowait, c->irq, c->softirq, c->steal };
+        for (int j = 0; j < 8; j++) {
+            om_valor(t, OM_PREFIXO "system_cpu_seconds_total", MODOS[j], (double)v[j] / hz);
+        }
+    }
+
+    om_familia(t, OM_PREFIXO "system_memory_bytes", "gauge", "Memória da máquina (/proc/meminfo).");
+    if (s) {
+        static const char *const TIPOS[] = {
+            "type=\"total\"", "type=\"free\"", "type=\"available\"", "type=\"buffers\"",
+            "type=\"cached\"", "type=\"swap_total\"", "type=\"swap_free\"",
+        };
+        const mem_sys_stats_t *m = &s->mem_sistema;
+        const unsigned long long kb[] = { m->mem_total_kb, m->mem_free_kb, m->mem_available_kb,
+                                          m->buffers_kb, m->cached_kb, m->swap_total_kb, m->swap_free_kb };
+        for (int j = 0; j < 7; j++) {
+            om_inteiro(t, OM_PREFIXO "system_memory_bytes", TIPOS[j], kb[j] * 1024ULL);
+        }
+    }
+
+    // três pread de descritores já abertos (proc_cache), como /proc/stat
+    om_familia(t, OM_PREFIXO "system_pressure_stall_seconds", "counter",
+               "Tempo com tarefas paradas por recurso (/proc/pressure).");
+    for (int p = 0; p < PSI_NUM_RECURSOS; p++) {
+        psi_t ps;
+        if (psi_ler_sistema((psi_recurso_t)p, &ps) != 0) continue;
+        char r[64];
+        const char *rec = psi_nome_recurso((psi_recurso_t)p);
+        snprintf(r, sizeof(r), "resource=\"%s\",kind=\"some\"", rec);
+        om_valor(t, OM_PREFIXO "system_pressure_stall_seconds_total", r, (double)ps.some.total_us / 1e6);
+        if (!ps.tem_full) continue;
+        snprintf(r, sizeof(r), "resource=\"%s\",kind=\"full\"", rec);
+        om_valor(t, OM_PREFIXO "system_pressure_stall_seconds_total", r, (double)ps.full.total_us / 1e6);
+    }
+
+    om_familia(t, OM_PREFIXO "daemon_pressure_triggers", "counter", "Disparos de cada gatilho PSI (--psi).");
+    for (int k = 0; k < d->num_gatilhos; k++) {
+        char desc[PSI_CGROUP_MAX + 48], esc[2 * sizeof(desc)], r[sizeof(esc) + 16];
+        psi_gatilho_descrever(&d->gatilhos[k], desc, sizeof(desc));
+        om_escapar(desc, esc, sizeof(esc));
+        snprintf(r, sizeof(r), "trigger=\"%s\"", esc);
+        om_inteiro(t, OM_PREFIXO "daemon_pressure_triggers_total", r, d->disparos[k]);
+    }
+}
+
+/* Remonta a página uma vez por tick; os scrapes só copiam a página pronta */
+static void publicar_metricas(daemon_t *d) {
+    static double hz = 0.0;
+    if (hz <= 0.0) {
+        long v = sysconf(_SC_CLK_TCK);
+        hz = v > 0 ? (double)v : 100.0;
+    }
+
+    metricas_sistema(d, &d->om, hz);
+    metricas_processos(d, &d->om, hz);
+    metricas_cgroups(d, &d->om);
+
+    om_pagina_t *nova = om_publicar(&d->om);
+    if (!nova) {
+        fprintf(stderr, "daemon: sem memória para a página de métricas (mantida a anterior)\n");
+        return;
+    }
+    om_pagina_soltar(d->pagina);  // conexões que ainda enviam a antiga seguram a sua referência
+    d->pagina      = nova;
+    d->pagina_suja = 0;
+}
+
+/* Mantém a ordem de chegada: a posição 0 é sempre a conexão mais antiga */
+static void remover_http(daemon_t *d, int idx) {
+    om_conexao_fechar(&d->http[idx]);
+    memmove(&d->http[idx], &d->http[idx + 1], (size_t)(d->num_http - idx - 1) * sizeof(d->http[0]));
+    d->num_http--;
+}
+
+static void aceitar_http(daemon_t *d) {
+    int fd = accept4(d->escuta_http, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+    if (d->num_http >= DAEMON_HTTP_MAX) remover_http(d, 0);  // sem vaga: sai a mais antiga
+
+    om_conexao_t *c = &d->http[d->num_http++];
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+}
+
+static void atender_http(daemon_t *d, int idx, short revents) {
+    om_conexao_t *c = &d->http[idx];
+    int rc = 0;
+    if (!c->respondendo && (revents & (POLLIN | POLLHUP | POLLERR))) {
+        rc = om_conexao_ler(c, d->pagina);
+    }
+    if (rc >= 0 && c->respondendo) rc = om_conexao_escrever(c);
+    if (rc != 0) remover_http(d, idx);
+}
+
+/* ==================== SOCKET E LOOP ==================== */
+
+static int montar_endereco(const char *caminho, struct sockaddr_un *end) {
+    memset(end, 0, sizeof(*end));
+    end->sun_family = AF_UNIX;
+    size_t tam = strlen(caminho);
+    if (tam == 0 || tam >= sizeof(end->sun_path)) {
+        fprintf(stderr, "Caminho de socket inválido ou longo demais: %s\n", caminho);
+        return -1;
+    }
+    memcpy(end->sun_path, caminho, tam + 1);
+    return 0;
+}
+
+static int abrir_escuta(const char *caminho) {
+    struct sockaddr_un end;
+    if (montar_endereco(caminho, &end) != 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        perror("daemon: socket");
+        return -1;
+    }
+
+    mode_t antiga = umask(077);  // só o dono conversa com o daemon
+    int rc = bind(fd, (struct sockaddr *)&end, sizeof(end));
+    if (rc != 0 && errno == EADDRINUSE) {
+        // socket de um daemon que morreu: só é removido se ninguém atende
+        int teste = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int vivo  = teste >= 0 && connect(teste, (struct sockaddr *)&end, sizeof(end)) == 0;
+        if (teste >= 0) close(teste);
+        if (vivo) {
+            umask(antiga);
+            fprintf(stderr, "Já existe um daemon atendendo em %s\n", caminho);
+            close(fd);
+            return -1;
+        }
+        unlink(caminho);
+        rc = bind(fd, (struct sockaddr *)&end, sizeof(end));
+    }
+    umask(antiga);
+
+    if (rc != 0 || listen(fd, 16) != 0) {
+        fprintf(stderr, "Falha ao abrir o socket %s: %s\n", caminho, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Gatilho PSI disparou: amostra todos os alvos agora (fora da grade) e avisa os assinantes */
+static void pressao_disparou(daemon_t *d, int g) {
+    char desc[PSI_CGROUP_MAX + 48];
+    psi_gatilho_descrever(&d->gatilhos[g], desc, sizeof(desc));
+    psi_t p;
+    memset(&p, 0, sizeof(p));
+    psi_gatilho_ler(&d->gatilhos[g], &p);
+    d->disparos[g]++;
+    d->pagina_suja = 1;
+    fprintf(stderr, "daemon: pressão '%s' (some avg10=%.2f%%, full avg10=%.2f%%)\n",
+            desc, p.some.avg10, p.full.avg10);
+
+    // os prazos não mudam: o tick seguinte mede só o que veio depois do disparo
+    for (int k = d->num_alvos - 1; k >= 0; k--) amostrar(d, k);
+
+    char esc[6 * sizeof(desc)];  // o caminho do cgroup é texto livre
+    json_escapar(desc, esc, sizeof(esc));
+
+    for (int k = 0; k < d->num_clientes; k++) {
+        daemon_cliente_t *c = &d->clientes[k];
+        if (!c->assinante) continue;
+        texto_t t = texto_do_cliente(c);
+        texto_add(&t, "{\"evento\":\"pressao\",\"gatilho\":\"%s\",\"some_avg10\":%.2f,"
+                      "\"full_avg10\":%.2f,\"disparos\":%lu}\n",
+                  esc, p.some.avg10, p.full.avg10, d->disparos[g]);
+        concluir(c, &t, 1);
+    }
+}
+
+/* Amostra os alvos vencidos e devolve o timeout do poll (ms, -1 sem alvos) */
+static int atender_prazos(daemon_t *d) {
+    long long agora = agendador_agora_ns();
+    // de trás para frente: remover um alvo move o último (já atendido) para o lugar dele
+    for (int k = d->num_alvos - 1; k >= 0; k--) {
+        daemon_alvo_t *a = &d->alvos[k];
+        if (agora < a->proximo_ns) continue;
+        long long periodo = (long long)a->intervalo_ms * 1000000LL;
+        a->proximo_ns += periodo;
+        if (a->proximo_ns <= agora) {
+            // atraso de mais de um período: pula para a grade seguinte em vez de rajada
+            a->prazos_perdidos++;
+            a->proximo_ns = agora + periodo;
+        }
+        amostrar(d, k);
+    }
+
+    int timeout = -1;
+    agora = agendador_agora_ns();
+    for (int k = 0; k < d->num_alvos; k++) {
+        long long resta = d->alvos[k].proximo_ns - agora;
+        int ms = resta <= 0 ? 0 : (int)((resta + 999999LL) / 1000000LL);
+        if (timeout < 0 || ms < timeout) timeout = ms;
+    }
+    return timeout;
+}
+
+static void fechar_gatilhos(daemon_t *d) {
+    for (int k = 0; k < d->num_gatilhos; k++) {
+        if (d->gatilho_fd[k] >= 0) close(d->gatilho_fd[k]);  // desfaz o registro no kernel
+    }
+    d->num_gatilhos = 0;
+}
+
+int daemon_executar(const char *caminho, const char *metricas,
+                    const pid_t *pids, const int *intervalos, int num_alvos,
+                    const psi_gatilho_t *gatilhos, int num_gatilhos) {
+    if (!caminho) caminho = DAEMON_SOCKET_PADRAO;
+    if (num_gatilhos > DAEMON_GATILHOS_MAX) {
+        fprintf(stderr, "daemon: no máximo %d gatilhos PSI\n", DAEMON_GATILHOS_MAX);
+        return -1;
+    }
+
+    daemon_t *d = (daemon_t *)calloc(1, sizeof(*d));
+    if (!d) {
+        fprintf(stderr, "daemon: sem memória\n");
+        return -1;
+    }
+    if (hist_iniciar(&d->hist, DAEMON_ALVOS_MAX * NUM_METRICAS) != 0) {
+        free(d);
+        return -1;
+    }
+    int gatilhos_ok = 1;
+    for (int k = 0; k < num_gatilhos && gatilhos_ok; k++) {
+        d->gatilhos[k]   = gatilhos[k];
+        d->gatilho_fd[k] = psi_gatilho_abrir(&gatilhos[k]);
+        gatilhos_ok      = d->gatilho_fd[k] >= 0;
+        d->num_gatilhos  = k + 1;
+    }
+    d->escuta      = gatilhos_ok ? abrir_escuta(caminho) : -1;
+    d->escuta_http = gatilhos_ok && metricas ? om_abrir_escuta(metricas) : -1;
+    if (d->escuta < 0 || (metricas && d->escuta_http < 0)) {
+        if (d->escuta >= 0) {
+            close(d->escuta);
+            unlink(caminho);
+        }
+        fechar_gatilhos(d);
+        hist_destruir(&d->hist);
+        free(d);
+        return -1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = tratar_sinal;  // sem SA_RESTART: o poll volta com EINTR
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+
+    for (int k = 0; k < num_alvos; k++) {
+        const char *erro = adicionar_alvo(d, pids[k], intervalos[k]);
+        if (erro) fprintf(stderr, "daemon: alvo %d ignorado: %s\n", pids[k], erro);
+    }
+    fprintf(stderr, "daemon: atendendo em %s (%d alvo(s))\n", caminho, d->num_alvos);
+    if (metricas) {
+        fprintf(stderr, "daemon: métricas OpenMetrics em %s%s\n", metricas, OM_CAMINHO);
+        d->pagina_suja = 1;
+    }
+    for (int k = 0; k < d->num_gatilhos; k++) {
+        char desc[PSI_CGROUP_MAX + 48];
+        psi_gatilho_descrever(&d->gatilhos[k], desc, sizeof(desc));
+        fprintf(stderr, "daemon: gatilho PSI '%s'\n", desc);
+    }
+
+    struct pollfd fds[2 + DAEMON_GATILHOS_MAX + DAEMON_CLIENTES_MAX + DAEMON_HTTP_MAX + DAEMON_ALVOS_MAX];
+    pid_t         pid_do_fd[DAEMON_ALVOS_MAX];
+
+    while (!d->parar && !sinal_parar) {
+        int timeout = atender_prazos(d);
+        if (d->escuta_http >= 0 && d->pagina_suja) publicar_metricas(d);
+
+        int n = 0;
+        fds[n].fd = d->escuta;
+        fds[n].events = POLLIN;
+        n++;
+        fds[n].fd = d->escuta_http;  // fd negativo é ignorado pelo poll
+        fds[n].events = POLLIN;
+        n++;
+        int base_gatilhos = n;
+        for (int k = 0; k < d->num_gatilhos; k++, n++) {
+            fds[n].fd     = d->gatilho_fd[k];
+            fds[n].events = POLLPRI;
+        }
+        int base_http = n;
+        for (int k = 0; k < d->num_http; k++, n++) {
+            fds[n].fd     = d->http[k].fd;
+            fds[n].events = d->http[k].respondendo ? POLLOUT : POLLIN;
+        }
+        int base_clientes = n;
+        for (int k = 0; k < d->num_clientes; k++, n++) {
+            fds[n].fd     = d->clientes[k].fd;
+            fds[n].events = (short)(POLLIN | (d->clientes[k].tam_saida ? POLLOUT : 0));
+        }
+        int base_alvos = n;
+        for (int k = 0; k < d->num_alvos; k++) {
+            int pfd = alvo_fd(d->alvos[k].pid);  // término na hora, sem esperar o tick
+            if (pfd < 0) continue;
+            pid_do_fd[n - base_alvos] = d->alvos[k].pid;
+            fds[n].fd     = pfd;
+            fds[n].events = POLLIN;
+            n++;
+        }
+        for (int k = 0; k < n; k++) fds[k].revents = 0;
+
+        if (poll(fds, (nfds_t)n, timeout) < 0) {
+            if (errno == EINTR) continue;
+            perror("daemon: poll");
+            break;
+        }
+
+        for (int k = 0; k < d->num_gatilhos; k++) {
+            short rev = fds[base_gatilhos + k].revents;
+            if (rev & POLLERR) {
+                fprintf(stderr, "daemon: gatilho PSI %d encerrado (cgroup removido)\n", k);
+                close(d->gatilho_fd[k]);
+                d->gatilho_fd[k] = -1;
+            } else if (rev & POLLPRI) {
+                pressao_disparou(d, k);
+            }
+        }
+
+        int num_clientes = d->num_clientes;
+        for (int k = num_clientes - 1; k >= 0; k--) {
+            if (fds[base_clientes + k].revents & (POLLIN | POLLHUP | POLLERR)) {
+                cliente_ler(d, &d->clientes[k]);
+            }
+        }
+        for (int k = d->num_http - 1; k >= 0; k--) {
+            if (fds[base_http + k].revents) atender_http(d, k, fds[base_http + k].revents);
+        }
+        for (int k = base_alvos; k < n; k++) {
+            int idx;
+            if ((fds[k].revents & POLLIN) && buscar_alvo(d, pid_do_fd[k - base_alvos], &idx)) {
+                remover_alvo(d, idx, "encerrado");
+            }
+        }
+        for (int k = d->num_clientes - 1; k >= 0; k--) {
+            daemon_cliente_t *c = &d->clientes[k];
+            if (c->tam_saida) cliente_descarregar(c);
+            if (c->fechar) remover_cliente(d, k);
+        }
+        if (fds[0].revents & POLLIN) aceitar_cliente(d);
+        if (fds[1].revents & POLLIN) aceitar_http(d);
+    }
+
+    fprintf(stderr, "daemon: encerrando\n");
+    for (int k = d->num_clientes - 1; k >= 0; k--) {
+        cliente_descarregar(&d->clientes[k]);
+        remover_cliente(d, k);
+    }
+    while (d->num_alvos > 0) remover_alvo(d, d->num_alvos - 1, NULL);
+    while (d->num_http > 0) remover_http(d, d->num_http - 1);
+    if (d->escuta_http >= 0) {
+        close(d->escuta_http);
+        if (metricas[0] == '/') unlink(metricas);
+    }
+    fechar_gatilhos(d);
+    om_pagina_soltar(d->pagina);
+    om_texto_liberar(&d->om);
+    close(d->escuta);
+    unlink(caminho);
+    hist_destruir(&d->hist);
+    free(d);
+    return 0;
+}
+
+/* ==================== CLIENTE DE LINHA DE COMANDO ==================== */
+
+int daemon_enviar(const char *caminho, const char *comando) {
+    struct sockaddr_un end;
+    if (!caminho) caminho = DAEMON_SOCKET_PADRAO;
+    if (!comando || montar_endereco(caminho, &end) != 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&end, sizeof(end)) != 0) {
+        fprintf(stderr, "Nenhum daemon em %s: %s\n", caminho, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    FILE *conexao = fdopen(fd, "r+");
+    if (!conexao) {
+        close(fd);
+        return -1;
+    }
+    fprintf(conexao, "%s\n", comando);
+    fflush(conexao);
+
+    char  *linha = NULL;
+    size_t cap   = 0;
+    int    rc    = -1;
+    if (getline(&linha, &cap, conexao) > 0) {
+        fputs(linha, stdout);
+        rc = strstr(linha, "\"ok\":true") ? 0 : -1;
+        // subscribe: o stream segue até o daemon fechar a conexão (ou Ctrl+C)
+        if (rc == 0 && strncmp(comando, "subscribe", 9) == 0) {
+            fflush(stdout);
+            while (getline(&linha, &cap, conexao) > 0) {
+                fputs(linha, stdout);
+                fflush(stdout);
+            }
+        }
+    } else {
+        fprintf(stderr, "O daemon fechou a conexão sem responder\n");
+    }
+    free(linha);
+    fclose(conexao);
+    return rc;
+}
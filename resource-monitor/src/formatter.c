@@ -0,0 +1,282 @@
+// formatter.c - saída CSV/JSON Lines com conversores próprios e buffer reutilizado
+#define _GNU_SOURCE  // CLOCK_MONOTONIC_COARSE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../include/formatter.h"
+
+#define CAP_MINIMA     4096
+#define CASAS_MAX      9
+#define VALOR_MAX      48     // maior valor numérico formatado (com sinal, ponto e separador)
+
+static saida_formato_t formato_padrao = SAIDA_CSV;
+
+static const unsigned long long POT10[CASAS_MAX + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+
+/* ==================== RELÓGIO E ESCRITA ==================== */
+
+static long long agora_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    // resolução de ms basta para decidir o flush, e custa menos que o relógio fino
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int saida_descarregar(saida_t *s) {
+    if (!s || !s->buf) return -1;
+
+    size_t feito = 0;
+    while (feito < s->tam) {
+        ssize_t n = write(s->fd, s->buf + feito, s->tam - feito);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (!s->erro) s->erro = errno;
+            break;  // descarta o buffer: não há para onde escrever
+        }
+        feito += (size_t)n;
+        s->chamadas_write++;
+    }
+    s->bytes_escritos  += feito;
+    s->tam              = 0;
+    s->ultimo_flush_ns  = agora_ns();
+    return s->erro ? -1 : 0;
+}
+
+/* Garante 'n' bytes livres no buffer (n <= cap) */
+static void reservar(saida_t *s, size_t n) {
+    if (s->tam + n > s->cap) saida_descarregar(s);
+}
+
+static void por(saida_t *s, const char *dados, size_t n) {
+    reservar(s, n);
+    memcpy(s->buf + s->tam, dados, n);
+    s->tam += n;
+}
+
+/* ==================== CONVERSORES ==================== */
+
+/* Dígitos de 'v' em 'p'; retorna quantos */
+static size_t formatar_uint(char *p, unsigned long long v) {
+    char tmp[20];
+    size_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (size_t k = 0; k < n; k++) p[k] = tmp[n - 1 - k];
+    return n;
+}
+
+static size_t formatar_fixo(char *p, double v, int casas, int json) {
+    if (v != v || v - v != 0) {
+        // NaN ou infinito: JSON não tem representação; CSV segue o printf
+        const char *t = json ? "null" : (v != v ? "nan" : (v > 0 ? "inf" : "-inf"));
+        size_t n = strlen(t);
+        memcpy(p, t, n);
+        return n;
+    }
+
+    int negativo = signbit(v) != 0;  // -0.0 e negativos que arredondam para 0 saem "-0.00", como no printf
+    double escalado = (negativo ? -v : v) * (double)POT10[casas];
+    if (escalado >= 1.8e19) {
+        // fora do alcance de 64 bits: caminho lento, raro
+        return (size_t)snprintf(p, VALOR_MAX, "%.*f", casas, v);
+    }
+
+    unsigned long long r = (unsigned long long)escalado;
+    double resto = escalado - (double)r;
+    if (resto == 0.5) {
+        // empate aparente: a multiplicação pode ter arredondado (0.005 * 100); o printf decide
+        return (size_t)snprintf(p, VALOR_MAX, "%.*f", casas, v);
+    }
+    if (resto > 0.5) r++;
+    size_t n = 0;
+    if (negativo) p[n++] = '-';
+    n += formatar_uint(p + n, r / POT10[casas]);
+    if (casas > 0) {
+        unsigned long long frac = r % POT10[casas];
+        p[n++] = '.';
+        for (int k = casas - 1; k >= 0; k--) {
+            p[n + (size_t)k] = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+        n += (size_t)casas;
+    }
+    return n;
+}
+
+/* ==================== CAMPOS ==================== */
+
+/* Separador (e nome, no JSON) do próximo campo; NULL se a linha já tem todos os campos */
+static const saida_campo_t *abrir_campo(saida_t *s) {
+    if (!s || !s->buf || s->campo_atual >= s->num_campos) return NULL;
+    const saida_campo_t *c = &s->campos[s->campo_atual];
+
+    if (s->formato == SAIDA_JSONL) {
+        size_t tam_nome = strlen(c->nome);
+        reservar(s, tam_nome + 4);
+        s->buf[s->tam++] = s->campo_atual == 0 ? '{' : ',';
+        s->buf[s->tam++] = '"';
+        memcpy(s->buf + s->tam, c->nome, tam_nome);
+        s->tam += tam_nome;
+        s->buf[s->tam++] = '"';
+        s->buf[s->tam++] = ':';
+    } else if (s->campo_atual > 0) {
+        reservar(s, 1);
+        s->buf[s->tam++] = ',';
+    }
+    s->campo_atual++;
+    return c;
+}
+
+void saida_texto(saida_t *s, const char *valor) {
+    if (!abrir_campo(s)) return;
+    if (!valor) valor = "";
+    int json = s->formato == SAIDA_JSONL;
+
+    if (json) por(s, "\"", 1);
+    for (const unsigned char *c = (const unsigned char *)valor; *c; c++) {
+        reservar(s, 6);
+        if (!json) {
+            s->buf[s->tam++] = (*c == ',' || *c == '"' || *c == '\n' || *c == '\r') ? '_' : (char)*c;
+        } else if (*c == '"' || *c == '\\') {
+            s->buf[s->tam++] = '\\';
+            s->buf[s->tam++] = (char)*c;
+        } else if (*c < 0x20) {
+            static const char HEX[] = "0123456789abcdef";
+            memcpy(s->buf + s->tam, "\\u00", 4);
+            s->buf[s->tam + 4] = HEX[*c >> 4];
+            s->buf[s->tam + 5] = HEX[*c & 0xf];
+            s->tam += 6;
+        } else {
+            s->buf[s->tam++] = (char)*c;
+        }
+    }
+    if (json) por(s, "\"", 1);
+}
+
+void saida_uint(saida_t *s, unsigned long long valor) {
+    if (!abrir_campo(s)) return;
+    reservar(s, VALOR_MAX);
+    s->tam += formatar_uint(s->buf + s->tam, valor);
+}
+
+void saida_int(saida_t *s, long long valor) {
+    if (!abrir_campo(s)) return;
+    reservar(s, VALOR_MAX);
+    unsigned long long u = (unsigned long long)valor;
+    if (valor < 0) {
+        s->buf[s->tam++] = '-';
+        u = 0 - u;
+    }
+    s->tam += formatar_uint(s->buf + s->tam, u);
+}
+
+void saida_fixo(saida_t *s, double valor) {
+    const saida_campo_t *c = abrir_campo(s);
+    if (!c) return;
+    int casas = c->casas < 0 ? 0 : (c->casas > CASAS_MAX ? CASAS_MAX : c->casas);
+    reservar(s, VALOR_MAX);
+    s->tam += formatar_fixo(s->buf + s->tam, valor, casas, s->formato == SAIDA_JSONL);
+}
+
+void saida_nulo(saida_t *s) {
+    if (!abrir_campo(s)) return;
+    if (s->formato == SAIDA_JSONL) por(s, "null", 4);
+}
+
+void saida_fim_linha(saida_t *s) {
+    if (!s || !s->buf) return;
+    if (s->formato == SAIDA_JSONL) {
+        por(s, s->campo_atual ? "}\n" : "{}\n", s->campo_atual ? 2 : 3);
+    } else {
+        por(s, "\n", 1);
+    }
+    s->campo_atual = 0;
+
+    if (s->tam >= s->cap / 4 * 3 ||
+        (s->intervalo_ns > 0 && agora_ns() - s->ultimo_flush_ns >= s->intervalo_ns)) {
+        saida_descarregar(s);
+    }
+}
+
+void saida_cabecalho(saida_t *s) {
+    if (!s || !s->buf || s->formato != SAIDA_CSV) return;
+    for (size_t k = 0; k < s->num_campos; k++) {
+        if (k) por(s, ",", 1);
+        por(s, s->campos[k].nome, strlen(s->campos[k].nome));
+    }
+    por(s, "\n", 1);
+    saida_descarregar(s);
+}
+
+/* ==================== CICLO DE VIDA ==================== */
+
+int saida_abrir(saida_t *s, int fd, saida_formato_t formato,
+                const saida_campo_t *campos, size_t num_campos,
+                size_t cap_buf, int intervalo_ms) {
+    if (!s || fd < 0 || !campos || num_campos == 0) return -1;
+    memset(s, 0, sizeof(*s));
+
+    if (cap_buf == 0) cap_buf = SAIDA_BUF_PADRAO;
+    if (cap_buf < CAP_MINIMA) cap_buf = CAP_MINIMA;
+    if (intervalo_ms < 0) intervalo_ms = SAIDA_FLUSH_PADRAO_MS;
+
+    s->buf = (char *)malloc(cap_buf);
+    if (!s->buf) {
+        fprintf(stderr, "saida_abrir: sem memória (%zu bytes)\n", cap_buf);
+        return -1;
+    }
+    s->cap             = cap_buf;
+    s->fd              = fd;
+    s->formato         = formato;
+    s->campos          = campos;
+    s->num_campos      = num_campos;
+    s->intervalo_ns    = (long long)intervalo_ms * 1000000LL;
+    s->ultimo_flush_ns = agora_ns();
+    return 0;
+}
+
+int saida_fechar(saida_t *s) {
+    if (!s || !s->buf) return -1;
+    saida_descarregar(s);
+    free(s->buf);
+    s->buf = NULL;
+    if (s->erro) {
+        fprintf(stderr, "Falha ao escrever a saída: %s\n", strerror(s->erro));
+        return -1;
+    }
+    return 0;
+}
+
+/* ==================== FORMATO PADRÃO ==================== */
+
+int saida_selecionar(const char *nome) {
+    if (nome && strcmp(nome, "csv") == 0) {
+        formato_padrao = SAIDA_CSV;
+    } else if (nome && strcmp(nome, "jsonl") == 0) {
+        formato_padrao = SAIDA_JSONL;
+    } else {
+        fprintf(stderr, "Formato de saída desconhecido: %s (use csv ou jsonl)\n",
+                nome ? nome : "(nulo)");
+        return -1;
+    }
+    return 0;
+}
+
+saida_formato_t saida_formato_padrao(void) {
+    return formato_padrao;
+}
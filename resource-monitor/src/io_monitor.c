@@ -1,5 +1,5 @@
 // io_monitor.c - versão completa e corrigida
-#define _POSIX_C_SOURCE 200809L  // para nanosleep/localtime_r
+#define _POSIX_C_SOURCE 200809L  // para nanosleep
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -12,65 +12,81 @@
 #include <sys/stat.h>
 #include <ctype.h>
 #include "../include/monitor.h"  // precisa declarar io_stats_t e os protótipos aqui
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/scheduler.h"
+#include "../include/taskstats_backend.h"
+#include "../include/targets.h"
+#include "../include/ring_buffer.h"
+#include "../include/timestamp.h"
+#include "../include/timeseries.h"
+#include "../include/quantile.h"
+#include "../include/alerts.h"
 
 /* ==================== ESTADO INTERNO ==================== */
 
 typedef struct {
     pid_t      pid;
     io_stats_t stats_antes;
+    long long  mono_ns_antes;   // instante (CLOCK_MONOTONIC) de stats_antes
+    int        origem;          // fixada na primeira leitura do PID (io_origem_processo)
     int        iniciado;
 } io_monitor_state_t;
 
 static io_monitor_state_t io_state = { .pid = -1, .iniciado = 0 };
 
-/* ==================== FUNÇÕES AUXILIARES ==================== */
+/* ==================== LEITURA DE I/O DO PROCESSO ==================== */
 
-static void obter_timestamp_io(char *buffer, size_t size) {
-    time_t now = time(NULL);
-    if (now == (time_t)-1) {
-        snprintf(buffer, size, "ERRO_TIMESTAMP");
-        return;
-    }
-    struct tm tm_info;
-    localtime_r(&now, &tm_info);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &tm_info);
+int io_origem_processo(pid_t pid) {
+    if (backend_atual() != BACKEND_TASKSTATS) return 0;
+    // io_disponivel = 0 também num processo que ainda não fez I/O: /proc/<pid>/io
+    // é exato nos dois casos, e a escolha vale para o run inteiro
+    taskstats_info_t ts;
+    return taskstats_ler_pid(pid, &ts) == 0 && ts.io_disponivel;
 }
 
-// sleep em ms com nanosleep (mais robusto que usleep)
-static void dormir_ms_io(int ms) {
-    struct timespec req = {
-        .tv_sec  = ms / 1000,
-        .tv_nsec = (long)(ms % 1000) * 1000000L
-    };
-    struct timespec rem;
-
-    while (nanosleep(&req, &rem) == -1 && errno == EINTR) {
-        req = rem;
-    }
+int io_ler_stats_processo(pid_t pid, io_stats_t *stats) {
+    return io_ler_stats_processo_de(pid, io_origem_processo(pid), stats);
 }
 
-/* ==================== LEITURA DE I/O DO PROCESSO ==================== */
-
-int io_ler_stats_processo(pid_t pid, io_stats_t *stats) {
+int io_ler_stats_processo_de(pid_t pid, int origem_taskstats, io_stats_t *stats) {
     if (!stats || pid <= 0) {
         fprintf(stderr, "Erro: parâmetros inválidos em io_ler_stats_processo\n");
         return -1;
     }
 
-    memset(stats, 0, sizeof(io_stats_t));
-
-    // /proc/<pid>/io → estatísticas de I/O do processo
-    char caminho[64];
-    snprintf(caminho, sizeof(caminho), "/proc/%d/io", pid);
+    // Backend netlink: uma mensagem binária
+    if (origem_taskstats) {
+        taskstats_info_t ts;
+        memset(stats, 0, sizeof(io_stats_t));
+        if (taskstats_ler_pid(pid, &ts) != 0) return -1;
+        taskstats_para_io(&ts, stats);
+        return 0;
+    }
 
-    FILE *fp = fopen(caminho, "r");
-    if (!fp) {
+    // /proc/<pid>/io → estatísticas de I/O do processo (descritor mantido no cache)
+    const char *io = proc_cache_ler_pid(pid, PROC_ARQ_IO, NULL);
+    if (!io) {
         // pode ser falta de permissão ou processo já terminou
+        memset(stats, 0, sizeof(io_stats_t));
         return -1;
     }
 
-    char linha[256];
-    while (fgets(linha, sizeof(linha), fp)) {
+    // Tenta estimar "operações de disco" usando major faults em /proc/<pid>/stat
+    const char *buffer = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+
+    return io_interpretar_processo(io, buffer, stats);
+}
+
+int io_interpretar_processo(const char *io, const char *buffer, io_stats_t *stats) {
+    if (!io || !stats) {
+        fprintf(stderr, "Erro: parâmetros inválidos em io_interpretar_processo\n");
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(io_stats_t));
+
+    for (const char *linha = io; *linha; ) {
         if (strncmp(linha, "rchar:", 6) == 0) {
             sscanf(linha + 6, "%llu", &stats->read_bytes);
         } else if (strncmp(linha, "wchar:", 6) == 0) {
@@ -80,38 +96,18 @@ int io_ler_stats_processo(pid_t pid, io_stats_t *stats) {
         } else if (strncmp(linha, "syscw:", 6) == 0) {
             sscanf(linha + 6, "%llu", &stats->write_syscalls);
         }
+
+        const char *fim = strchr(linha, '\n');
+        if (!fim) break;
+        linha = fim + 1;
     }
-    fclose(fp);
 
-    // Tenta estimar "operações de disco" usando major faults em /proc/<pid>/stat
-    snprintf(caminho, sizeof(caminho), "/proc/%d/stat", pid);
-    fp = fopen(caminho, "r");
-    if (fp) {
-        char buffer[1024];
-        if (fgets(buffer, sizeof(buffer), fp)) {
-            // nome do processo vai até o último ')'
-            char *p = strrchr(buffer, ')');
-            if (p) {
-                p += 2; // pula ") "
-
-                // Depois do nome temos:
-                // state(1) ppid(2) pgid(3) sid(4) tty_nr(5) tty_pgrp(6)
-                // flags(7) minflt(8) cminflt(9) majflt(10) cmajflt(11) ...
-                // Queremos o majflt → pular 9 espaços e ler o próximo número
-                for (int i = 0; i < 9; i++) {
-                    p = strchr(p, ' ');
-                    if (!p) break;
-                    p++;
-                }
-                if (p) {
-                    unsigned long majflt = 0;
-                    if (sscanf(p, "%lu", &majflt) == 1) {
-                        stats->disk_operations = (unsigned long long)majflt;
-                    }
-                }
-            }
+    // "operações de disco" ≈ major faults de /proc/<pid>/stat (opcional)
+    if (buffer) {
+        proc_stat_campos_t c;
+        if (proc_stat_interpretar(buffer, PSTAT_BIT(PSTAT_MAJFLT), &c) == 0) {
+            stats->disk_operations = c.campos[PSTAT_MAJFLT];
         }
-        fclose(fp);
     }
 
     return 0;
@@ -121,12 +117,22 @@ int io_ler_stats_processo(pid_t pid, io_stats_t *stats) {
 
 int io_calcular_taxas(const io_stats_t *antes, const io_stats_t *depois,
                       int intervalo_ms, io_stats_t *taxas) {
-    if (!antes || !depois || !taxas || intervalo_ms <= 0) {
+    if (intervalo_ms <= 0) {
         fprintf(stderr, "Erro: parâmetros inválidos em io_calcular_taxas\n");
         return -1;
     }
+    return io_calcular_taxas_ns(antes, depois, (long long)intervalo_ms * 1000000LL, taxas);
+}
 
-    double segundos = intervalo_ms / 1000.0;
+int io_calcular_taxas_ns(const io_stats_t *antes, const io_stats_t *depois,
+                         long long decorrido_ns, io_stats_t *taxas) {
+    if (!antes || !depois || !taxas || decorrido_ns <= 0) {
+        fprintf(stderr, "Erro: parâmetros inválidos em io_calcular_taxas_ns\n");
+        return -1;
+    }
+
+    // tempo real entre as duas leituras (não o intervalo nominal)
+    double segundos = (double)decorrido_ns / 1e9;
 
     unsigned long long d_read_bytes = 0, d_write_bytes = 0;
     unsigned long long d_read_sys   = 0, d_write_sys   = 0;
@@ -154,6 +160,35 @@ int io_calcular_taxas(const io_stats_t *antes, const io_stats_t *depois,
 
 /* ==================== MONITORAMENTO CONTÍNUO (CSV) ==================== */
 
+/* Uma linha do CSV, montada na amostragem e formatada na thread escritora */
+typedef struct {
+    long long  real_ns;      // formatado na thread escritora
+    int        amostra;
+    io_stats_t taxas;
+} registro_io_t;
+
+static void formatar_registro_io(FILE *saida, const void *registro, void *ctx) {
+    const registro_io_t *r = (const registro_io_t *)registro;
+    (void)ctx;
+    char ts[CARIMBO_TAM];
+    carimbo_formatar(r->real_ns, ts, sizeof(ts));
+    fprintf(saida, "%s,%d,%llu,%llu,%llu,%llu,%llu\n",
+            ts, r->amostra,
+            r->taxas.read_bytes, r->taxas.write_bytes,
+            r->taxas.read_syscalls, r->taxas.write_syscalls,
+            r->taxas.disk_operations);
+}
+
+/* Entrega as colunas do CSV (taxas por segundo) ao motor de alertas */
+static void observar_alertas(alertas_t *al, pid_t pid, long long mono_ns, const io_stats_t *t) {
+    if (!al || al->num == 0) return;
+    alertas_observar(al, pid, "read_bps",          mono_ns, (double)t->read_bytes);
+    alertas_observar(al, pid, "write_bps",         mono_ns, (double)t->write_bytes);
+    alertas_observar(al, pid, "read_syscalls_ps",  mono_ns, (double)t->read_syscalls);
+    alertas_observar(al, pid, "write_syscalls_ps", mono_ns, (double)t->write_syscalls);
+    alertas_observar(al, pid, "disk_ops_ps",       mono_ns, (double)t->disk_operations);
+}
+
 int io_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
     if (pid <= 0 || intervalo_ms < 1 || amostras <= 0) {
         fprintf(stderr, "Erro: parâmetros inválidos em io_monitorar_pid_csv\n");
@@ -164,11 +199,14 @@ int io_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida)
 
     io_stats_t stats_antes, stats_depois, taxas;
 
-    // leitura inicial
-    if (io_ler_stats_processo(pid, &stats_antes) != 0) {
+    // leitura inicial; a origem escolhida aqui vale para todos os deltas do run
+    int origem = io_origem_processo(pid);
+    if (io_ler_stats_processo_de(pid, origem, &stats_antes) != 0) {
         fprintf(stderr, "Erro: não foi possível ler stats de I/O do processo %d\n", pid);
         return -1;
     }
+    long long mono_antes = agendador_agora_ns();
+    alvo_registrar(pid);
 
     // cabeçalho CSV
     fprintf(saida,
@@ -180,29 +218,63 @@ int io_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida)
                 pid, amostras, intervalo_ms);
     }
 
+    escritor_t escritor;
+    if (escritor_iniciar(&escritor, saida, sizeof(registro_io_t), ESCRITOR_CAPACIDADE_PADRAO,
+                         formatar_registro_io, NULL) != 0) {
+        alvo_remover(pid);
+        return -1;
+    }
+
+    quantil_t q_leitura, q_escrita, q_latencia;
+    int com_percentis = (quantil_iniciar(&q_leitura) == 0) & (quantil_iniciar(&q_escrita) == 0) &
+                        (quantil_iniciar(&q_latencia) == 0);
+    alertas_t *alertas = alertas_padrao();
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    int coletadas = 0;
     for (int i = 0; i < amostras; i++) {
-        dormir_ms_io(intervalo_ms);
+        long long acordou = agendador_esperar(&ag);
 
-        if (io_ler_stats_processo(pid, &stats_depois) != 0) {
-            fprintf(stderr, "Processo %d terminou durante monitoramento de I/O\n", pid);
-            return -1;
+        int falhou = io_ler_stats_processo_de(pid, origem, &stats_depois) != 0;
+        carimbo_t quando;  // o mesmo instante vira o timestamp e fecha o intervalo da taxa
+        carimbo_agora(&quando);
+        long long mono_depois = quando.mono_ns;
+
+        alvo_estado_t estado = alvo_estado(pid);
+        if (estado == ALVO_ENCERRADO || estado == ALVO_RECICLADO) {
+            alvo_relatar_fim(pid, estado, i);
+            break;
+        }
+        if (falhou) {
+            fprintf(stderr, "Falha ao ler I/O do processo %d (amostra %d)\n", pid, i);
+            rc = -1;
+            break;
         }
 
-        if (io_calcular_taxas(&stats_antes, &stats_depois, intervalo_ms, &taxas) != 0) {
+        if (io_calcular_taxas_ns(&stats_antes, &stats_depois,
+                                 mono_depois - mono_antes, &taxas) != 0) {
             fprintf(stderr, "Erro ao calcular taxas de I/O\n");
-            return -1;
+            rc = -1;
+            break;
         }
+        coletadas++;
+
+        registro_io_t reg;
+        reg.real_ns = quando.real_ns;
+        reg.amostra = i;
+        reg.taxas   = taxas;
+        escritor_enviar(&escritor, &reg);
 
-        char ts[64];
-        obter_timestamp_io(ts, sizeof(ts));
-        fprintf(saida, "%s,%d,%llu,%llu,%llu,%llu,%llu\n",
-                ts, i,
-                taxas.read_bytes, taxas.write_bytes,
-                taxas.read_syscalls, taxas.write_syscalls,
-                taxas.disk_operations);
-        fflush(saida);
+        quantil_registrar(&q_leitura, taxas.read_bytes  / 1024.0);
+        quantil_registrar(&q_escrita, taxas.write_bytes / 1024.0);
+        quantil_registrar(&q_latencia, (mono_depois - acordou) / 1000.0);
+        observar_alertas(alertas, pid, mono_depois, &taxas);
 
         stats_antes = stats_depois;
+        mono_antes  = mono_depois;
 
         if (saida != stdout && (amostras <= 10 || (i + 1) % 10 == 0)) {
             fprintf(stderr,
@@ -213,11 +285,28 @@ int io_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida)
         }
     }
 
-    if (saida != stdout) {
-        fprintf(stderr, "Monitoramento de I/O concluído: %d amostras coletadas\n", amostras);
+    unsigned long descartados = escritor_encerrar(&escritor);
+    if (descartados > 0) {
+        fprintf(stderr, "Saída lenta: %lu amostras de I/O descartadas\n", descartados);
     }
-
-    return 0;
+    alvo_remover(pid);
+    if (rc == 0) {
+        agendador_relatar(&ag, "Monitoramento de I/O");
+        if (saida != stdout) {
+            fprintf(stderr, "Monitoramento de I/O concluído: %d amostras coletadas\n", coletadas);
+        }
+        if (com_percentis && q_leitura.contagem > 0) {
+            fprintf(stderr, "Percentis de I/O (%llu amostras):\n", q_leitura.contagem);
+            quantil_imprimir(stderr, &q_leitura,  "leitura", "KB/s");
+            quantil_imprimir(stderr, &q_escrita,  "escrita", "KB/s");
+            quantil_imprimir(stderr, &q_latencia, "coleta", "µs");
+        }
+        alertas_relatar(alertas);
+    }
+    quantil_liberar(&q_leitura);
+    quantil_liberar(&q_escrita);
+    quantil_liberar(&q_latencia);
+    return rc;
 }
 
 /* ==================== USO INSTANTÂNEO ==================== */
@@ -232,28 +321,33 @@ int io_obter_uso_instantaneo(pid_t pid, io_stats_t *taxas) {
 
     // primeira vez ou PID mudou → inicializa base
     if (!io_state.iniciado || io_state.pid != pid) {
-        if (io_ler_stats_processo(pid, &io_state.stats_antes) != 0) {
+        io_state.origem = io_origem_processo(pid);
+        if (io_ler_stats_processo_de(pid, io_state.origem, &io_state.stats_antes) != 0) {
             fprintf(stderr, "Erro na leitura inicial de I/O para PID %d\n", pid);
             return -1;
         }
+        io_state.mono_ns_antes = agendador_agora_ns();
         io_state.pid      = pid;
         io_state.iniciado = 1;
 
         // pequeno intervalo para formar delta
-        dormir_ms_io(100); // 100 ms
+        agendador_dormir_ms(100); // 100 ms
     }
 
-    if (io_ler_stats_processo(pid, &stats_depois) != 0) {
+    if (io_ler_stats_processo_de(pid, io_state.origem, &stats_depois) != 0) {
         fprintf(stderr, "Erro ao ler stats de I/O atuais para PID %d\n", pid);
         return -1;
     }
+    long long mono_depois = agendador_agora_ns();
 
-    // aproxima: considera intervalo de 1000 ms para taxas "por segundo"
-    if (io_calcular_taxas(&io_state.stats_antes, &stats_depois, 1000, taxas) != 0) {
+    // taxas "por segundo" sobre o tempo realmente decorrido desde a última chamada
+    if (io_calcular_taxas_ns(&io_state.stats_antes, &stats_depois,
+                             mono_depois - io_state.mono_ns_antes, taxas) != 0) {
         return -1;
     }
 
-    io_state.stats_antes = stats_depois;
+    io_state.stats_antes   = stats_depois;
+    io_state.mono_ns_antes = mono_depois;
     return 0;
 }
 
@@ -376,8 +470,13 @@ int io_gerar_relatorio(pid_t pid, FILE *out) {
         return -1;
     }
 
-    char ts[64];
-    obter_timestamp_io(ts, sizeof(ts));
+    char ts[CARIMBO_TAM];
+    carimbo_t quando;
+    carimbo_texto_agora(ts, sizeof(ts), &quando);
+
+    historico_t *hist = hist_padrao();
+    hist_registrar(hist, pid, "read_kbps",  quando.real_ns, taxas.read_bytes  / 1024.0);
+    hist_registrar(hist, pid, "write_kbps", quando.real_ns, taxas.write_bytes / 1024.0);
 
     fprintf(out,
             "============================================================\n"
@@ -390,14 +489,16 @@ int io_gerar_relatorio(pid_t pid, FILE *out) {
             "  Taxa de escrita : %10.2f KB/s\n"
             "  Syscalls leitura: %10llu ops/s\n"
             "  Syscalls escrita: %10llu ops/s\n"
-            "  Operações disco : %10llu ops/s (aprox.)\n"
-            "============================================================\n\n",
+            "  Operações disco : %10llu ops/s (aprox.)\n",
             pid, ts,
             taxas.read_bytes  / 1024.0,
             taxas.write_bytes / 1024.0,
             taxas.read_syscalls,
             taxas.write_syscalls,
             taxas.disk_operations);
+    hist_imprimir_tendencia(out, hist, pid, "read_kbps",  "leitura", "KB/s");
+    hist_imprimir_tendencia(out, hist, pid, "write_kbps", "escrita", "KB/s");
+    fprintf(out, "============================================================\n\n");
 
     return 0;
 }
@@ -413,6 +514,7 @@ int io_gerar_relatorio(pid_t pid, FILE *out) {
 void io_resetar_estado(void) {
     io_state.pid      = -1;
     io_state.iniciado = 0;
+    io_state.mono_ns_antes = 0;
     memset(&io_state.stats_antes, 0, sizeof(io_stats_t));
     fprintf(stderr, "Estado do monitor de I/O resetado\n");
 }
@@ -3,12 +3,26 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/resource.h>
 #include <dirent.h>
 #include <ctype.h>
 
 #include "../include/monitor.h"
 #include "../include/cgroup.h"
 #include "../include/namespace.h"
+#include "../include/sampler.h"
+#include "../include/scanner.h"
+#include "../include/proctree.h"
+#include "../include/proc_events.h"
+#include "../include/taskstats_backend.h"
+#include "../include/proc_batch.h"
+#include "../include/recording.h"
+#include "../include/formatter.h"
+#include "../include/timestamp.h"
+#include "../include/alerts.h"
+#include "../include/daemon.h"
+#include "../include/perf_counters.h"
+#include "../include/psi.h"
 
 static void imprimir_uso_geral(const char *progname) {
     fprintf(stderr,
@@ -16,6 +30,20 @@ static void imprimir_uso_geral(const char *progname) {
         "  %s cpu <pid> <intervalo_ms> <amostras>\n"
         "  %s mem <pid> <intervalo_ms> <amostras>\n"
         "  %s io  <pid> <intervalo_ms> <amostras>\n"
+        "  %s all <pid> <intervalo_ms> <amostras>\n"
+        "  %s top <intervalo_ms> <iteracoes> [top_n] [cpu|rss|io|read|write]\n"
+        "  %s threads <pid> <intervalo_ms> <iteracoes> [top_n] [cpu|io|read|write]\n"
+        "  %s record all <pid> <intervalo_ms> <amostras> <arquivo>\n"
+        "  %s record top <intervalo_ms> <iteracoes> <arquivo>\n"
+        "  %s convert <arquivo> [saida.csv]\n"
+        "  %s daemon <socket> [--metricas <[host:]porta|/caminho>] [--psi '<gatilho>' ...] [pid[:intervalo_ms] ...]\n"
+        "  %s ctl <socket> <comando> [args...]   (add|remove|interval|list|latest|history|...)\n"
+        "  %s tree <pid> <intervalo_ms> <amostras>\n"
+        "  %s delay <pid> <intervalo_ms> <amostras>\n"
+        "  %s perf  <pid> <intervalo_ms> <amostras>\n"
+        "  %s watch <pid|nome> <intervalo_ms> <amostras>\n"
+        "  %s pressure <intervalo_ms> <amostras> [cgroup]\n"
+        "  %s pressure-watch <eventos> '<recurso> <some|full> <limite> <janela> [cgroup]' ...\n"
         "  %s cgroup-create <nome> <cpu_cores> <mem_mb>\n"
         "  %s cgroup-add    <nome> <pid>\n"
         "  %s cgroup-stats  <nome>\n"
@@ -23,10 +51,22 @@ static void imprimir_uso_geral(const char *progname) {
         "  %s ns-compare <pid1> <pid2>\n"
         "  %s ns-report\n"
         "\n"
+        "Opções globais: --backend proc|taskstats|auto (origem dos dados de CPU/I/O)\n"
+        "                --leitura pread|uring (leitura em lote do /proc nos modos top/threads;\n"
+        "                  uring só com --workers 1, os workers leem com pread)\n"
+        "                --workers <n> (threads da varredura do modo top; 0 = uma por CPU)\n"
+        "                --formato csv|jsonl (saída de all/top/threads/perf/convert)\n"
+        "                --precisao s|ms|us (fração de segundo nas colunas timestamp; padrão ms)\n"
+        "                --alerta '<regra>' (repetível) | --alertas <arquivo> (cpu/mem/io/all)\n"
         "Sem argumentos, o programa entra em modo interativo (menu).\n",
         progname, progname, progname,
         progname, progname, progname,
-        progname, progname, progname
+        progname, progname, progname,
+        progname, progname, progname,
+        progname, progname, progname,
+        progname, progname, progname,
+        progname, progname, progname,
+        progname, progname
     );
 }
 
@@ -59,7 +99,12 @@ static int cmd_cpu(int argc, char *argv[]) {
     fprintf(stderr, "  timestamp            -> data/hora da coleta\n");
     fprintf(stderr, "  amostra              -> número sequencial da amostra (0..N-1)\n");
     fprintf(stderr, "  cpu_processo_percent -> uso de CPU do processo monitorado (em %%)\n");
-    fprintf(stderr, "  cpu_sistema_percent  -> uso total de CPU do sistema (em %%)\n\n");
+    fprintf(stderr, "  cpu_sistema_percent  -> uso total de CPU do sistema (em %%)\n");
+    fprintf(stderr, "  cpu_wait_ms_s        -> tempo pronto mas esperando CPU (ms por segundo, todas as threads)\n");
+    fprintf(stderr, "  cpu_wait_medio_us    -> espera média na run queue por fatia de CPU (em µs)\n");
+    fprintf(stderr, "  voluntary_ctxsw_ps   -> trocas de contexto voluntárias por segundo (bloqueios)\n");
+    fprintf(stderr, "  nonvoluntary_ctxsw_ps-> trocas de contexto involuntárias por segundo (preempção)\n");
+    fprintf(stderr, "  cpuN_percent         -> uso de cada core N (em %%)\n\n");
 
     return cpu_monitorar_pid_csv(pid, intervalo_ms, amostras, stdout);
 }
@@ -111,6 +156,359 @@ static int cmd_io(int argc, char *argv[]) {
     return io_monitorar_pid_csv(pid, intervalo_ms, amostras, stdout);
 }
 
+static int cmd_all(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Uso: %s all <pid> <intervalo_ms> <amostras>\n", argv[0]);
+        return 1;
+    }
+
+    pid_t pid = (pid_t)atoi(argv[2]);
+    int intervalo_ms = atoi(argv[3]);
+    int amostras = atoi(argv[4]);
+
+    if (pid <= 0 || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando all.\n");
+        return 1;
+    }
+
+    if (!processo_existe(pid)) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        return 1;
+    }
+
+    return sampler_monitorar_pid_csv(pid, intervalo_ms, amostras, stdout);
+}
+
+static int cmd_tree(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Uso: %s tree <pid> <intervalo_ms> <amostras>\n", argv[0]);
+        return 1;
+    }
+
+    pid_t pid = (pid_t)atoi(argv[2]);
+    int intervalo_ms = atoi(argv[3]);
+    int amostras = atoi(argv[4]);
+
+    if (pid <= 0 || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando tree.\n");
+        return 1;
+    }
+
+    if (!processo_existe(pid)) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        return 1;
+    }
+
+    return arvore_monitorar_csv(pid, intervalo_ms, amostras, stdout);
+}
+
+static int cmd_watch(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Uso: %s watch <pid|nome> <intervalo_ms> <amostras>\n", argv[0]);
+        return 1;
+    }
+
+    // alvo numérico = raiz de uma árvore; texto = comm de processos a anexar no exec
+    char *fim = NULL;
+    long valor = strtol(argv[2], &fim, 10);
+    pid_t raiz = (fim && *fim == '\0') ? (pid_t)valor : 0;
+    const char *nome = (raiz > 0) ? NULL : argv[2];
+    int intervalo_ms = atoi(argv[3]);
+    int amostras = atoi(argv[4]);
+
+    if ((raiz <= 0 && (!nome || !*nome)) || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando watch.\n");
+        return 1;
+    }
+
+    if (raiz > 0 && !processo_existe(raiz)) {
+        fprintf(stderr, "Processo %d não existe.\n", raiz);
+        return 1;
+    }
+
+    return eventos_monitorar_csv(raiz, nome, intervalo_ms, amostras, stdout);
+}
+
+static int cmd_delay(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Uso: %s delay <pid> <intervalo_ms> <amostras>\n", argv[0]);
+        return 1;
+    }
+
+    pid_t pid = (pid_t)atoi(argv[2]);
+    int intervalo_ms = atoi(argv[3]);
+    int amostras = atoi(argv[4]);
+
+    if (pid <= 0 || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando delay.\n");
+        return 1;
+    }
+
+    // atrasos só existem no backend netlink; não há equivalente em /proc/<pid>/io|stat
+    return taskstats_monitorar_atrasos_csv(pid, intervalo_ms, amostras, stdout);
+}
+
+static int cmd_perf(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Uso: %s perf <pid> <intervalo_ms> <amostras>\n", argv[0]);
+        return 1;
+    }
+
+    pid_t pid = (pid_t)atoi(argv[2]);
+    int intervalo_ms = atoi(argv[3]);
+    int amostras = atoi(argv[4]);
+
+    if (pid <= 0 || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando perf.\n");
+        return 1;
+    }
+
+    // task-clock em ns: CPU% confiável mesmo com intervalos de 10-50 ms
+    return perf_monitorar_pid_csv(pid, intervalo_ms, amostras, stdout) == 0 ? 0 : 1;
+}
+
+static int cmd_pressure(int argc, char *argv[]) {
+    if (argc != 4 && argc != 5) {
+        fprintf(stderr, "Uso: %s pressure <intervalo_ms> <amostras> [cgroup]\n", argv[0]);
+        return 1;
+    }
+
+    int intervalo_ms = atoi(argv[2]);
+    int amostras = atoi(argv[3]);
+    if (intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando pressure.\n");
+        return 1;
+    }
+
+    // sem cgroup: /proc/pressure (máquina inteira)
+    const char *cgroup = argc == 5 ? argv[4] : NULL;
+    return psi_monitorar_csv(cgroup, intervalo_ms, amostras, stdout) == 0 ? 0 : 1;
+}
+
+static int cmd_pressure_watch(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Uso: %s pressure-watch <eventos> '<recurso> <some|full> <limite> <janela> [cgroup]' ...\n"
+                        "  ex.: %s pressure-watch 10 'memory some 150ms 2s' 'cpu some 200ms 2s'\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    int eventos = atoi(argv[2]);
+    int num = argc - 3;
+    if (eventos <= 0 || num > DAEMON_GATILHOS_MAX) {
+        fprintf(stderr, "Parâmetros inválidos em comando pressure-watch (até %d gatilhos).\n",
+                DAEMON_GATILHOS_MAX);
+        return 1;
+    }
+
+    psi_gatilho_t gatilhos[DAEMON_GATILHOS_MAX];
+    for (int k = 0; k < num; k++) {
+        if (psi_gatilho_interpretar(argv[3 + k], &gatilhos[k]) != 0) return 1;
+    }
+    return psi_vigiar_csv(gatilhos, num, eventos, stdout) == 0 ? 0 : 1;
+}
+
+static int cmd_top(int argc, char *argv[]) {
+    if (argc < 4 || argc > 6) {
+        fprintf(stderr,
+                "Uso: %s top <intervalo_ms> <iteracoes> [top_n] [cpu|rss|io|read|write]\n",
+                argv[0]);
+        return 1;
+    }
+
+    int intervalo_ms = atoi(argv[2]);
+    int iteracoes = atoi(argv[3]);
+    int top_n = (argc >= 5) ? atoi(argv[4]) : 10;
+    scanner_ordem_t ordem = SCANNER_ORDEM_CPU;
+
+    if (intervalo_ms <= 0 || iteracoes <= 0 || top_n <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando top.\n");
+        return 1;
+    }
+
+    if (argc == 6 && scanner_ordem_de_texto(argv[5], &ordem) != 0) {
+        fprintf(stderr, "Métrica inválida: %s (use cpu, rss, io, read ou write)\n", argv[5]);
+        return 1;
+    }
+
+    return scanner_monitorar_top_csv(intervalo_ms, iteracoes, (size_t)top_n, ordem, stdout);
+}
+
+static int cmd_threads(int argc, char *argv[]) {
+    if (argc < 5 || argc > 7) {
+        fprintf(stderr,
+                "Uso: %s threads <pid> <intervalo_ms> <iteracoes> [top_n] [cpu|io|read|write]\n",
+                argv[0]);
+        return 1;
+    }
+
+    pid_t pid = (pid_t)atoi(argv[2]);
+    int intervalo_ms = atoi(argv[3]);
+    int iteracoes = atoi(argv[4]);
+    int top_n = (argc >= 6) ? atoi(argv[5]) : 10;
+    scanner_ordem_t ordem = SCANNER_ORDEM_CPU;
+
+    if (pid <= 0 || intervalo_ms <= 0 || iteracoes <= 0 || top_n <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando threads.\n");
+        return 1;
+    }
+
+    if (argc == 7 && scanner_ordem_de_texto(argv[6], &ordem) != 0) {
+        fprintf(stderr, "Métrica inválida: %s (use cpu, io, read ou write)\n", argv[6]);
+        return 1;
+    }
+
+    return scanner_monitorar_threads_csv(pid, intervalo_ms, iteracoes, (size_t)top_n,
+                                         ordem, stdout);
+}
+
+static int cmd_record(int argc, char *argv[]) {
+    int modo_all = (argc == 7 && strcmp(argv[2], "all") == 0);
+    int modo_top = (argc == 6 && strcmp(argv[2], "top") == 0);
+    if (!modo_all && !modo_top) {
+        fprintf(stderr,
+                "Uso: %s record all <pid> <intervalo_ms> <amostras> <arquivo>\n"
+                "     %s record top <intervalo_ms> <iteracoes> <arquivo>\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    pid_t pid = modo_all ? (pid_t)atoi(argv[3]) : 0;
+    int intervalo_ms = atoi(argv[modo_all ? 4 : 3]);
+    int amostras = atoi(argv[modo_all ? 5 : 4]);
+    const char *caminho = argv[argc - 1];
+
+    if ((modo_all && pid <= 0) || intervalo_ms <= 0 || amostras <= 0) {
+        fprintf(stderr, "Parâmetros inválidos em comando record.\n");
+        return 1;
+    }
+
+    if (modo_all && !processo_existe(pid)) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        return 1;
+    }
+
+    FILE *arq = fopen(caminho, "wb");
+    if (!arq) {
+        perror(caminho);
+        return 1;
+    }
+
+    int rc = modo_all ? sampler_gravar_pid(pid, intervalo_ms, amostras, arq)
+                      : scanner_gravar_top(intervalo_ms, amostras, arq);
+    if (fclose(arq) != 0) {
+        perror(caminho);
+        rc = -1;
+    }
+    return rc == 0 ? 0 : 1;
+}
+
+static int cmd_convert(int argc, char *argv[]) {
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "Uso: %s convert <arquivo> [saida.csv]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *entrada = fopen(argv[2], "rb");
+    if (!entrada) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    FILE *saida = stdout;
+    if (argc == 4 && (saida = fopen(argv[3], "w")) == NULL) {
+        perror(argv[3]);
+        fclose(entrada);
+        return 1;
+    }
+
+    int rc = gravacao_converter_csv(entrada, saida);
+    fclose(entrada);
+    if (saida != stdout && fclose(saida) != 0) {
+        perror(argv[3]);
+        rc = -1;
+    }
+    return rc == 0 ? 0 : 1;
+}
+
+static int cmd_daemon(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s daemon <socket> [--metricas <[host:]porta|/caminho>] "
+                        "[--psi '<gatilho>' ...] [pid[:intervalo_ms] ...]\n", argv[0]);
+        return 1;
+    }
+
+    int primeiro = 3;
+    const char *metricas = NULL;
+    psi_gatilho_t gatilhos[DAEMON_GATILHOS_MAX];
+    int num_gatilhos = 0;
+    while (primeiro < argc && strncmp(argv[primeiro], "--", 2) == 0) {
+        if (strcmp(argv[primeiro], "--metricas") == 0) {
+            if (primeiro + 1 >= argc) {
+                fprintf(stderr, "--metricas requer um endereço ([host:]porta ou caminho de socket)\n");
+                return 1;
+            }
+            metricas = argv[primeiro + 1];
+        } else if (strcmp(argv[primeiro], "--psi") == 0) {
+            if (primeiro + 1 >= argc || num_gatilhos >= DAEMON_GATILHOS_MAX) {
+                fprintf(stderr, "--psi requer '<recurso> <some|full> <limite> <janela> [cgroup]' "
+                                "(até %d gatilhos)\n", DAEMON_GATILHOS_MAX);
+                return 1;
+            }
+            if (psi_gatilho_interpretar(argv[primeiro + 1], &gatilhos[num_gatilhos]) != 0) return 1;
+            num_gatilhos++;
+        } else {
+            fprintf(stderr, "Opção desconhecida do daemon: %s\n", argv[primeiro]);
+            return 1;
+        }
+        primeiro += 2;
+    }
+
+    int num_alvos = argc - primeiro;
+    if (num_alvos > DAEMON_ALVOS_MAX) {
+        fprintf(stderr, "No máximo %d alvos.\n", DAEMON_ALVOS_MAX);
+        return 1;
+    }
+
+    pid_t pids[DAEMON_ALVOS_MAX];
+    int intervalos[DAEMON_ALVOS_MAX];
+    for (int k = 0; k < num_alvos; k++) {
+        char *fim;
+        long pid = strtol(argv[primeiro + k], &fim, 10);
+        long intervalo = DAEMON_INTERVALO_PADRAO;
+        if (*fim == ':') intervalo = strtol(fim + 1, &fim, 10);
+        if (*fim != '\0' || pid <= 0 || intervalo < 1) {
+            fprintf(stderr, "Alvo inválido: %s (esperado pid ou pid:intervalo_ms)\n", argv[primeiro + k]);
+            return 1;
+        }
+        pids[k] = (pid_t)pid;
+        intervalos[k] = (int)intervalo;
+    }
+
+    return daemon_executar(argv[2], metricas, pids, intervalos, num_alvos,
+                           gatilhos, num_gatilhos) == 0 ? 0 : 1;
+}
+
+static int cmd_ctl(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Uso: %s ctl <socket> <comando> [args...]\n", argv[0]);
+        return 1;
+    }
+
+    char comando[DAEMON_LINHA_MAX];
+    size_t tam = 0;
+    for (int k = 3; k < argc; k++) {
+        int n = snprintf(comando + tam, sizeof(comando) - tam, "%s%s", k > 3 ? " " : "", argv[k]);
+        if (n < 0 || (size_t)n >= sizeof(comando) - tam) {
+            fprintf(stderr, "Comando muito longo.\n");
+            return 1;
+        }
+        tam += (size_t)n;
+    }
+
+    return daemon_enviar(argv[2], comando) == 0 ? 0 : 1;
+}
+
 static int cmd_cgroup_create(int argc, char *argv[]) {
     if (argc != 5) {
         fprintf(stderr,
@@ -458,7 +856,63 @@ static int menu_interativo(const char *progname) {
     }
 }
 
+/* Remove de argv (em qualquer posição) as opções globais com valor: --backend,
+ * --leitura, --workers, --formato, --precisao, --alerta e --alertas */
+static int extrair_opcoes_globais(int *argc, char *argv[]) {
+    for (int i = 1; i < *argc; i++) {
+        int backend = strcmp(argv[i], "--backend") == 0;
+        int leitura = strcmp(argv[i], "--leitura") == 0;
+        int workers = strcmp(argv[i], "--workers") == 0;
+        int formato = strcmp(argv[i], "--formato") == 0;
+        int precisao = strcmp(argv[i], "--precisao") == 0;
+        int alerta   = strcmp(argv[i], "--alerta") == 0;
+        int alertas  = strcmp(argv[i], "--alertas") == 0;
+        if (!backend && !leitura && !workers && !formato && !precisao && !alerta && !alertas) continue;
+
+        if (i + 1 >= *argc) {
+            fprintf(stderr, "%s requer um valor\n", argv[i]);
+            return -1;
+        }
+        if (backend && backend_selecionar(argv[i + 1]) != 0) return -1;
+        if (leitura && proc_lote_selecionar(argv[i + 1]) != 0) return -1;
+        if (formato && saida_selecionar(argv[i + 1]) != 0) return -1;
+        if (precisao && carimbo_selecionar(argv[i + 1]) != 0) return -1;
+        if (alerta && alertas_adicionar(alertas_padrao(), argv[i + 1]) != 0) return -1;
+        if (alertas && alertas_carregar(alertas_padrao(), argv[i + 1]) != 0) return -1;
+        if (workers) {
+            char *fim;
+            long n = strtol(argv[i + 1], &fim, 10);
+            if (*fim != '\0' || n < 0 || n > 1024) {
+                fprintf(stderr, "--workers inválido: %s (0 = um por CPU)\n", argv[i + 1]);
+                return -1;
+            }
+            scanner_definir_workers((int)n);
+        }
+
+        for (int j = i; j + 2 <= *argc; j++) argv[j] = argv[j + 2];
+        *argc -= 2;
+        i--;
+    }
+    return 0;
+}
+
+/* Sobe o limite flexível de descritores até o rígido: o lote do top, as threads e os
+ * contadores perf mantêm descritores persistentes e dimensionam-se pelo limite atual */
+static void elevar_limite_descritores(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
 int main(int argc, char *argv[]) {
+    elevar_limite_descritores();
+
+    if (extrair_opcoes_globais(&argc, argv) != 0) {
+        return 1;
+    }
+
     if (argc < 2) {
         return menu_interativo(argv[0]);
     }
@@ -471,6 +925,32 @@ int main(int argc, char *argv[]) {
         return cmd_mem(argc, argv);
     } else if (strcmp(cmd, "io") == 0) {
         return cmd_io(argc, argv);
+    } else if (strcmp(cmd, "all") == 0) {
+        return cmd_all(argc, argv);
+    } else if (strcmp(cmd, "top") == 0) {
+        return cmd_top(argc, argv);
+    } else if (strcmp(cmd, "watch") == 0) {
+        return cmd_watch(argc, argv);
+    } else if (strcmp(cmd, "delay") == 0) {
+        return cmd_delay(argc, argv);
+    } else if (strcmp(cmd, "perf") == 0) {
+        return cmd_perf(argc, argv);
+    } else if (strcmp(cmd, "tree") == 0) {
+        return cmd_tree(argc, argv);
+    } else if (strcmp(cmd, "threads") == 0) {
+        return cmd_threads(argc, argv);
+    } else if (strcmp(cmd, "record") == 0) {
+        return cmd_record(argc, argv);
+    } else if (strcmp(cmd, "convert") == 0) {
+        return cmd_convert(argc, argv);
+    } else if (strcmp(cmd, "daemon") == 0) {
+        return cmd_daemon(argc, argv);
+    } else if (strcmp(cmd, "pressure") == 0) {
+        return cmd_pressure(argc, argv);
+    } else if (strcmp(cmd, "pressure-watch") == 0) {
+        return cmd_pressure_watch(argc, argv);
+    } else if (strcmp(cmd, "ctl") == 0) {
+        return cmd_ctl(argc, argv);
     } else if (strcmp(cmd, "cgroup-create") == 0) {
         return cmd_cgroup_create(argc, argv);
     } else if (strcmp(cmd, "cgroup-add") == 0) {
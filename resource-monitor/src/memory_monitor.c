@@ -7,9 +7,17 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <errno.h>
-#include <time.h>
 
 #include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/scheduler.h"
+#include "../include/targets.h"
+#include "../include/ring_buffer.h"
+#include "../include/timestamp.h"
+#include "../include/timeseries.h"
+#include "../include/quantile.h"
+#include "../include/alerts.h"
 
 /* ==================== ESTADO INTERNO ==================== */
 
@@ -24,31 +32,9 @@ static mem_monitor_state_t mem_state = { .pid = -1, .iniciado = 0 };
 
 /* ==================== FUNÇÕES AUXILIARES ==================== */
 
-static void obter_timestamp_mem(char *buffer, size_t size) {
-    time_t now = time(NULL);
-    if (now == (time_t)-1) {
-        snprintf(buffer, size, "ERRO_TIMESTAMP");
-        return;
-    }
-    struct tm tm_info;
-    localtime_r(&now, &tm_info);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &tm_info);
-}
-
-static void dormir_ms_mem(int ms) {
-    struct timespec req = {
-        .tv_sec  = ms / 1000,
-        .tv_nsec = (ms % 1000) * 1000000L
-    };
-    struct timespec rem;
-    while (nanosleep(&req, &rem) == -1 && errno == EINTR) {
-        req = rem;
-    }
-}
-
 // Função auxiliar para ler valores do /proc/*/status
 static unsigned long long ler_valor_status(const char *linha) {
-    char *ptr = strchr(linha, ':');
+    const char *ptr = strchr(linha, ':');
     if (!ptr) return 0;
     
     ptr++; // Pula o ':'
@@ -71,19 +57,28 @@ int mem_ler_processo(pid_t pid, mem_proc_stats_t *out) {
         return -1;
     }
 
-    memset(out, 0, sizeof(*out));
-
     /* -------- /proc/<pid>/status -------- */
-    char caminho[64];
-    snprintf(caminho, sizeof(caminho), "/proc/%d/status", pid);
+    const char *status = proc_cache_ler_pid(pid, PROC_ARQ_STATUS, NULL);
+    if (!status) {
+        memset(out, 0, sizeof(*out));
+        return -1;
+    }
 
-    FILE *fp = fopen(caminho, "r");
-    if (!fp) {
+    /* -------- /proc/<pid>/stat: page faults (opcional) -------- */
+    const char *stat = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+
+    return mem_interpretar_processo(status, stat, out);
+}
+
+int mem_interpretar_processo(const char *status, const char *stat, mem_proc_stats_t *out) {
+    if (!status || !out) {
+        fprintf(stderr, "mem_interpretar_processo: parâmetros inválidos\n");
         return -1;
     }
 
-    char linha[256];
-    while (fgets(linha, sizeof(linha), fp)) {
+    memset(out, 0, sizeof(*out));
+
+    for (const char *linha = status; *linha; ) {
         if (strncmp(linha, "VmRSS:", 6) == 0) {
             out->rss_kb = ler_valor_status(linha);
         } else if (strncmp(linha, "VmSize:", 7) == 0) {
@@ -95,51 +90,26 @@ int mem_ler_processo(pid_t pid, mem_proc_stats_t *out) {
         } else if (strncmp(linha, "VmSwap:", 7) == 0) {
             out->swap_kb = ler_valor_status(linha);
         }
-    }
-    fclose(fp);
 
-    /* -------- /proc/<pid>/stat: page faults -------- */
-    snprintf(caminho, sizeof(caminho), "/proc/%d/stat", pid);
-    fp = fopen(caminho, "r");
-    if (!fp) {
-        return 0; // Page faults são opcionais
+        const char *fim = strchr(linha, '\n');
+        if (!fim) break;
+        linha = fim + 1;
     }
 
-    char buf[1024];
-    if (!fgets(buf, sizeof(buf), fp)) {
-        fclose(fp);
-        return 0;
+    if (!stat) {
+        return 0; // Page faults são opcionais
     }
-    fclose(fp);
 
-    // Encontra o final do nome do processo (entre parênteses)
-    char *p = strrchr(buf, ')');
-    if (!p) {
+    // Campos 10–13 de proc(5): minflt cminflt majflt cmajflt
+    proc_stat_campos_t c;
+    const unsigned long long pedidos = PSTAT_BIT(PSTAT_MINFLT) | PSTAT_BIT(PSTAT_CMINFLT) |
+                                       PSTAT_BIT(PSTAT_MAJFLT) | PSTAT_BIT(PSTAT_CMAJFLT);
+    if (proc_stat_interpretar(stat, pedidos, &c) != 0) {
         return 0;
     }
-    p += 2; // Pula ") "
 
-    // Parsing robusto: procura pelos campos minflt e majflt
-    // Campos: state ppid pgrp sid tty_nr tpgid flags minflt cminflt majflt cmajflt...
-    int campo = 0;
-    char *token = strtok(p, " ");
-    
-    while (token != NULL) {
-        campo++;
-        
-        if (campo == 10) { // minflt
-            out->minor_faults += strtoull(token, NULL, 10);
-        } else if (campo == 11) { // cminflt
-            out->minor_faults += strtoull(token, NULL, 10);
-        } else if (campo == 12) { // majflt
-            out->major_faults += strtoull(token, NULL, 10);
-        } else if (campo == 13) { // cmajflt
-            out->major_faults += strtoull(token, NULL, 10);
-            break; // Já temos o que precisamos
-        }
-        
-        token = strtok(NULL, " ");
-    }
+    out->minor_faults = c.campos[PSTAT_MINFLT] + c.campos[PSTAT_CMINFLT];
+    out->major_faults = c.campos[PSTAT_MAJFLT] + c.campos[PSTAT_CMAJFLT];
 
     return 0;
 }
@@ -149,48 +119,57 @@ int mem_ler_processo(pid_t pid, mem_proc_stats_t *out) {
 int mem_ler_sistema(mem_sys_stats_t *out) {
     if (!out) return -1;
 
-    memset(out, 0, sizeof(*out));
-
-    FILE *fp = fopen("/proc/meminfo", "r");
-    if (!fp) {
+    const char *meminfo = proc_cache_ler_sistema(PROC_SIS_MEMINFO, NULL);
+    if (!meminfo) {
+        memset(out, 0, sizeof(*out));
         perror("mem_ler_sistema: /proc/meminfo");
         return -1;
     }
 
-    char linha[256];
-    
-    while (fgets(linha, sizeof(linha), fp)) {
+    return mem_interpretar_sistema(meminfo, out);
+}
+
+int mem_interpretar_sistema(const char *meminfo, mem_sys_stats_t *out) {
+    if (!meminfo || !out) return -1;
+
+    memset(out, 0, sizeof(*out));
+
+    for (const char *linha = meminfo; *linha; ) {
         // Formato: "MemTotal:       16384000 kB"
-        char *colon = strchr(linha, ':');
-        if (!colon) continue;
-        
-        *colon = '\0'; // Separa chave do valor
-        char *chave = linha;
-        char *valor_str = colon + 1;
-        
+        const char *colon = strchr(linha, ':');
+        if (!colon) break;
+
+        size_t tam_chave = (size_t)(colon - linha);
+        const char *valor_str = colon + 1;
+
         // Pula espaços
         while (*valor_str == ' ' || *valor_str == '\t') valor_str++;
-        
+
         unsigned long long valor = strtoull(valor_str, NULL, 10);
-        
-        if (strcmp(chave, "MemTotal") == 0) {
+
+#define CHAVE_IGUAL(nome) (tam_chave == sizeof(nome) - 1 && strncmp(linha, nome, tam_chave) == 0)
+        if (CHAVE_IGUAL("MemTotal")) {
             out->mem_total_kb = valor;
-        } else if (strcmp(chave, "MemFree") == 0) {
+        } else if (CHAVE_IGUAL("MemFree")) {
             out->mem_free_kb = valor;
-        } else if (strcmp(chave, "MemAvailable") == 0) {
+        } else if (CHAVE_IGUAL("MemAvailable")) {
             out->mem_available_kb = valor;
-        } else if (strcmp(chave, "Buffers") == 0) {
+        } else if (CHAVE_IGUAL("Buffers")) {
             out->buffers_kb = valor;
-        } else if (strcmp(chave, "Cached") == 0) {
+        } else if (CHAVE_IGUAL("Cached")) {
             out->cached_kb = valor;
-        } else if (strcmp(chave, "SwapTotal") == 0) {
+        } else if (CHAVE_IGUAL("SwapTotal")) {
             out->swap_total_kb = valor;
-        } else if (strcmp(chave, "SwapFree") == 0) {
+        } else if (CHAVE_IGUAL("SwapFree")) {
             out->swap_free_kb = valor;
         }
+#undef CHAVE_IGUAL
+
+        const char *fim = strchr(valor_str, '\n');
+        if (!fim) break;
+        linha = fim + 1;
     }
 
-    fclose(fp);
     return 0;
 }
 
@@ -204,6 +183,48 @@ double mem_calcular_percentual_uso(const mem_proc_stats_t *proc,
 
 /* ==================== MONITORAMENTO CONTÍNUO (CSV) ==================== */
 
+/* Uma linha do CSV, montada na amostragem e formatada na thread escritora */
+typedef struct {
+    long long        real_ns;    // formatado na thread escritora
+    int              amostra;
+    mem_proc_stats_t proc;
+    mem_sys_stats_t  sys;
+    double           percentual;
+} registro_mem_t;
+
+static void formatar_registro_mem(FILE *saida, const void *registro, void *ctx) {
+    const registro_mem_t *r = (const registro_mem_t *)registro;
+    (void)ctx;
+    char ts[CARIMBO_TAM];
+    carimbo_formatar(r->real_ns, ts, sizeof(ts));
+    fprintf(saida,
+            "%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.2f\n",
+            ts, r->amostra,
+            r->proc.rss_kb,
+            r->proc.vsz_kb,
+            r->proc.shared_kb,
+            r->proc.swap_kb,
+            r->proc.minor_faults,
+            r->proc.major_faults,
+            r->sys.mem_total_kb,
+            r->sys.mem_free_kb,
+            r->sys.mem_available_kb,
+            r->percentual);
+}
+
+/* Entrega as colunas do CSV ao motor de alertas */
+static void observar_alertas(alertas_t *al, pid_t pid, long long mono_ns,
+                             const mem_proc_stats_t *p, double pct) {
+    if (!al || al->num == 0) return;
+    alertas_observar(al, pid, "rss_kb",           mono_ns, (double)p->rss_kb);
+    alertas_observar(al, pid, "vsz_kb",           mono_ns, (double)p->vsz_kb);
+    alertas_observar(al, pid, "shared_kb",        mono_ns, (double)p->shared_kb);
+    alertas_observar(al, pid, "swap_kb",          mono_ns, (double)p->swap_kb);
+    alertas_observar(al, pid, "minor_faults",     mono_ns, (double)p->minor_faults);
+    alertas_observar(al, pid, "major_faults",     mono_ns, (double)p->major_faults);
+    alertas_observar(al, pid, "proc_mem_percent", mono_ns, pct);
+}
+
 int mem_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
     if (pid <= 0 || intervalo_ms < 1 || amostras <= 0) {
         fprintf(stderr, "mem_monitorar_pid_csv: parâmetros inválidos\n");
@@ -224,6 +245,7 @@ int mem_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
         fprintf(stderr, "mem_monitorar_pid_csv: não foi possível ler memória do sistema\n");
         return -1;
     }
+    alvo_registrar(pid);
 
     fprintf(saida,
         "timestamp,amostra,rss_kb,vsz_kb,shared_kb,swap_kb,"
@@ -236,19 +258,41 @@ int mem_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
                 pid, amostras, intervalo_ms);
     }
 
+    escritor_t escritor;
+    if (escritor_iniciar(&escritor, saida, sizeof(registro_mem_t), ESCRITOR_CAPACIDADE_PADRAO,
+                         formatar_registro_mem, NULL) != 0) {
+        alvo_remover(pid);
+        return -1;
+    }
+
+    quantil_t q_rss, q_percentual, q_latencia;
+    int com_percentis = (quantil_iniciar(&q_rss) == 0) & (quantil_iniciar(&q_percentual) == 0) &
+                        (quantil_iniciar(&q_latencia) == 0);
+    alertas_t *alertas = alertas_padrao();
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    int coletadas = 0;
     for (int i = 0; i < amostras; i++) {
-        dormir_ms_mem(intervalo_ms);
+        long long acordou = agendador_esperar(&ag);
 
-        if (!processo_existe(pid)) {
-            fprintf(stderr, "Processo %d terminou durante monitoramento de memória\n", pid);
-            return -1;
-        }
+        int falhou = mem_ler_processo(pid, &proc_stats) != 0;
 
-        if (mem_ler_processo(pid, &proc_stats) != 0) {
+        // evento de saída do pidfd em vez de checar /proc antes de cada leitura
+        alvo_estado_t estado = alvo_estado(pid);
+        if (estado == ALVO_ENCERRADO || estado == ALVO_RECICLADO) {
+            alvo_relatar_fim(pid, estado, i);
+            break;
+        }
+        if (falhou) {
             fprintf(stderr, "Falha ao ler processo %d (amostra %d)\n", pid, i);
-            return -1;
+            rc = -1;
+            break;
         }
-        
+        coletadas++;
+
         if (mem_ler_sistema(&sys_stats) != 0) {
             fprintf(stderr, "Falha ao ler sistema (amostra %d)\n", i);
             // Continua mesmo com erro no sistema (processo é mais importante)
@@ -256,23 +300,20 @@ int mem_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
 
         double pct = mem_calcular_percentual_uso(&proc_stats, &sys_stats);
 
-        char ts[64];
-        obter_timestamp_mem(ts, sizeof(ts));
-
-        fprintf(saida,
-                "%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.2f\n",
-                ts, i,
-                proc_stats.rss_kb,
-                proc_stats.vsz_kb,
-                proc_stats.shared_kb,
-                proc_stats.swap_kb,
-                proc_stats.minor_faults,
-                proc_stats.major_faults,
-                sys_stats.mem_total_kb,
-                sys_stats.mem_free_kb,
-                sys_stats.mem_available_kb,
-                pct);
-        fflush(saida);
+        registro_mem_t reg;
+        carimbo_t quando;
+        carimbo_agora(&quando);
+        reg.real_ns    = quando.real_ns;
+        reg.amostra    = i;
+        reg.proc       = proc_stats;
+        reg.sys        = sys_stats;
+        reg.percentual = pct;
+        escritor_enviar(&escritor, &reg);
+
+        quantil_registrar(&q_rss, (double)proc_stats.rss_kb);
+        quantil_registrar(&q_percentual, pct);
+        quantil_registrar(&q_latencia, (quando.mono_ns - acordou) / 1000.0);
+        observar_alertas(alertas, pid, quando.mono_ns, &proc_stats, pct);
 
         // Feedback progresso
         if (saida != stdout && (amostras <= 10 || (i + 1) % 10 == 0)) {
@@ -281,11 +322,28 @@ int mem_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida
         }
     }
 
-    if (saida != stdout) {
-        fprintf(stderr, "Monitoramento de memória concluído: %d amostras.\n", amostras);
+    unsigned long descartados = escritor_encerrar(&escritor);
+    if (descartados > 0) {
+        fprintf(stderr, "Saída lenta: %lu amostras de memória descartadas\n", descartados);
     }
-
-    return 0;
+    alvo_remover(pid);
+    if (rc == 0) {
+        agendador_relatar(&ag, "Monitoramento de memória");
+        if (saida != stdout) {
+            fprintf(stderr, "Monitoramento de memória concluído: %d amostras.\n", coletadas);
+        }
+        if (com_percentis && q_rss.contagem > 0) {
+            fprintf(stderr, "Percentis de memória (%llu amostras):\n", q_rss.contagem);
+            quantil_imprimir(stderr, &q_rss,        "rss", "kB");
+            quantil_imprimir(stderr, &q_percentual, "uso", "%");
+            quantil_imprimir(stderr, &q_latencia,   "coleta", "µs");
+        }
+        alertas_relatar(alertas);
+    }
+    quantil_liberar(&q_rss);
+    quantil_liberar(&q_percentual);
+    quantil_liberar(&q_latencia);
+    return rc;
 }
 
 /* ==================== RELATÓRIO SIMPLES ==================== */
@@ -311,6 +369,11 @@ int mem_gerar_relatorio(pid_t pid, FILE *saida) {
 
     double pct = mem_calcular_percentual_uso(&proc, &sys);
 
+    carimbo_t quando;
+    carimbo_agora(&quando);
+    historico_t *hist = hist_padrao();
+    hist_registrar(hist, pid, "rss_kb", quando.real_ns, (double)proc.rss_kb);
+
     fprintf(saida, "\n=== Relatório de Memória do PID %d ===\n", pid);
     fprintf(saida, "RSS:       %llu kB (%.2f MB)\n", proc.rss_kb, proc.rss_kb / 1024.0);
     fprintf(saida, "VSZ:       %llu kB (%.2f MB)\n", proc.vsz_kb, proc.vsz_kb / 1024.0);
@@ -319,6 +382,7 @@ int mem_gerar_relatorio(pid_t pid, FILE *saida) {
     fprintf(saida, "Minor PF:  %llu\n", proc.minor_faults);
     fprintf(saida, "Major PF:  %llu\n", proc.major_faults);
     fprintf(saida, "Uso:       %.2f%% da memória física\n", pct);
+    hist_imprimir_tendencia(saida, hist, pid, "rss_kb", "RSS", "kB");
     fprintf(saida, "--- Sistema ---\n");
     fprintf(saida, "MemTotal:  %llu kB (%.2f GB)\n", sys.mem_total_kb, sys.mem_total_kb / (1024.0 * 1024.0));
     fprintf(saida, "MemFree:   %llu kB\n", sys.mem_free_kb);
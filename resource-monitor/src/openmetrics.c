@@ -0,0 +1,288 @@
+// openmetrics.c - página OpenMetrics montada por tick e servida por um HTTP mínimo
+#define _GNU_SOURCE  // SOCK_CLOEXEC, SOCK_NONBLOCK
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "../include/openmetrics.h"
+
+/* ==================== TEXTO DA PÁGINA ==================== */
+
+static void om_add(om_texto_t *t, const char *fmt, ...) {
+    if (t->erro) return;
+    for (;;) {
+        size_t livre = t->cap - t->tam;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(t->buf ? t->buf + t->tam : NULL, livre, fmt, ap);
+        va_end(ap);
+        if (n < 0) {
+            t->erro = 1;
+            return;
+        }
+        if ((size_t)n < livre) {
+            t->tam += (size_t)n;
+            return;
+        }
+        size_t cap = t->cap ? t->cap * 2 : 16384;
+        while (cap - t->tam <= (size_t)n) cap *= 2;
+        char *novo = (char *)realloc(t->buf, cap);
+        if (!novo) {
+            t->erro = 1;
+            return;
+        }
+        t->buf = novo;
+        t->cap = cap;
+    }
+}
+
+void om_familia(om_texto_t *t, const char *nome, const char *tipo, const char *ajuda) {
+    om_add(t, "# TYPE %s %s\n# HELP %s %s\n", nome, tipo, nome, ajuda);
+}
+
+void om_inteiro(om_texto_t *t, const char *nome, const char *rotulos, unsigned long long valor) {
+    if (rotulos && rotulos[0]) om_add(t, "%s{%s} %llu\n", nome, rotulos, valor);
+    else                       om_add(t, "%s %llu\n", nome, valor);
+}
+
+void om_valor(om_texto_t *t, const char *nome, const char *rotulos, double valor) {
+    if (rotulos && rotulos[0]) om_add(t, "%s{%s} %.15g\n", nome, rotulos, valor);
+    else                       om_add(t, "%s %.15g\n", nome, valor);
+}
+
+void om_escapar(const char *src, char *dst, size_t tam) {
+    size_t j = 0;
+    for (; *src && j + 2 < tam; src++) {
+        if (*src == '\\' || *src == '"') {
+            dst[j++] = '\\';
+            dst[j++] = *src;
+        } else if (*src == '\n') {
+            dst[j++] = '\\';
+            dst[j++] = 'n';
+        } else {
+            dst[j++] = *src;
+        }
+    }
+    if (tam > 0) dst[j] = '\0';
+}
+
+om_pagina_t *om_publicar(om_texto_t *t) {
+    om_add(t, "# EOF\n");
+    om_pagina_t *p = t->erro ? NULL : (om_pagina_t *)malloc(sizeof(*p) + t->tam);
+    if (p) {
+        p->refs = 1;
+        p->tam  = t->tam;
+        memcpy(p->dados, t->buf, t->tam);
+    }
+    t->tam  = 0;
+    t->erro = 0;
+    return p;
+}
+
+void om_pagina_soltar(om_pagina_t *p) {
+    if (p && --p->refs == 0) free(p);
+}
+
+void om_texto_liberar(om_texto_t *t) {
+    free(t->buf);
+    memset(t, 0, sizeof(*t));
+}
+
+/* ==================== ESCUTA ==================== */
+
+static int escuta_unix(const char *caminho) {
+    struct sockaddr_un end;
+    memset(&end, 0, sizeof(end));
+    end.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(end.sun_path)) {
+        fprintf(stderr, "Caminho de socket longo demais: %s\n", caminho);
+        return -1;
+    }
+    strcpy(end.sun_path, caminho);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int rc = bind(fd, (struct sockaddr *)&end, sizeof(end));
+    if (rc != 0 && errno == EADDRINUSE) {
+        // socket órfão de uma execução anterior: só é removido se ninguém atende
+        int teste = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int vivo  = teste >= 0 && connect(teste, (struct sockaddr *)&end, sizeof(end)) == 0;
+        if (teste >= 0) close(teste);
+        if (vivo) {
+            errno = EADDRINUSE;
+        } else {
+            unlink(caminho);
+            rc = bind(fd, (struct sockaddr *)&end, sizeof(end));
+        }
+    }
+    if (rc != 0) {
+        int erro = errno;
+        close(fd);
+        errno = erro;
+        return -1;
+    }
+    return fd;
+}
+
+static int escuta_tcp(const char *endereco) {
+    char host[256] = "127.0.0.1";
+    const char *porta = endereco;
+    const char *dois_pontos = strrchr(endereco, ':');
+    if (dois_pontos) {
+        size_t tam = (size_t)(dois_pontos - endereco);
+        if (tam > 1 && endereco[0] == '[' && endereco[tam - 1] == ']') {  // [::1]:9100
+            endereco++;
+            tam -= 2;
+        }
+        if (tam >= sizeof(host)) return -1;
+        memcpy(host, endereco, tam);
+        host[tam] = '\0';
+        porta = dois_pontos + 1;
+    }
+
+    struct addrinfo dica, *res = NULL;
+    memset(&dica, 0, sizeof(dica));
+    dica.ai_family   = AF_UNSPEC;
+    dica.ai_socktype = SOCK_STREAM;
+    dica.ai_flags    = AI_PASSIVE | AI_NUMERICSERV;
+    int rc = getaddrinfo(host[0] ? host : NULL, porta, &dica, &res);
+    if (rc != 0) {
+        fprintf(stderr, "Endereço de métricas inválido '%s': %s\n", endereco, gai_strerror(rc));
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, ai->ai_protocol);
+        if (fd < 0) continue;
+        int um = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+int om_abrir_escuta(const char *endereco) {
+    if (!endereco || !endereco[0]) return -1;
+
+    int fd = endereco[0] == '/' ? escuta_unix(endereco) : escuta_tcp(endereco);
+    if (fd < 0 || listen(fd, 16) != 0) {
+        fprintf(stderr, "Falha ao abrir o endpoint de métricas %s: %s\n", endereco, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ==================== CONEXÕES ==================== */
+
+static void montar_resposta(om_conexao_t *c, int status, const char *motivo,
+                            const char *tipo, const char *corpo, size_t tam, int cabeca) {
+    int n = snprintf(c->cab, sizeof(c->cab),
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                     "Connection: close\r\n\r\n",
+                     status, motivo, tipo, tam);
+    c->tam_cab     = n > 0 && (size_t)n < sizeof(c->cab) ? (size_t)n : 0;
+    c->corpo       = corpo;
+    c->tam_corpo   = cabeca ? 0 : tam;
+    c->enviado     = 0;
+    c->respondendo = 1;
+}
+
+static void responder_texto(om_conexao_t *c, int status, const char *motivo, const char *corpo) {
+    montar_resposta(c, status, motivo, "text/plain; charset=utf-8", corpo, strlen(corpo), 0);
+}
+
+int om_conexao_ler(om_conexao_t *c, om_pagina_t *pagina) {
+    if (c->respondendo) return 1;
+
+    for (;;) {
+        ssize_t n = recv(c->fd, c->req + c->tam_req, sizeof(c->req) - 1 - c->tam_req, 0);
+        if (n == 0) return -1;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        c->tam_req += (size_t)n;
+        c->req[c->tam_req] = '\0';
+        if (strstr(c->req, "\r\n\r\n") || strstr(c->req, "\n\n")) break;
+        if (c->tam_req >= sizeof(c->req) - 1) {
+            responder_texto(c, 431, "Request Header Fields Too Large", "cabeçalho longo demais\n");
+            return 1;
+        }
+    }
+
+    // só a linha de requisição importa: MÉTODO CAMINHO[?consulta] VERSÃO
+    char metodo[8], caminho[256];
+    if (sscanf(c->req, "%7s %255s", metodo, caminho) != 2) {
+        responder_texto(c, 400, "Bad Request", "requisição inválida\n");
+        return 1;
+    }
+    caminho[strcspn(caminho, "?")] = '\0';
+
+    int cabeca = strcmp(metodo, "HEAD") == 0;
+    if (!cabeca && strcmp(metodo, "GET") != 0) {
+        responder_texto(c, 405, "Method Not Allowed", "use GET\n");
+    } else if (strcmp(caminho, OM_CAMINHO) != 0) {
+        responder_texto(c, 404, "Not Found", "as métricas ficam em " OM_CAMINHO "\n");
+    } else if (!pagina) {
+        responder_texto(c, 503, "Service Unavailable", "página de métricas indisponível\n");
+    } else {
+        pagina->refs++;
+        c->pagina = pagina;
+        montar_resposta(c, 200, "OK", OM_CONTENT_TYPE, pagina->dados, pagina->tam, cabeca);
+    }
+    return 1;
+}
+
+int om_conexao_escrever(om_conexao_t *c) {
+    size_t total = c->tam_cab + c->tam_corpo;
+    while (c->enviado < total) {
+        // cabeçalho e corpo no mesmo sendmsg: em geral, um scrape = uma chamada
+        struct iovec iov[2];
+        int num = 0;
+        if (c->enviado < c->tam_cab) {
+            iov[num].iov_base = c->cab + c->enviado;
+            iov[num].iov_len  = c->tam_cab - c->enviado;
+            num++;
+        }
+        size_t ja = c->enviado > c->tam_cab ? c->enviado - c->tam_cab : 0;
+        if (ja < c->tam_corpo) {
+            iov[num].iov_base = (void *)(c->corpo + ja);
+            iov[num].iov_len  = c->tam_corpo - ja;
+            num++;
+        }
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = (size_t)num;
+
+        ssize_t n = sendmsg(c->fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        c->enviado += (size_t)n;
+    }
+    return 1;
+}
+
+void om_conexao_fechar(om_conexao_t *c) {
+    if (c->fd >= 0) close(c->fd);
+    om_pagina_soltar(c->pagina);
+    memset(c, 0, sizeof(*c));
+    c->fd = -1;
+}
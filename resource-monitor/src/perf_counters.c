@@ -0,0 +1,336 @@
+// perf_counters.c - eventos de software do perf_event_open por thread, lidos em grupo
+#define _GNU_SOURCE  // syscall
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "../include/perf_counters.h"
+#include "../include/scheduler.h"
+#include "../include/targets.h"
+#include "../include/timestamp.h"
+#include "../include/formatter.h"
+
+static const unsigned long long CONFIGS[PERF_NUM_EVENTOS] = {
+    PERF_COUNT_SW_TASK_CLOCK,
+    PERF_COUNT_SW_CONTEXT_SWITCHES,
+    PERF_COUNT_SW_CPU_MIGRATIONS,
+    PERF_COUNT_SW_PAGE_FAULTS,
+    PERF_COUNT_SW_PAGE_FAULTS_MAJ,
+};
+
+static const char *const NOMES[PERF_NUM_EVENTOS] = {
+    "task_clock", "context_switches", "cpu_migrations", "page_faults", "major_faults",
+};
+
+const char *perf_nome_evento(perf_evento_t ev) {
+    return (unsigned)ev < PERF_NUM_EVENTOS ? NOMES[ev] : "?";
+}
+
+int perf_evento_disponivel(const perf_contadores_t *pc, perf_evento_t ev) {
+    if ((unsigned)ev >= PERF_NUM_EVENTOS) return 0;
+    // com exclude_kernel o contador existe, mas o evento nunca ocorre em modo usuário
+    return !(pc && pc->so_usuario &&
+             (ev == PERF_EV_TROCAS_CONTEXTO || ev == PERF_EV_MIGRACOES));
+}
+
+/* ==================== GRUPOS POR THREAD ==================== */
+
+static void fechar_grupo(perf_thread_t *t) {
+    // membros antes do líder
+    for (int ev = PERF_NUM_EVENTOS - 1; ev >= 0; ev--) {
+        if (t->fds[ev] >= 0) close(t->fds[ev]);
+        t->fds[ev] = -1;
+    }
+}
+
+static int abrir_grupo(const perf_contadores_t *pc, pid_t tid, perf_thread_t *t) {
+    t->tid   = tid;
+    t->visto = 1;
+    for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) t->fds[ev] = -1;
+
+    for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_SOFTWARE;
+        attr.config         = CONFIGS[ev];
+        attr.read_format    = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = pc->so_usuario ? 1 : 0;
+        attr.exclude_hv     = pc->so_usuario ? 1 : 0;
+
+        int fd = (int)syscall(SYS_perf_event_open, &attr, tid, -1,
+                              ev == 0 ? -1 : t->fds[0], PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0) {
+            int erro = errno;
+            fechar_grupo(t);
+            errno = erro;
+            return -1;
+        }
+        t->fds[ev] = fd;
+    }
+    return 0;
+}
+
+/* Um read() devolve os cinco contadores do grupo: { nr, valor[0..nr-1] } */
+static int ler_grupo(const perf_thread_t *t, unsigned long long valores[PERF_NUM_EVENTOS]) {
+    uint64_t buf[1 + PERF_NUM_EVENTOS];
+    ssize_t n = read(t->fds[0], buf, sizeof(buf));
+    if (n < (ssize_t)sizeof(uint64_t)) return -1;
+
+    uint64_t nr = buf[0];
+    if (nr > PERF_NUM_EVENTOS || (size_t)n < (1 + nr) * sizeof(uint64_t)) return -1;
+    for (uint64_t ev = 0; ev < nr; ev++) valores[ev] = buf[1 + ev];
+    for (uint64_t ev = nr; ev < PERF_NUM_EVENTOS; ev++) valores[ev] = 0;
+    return 0;
+}
+
+static int comparar_tid(const void *a, const void *b) {
+    pid_t x = ((const perf_thread_t *)a)->tid;
+    pid_t y = ((const perf_thread_t *)b)->tid;
+    return (x > y) - (x < y);
+}
+
+/* Sincroniza os grupos com /proc/<pid>/task (-1 se o processo não existe mais) */
+static int reconciliar(perf_contadores_t *pc) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/task", pc->pid);
+    DIR *dir = opendir(caminho);
+    if (!dir) return -1;
+
+    for (size_t k = 0; k < pc->num; k++) pc->threads[k].visto = 0;
+    size_t conhecidas = pc->num;
+    pc->sem_fd = 0;
+
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        char *fim;
+        long tid = strtol(ent->d_name, &fim, 10);
+        if (*fim != '\0' || tid <= 0) continue;
+
+        perf_thread_t chave;
+        chave.tid = (pid_t)tid;
+        perf_thread_t *t = conhecidas == 0 ? NULL
+                         : (perf_thread_t *)bsearch(&chave, pc->threads, conhecidas,
+                                                    sizeof(perf_thread_t), comparar_tid);
+        if (t) {
+            t->visto = 1;
+            continue;
+        }
+
+        if (pc->num == pc->cap) {
+            size_t cap = pc->cap ? pc->cap * 2 : 16;
+            perf_thread_t *novo = (perf_thread_t *)realloc(pc->threads, cap * sizeof(*novo));
+            if (!novo) break;
+            pc->threads = novo;
+            pc->cap     = cap;
+        }
+        if (abrir_grupo(pc, (pid_t)tid, &pc->threads[pc->num]) == 0) {
+            pc->num++;
+        } else if (errno == EMFILE || errno == ENFILE) {
+            pc->sem_fd++;  // a thread fica de fora; as demais continuam contadas
+        }
+        // ESRCH: a thread saiu entre o readdir e a abertura
+    }
+    closedir(dir);
+
+    // threads que saíram: a contagem final vai para 'encerradas' e o grupo é fechado
+    size_t j = 0;
+    for (size_t k = 0; k < pc->num; k++) {
+        perf_thread_t *t = &pc->threads[k];
+        if (!t->visto) {
+            unsigned long long v[PERF_NUM_EVENTOS];
+            if (ler_grupo(t, v) == 0) {
+                for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) pc->encerradas[ev] += v[ev];
+            }
+            fechar_grupo(t);
+            continue;
+        }
+        pc->threads[j++] = *t;
+    }
+    pc->num = j;
+
+    if (pc->num > conhecidas) {
+        qsort(pc->threads, pc->num, sizeof(perf_thread_t), comparar_tid);
+    }
+    return 0;
+}
+
+/* ==================== API ==================== */
+
+int perf_abrir(perf_contadores_t *pc, pid_t pid) {
+    if (!pc || pid <= 0) return -1;
+    memset(pc, 0, sizeof(*pc));
+    pc->pid = pid;
+
+    // sonda com a thread principal para separar "sem permissão" de "sem suporte"
+    perf_thread_t sonda;
+    if (abrir_grupo(pc, pid, &sonda) != 0 && (errno == EACCES || errno == EPERM)) {
+        pc->so_usuario = 1;  // perf_event_paranoid >= 2: só o modo usuário é permitido
+        if (abrir_grupo(pc, pid, &sonda) != 0 && errno != ESRCH) {
+            fprintf(stderr, "perf_event_open negado para o PID %d: %s "
+                            "(kernel.perf_event_paranoid ou CAP_PERFMON)\n", pid, strerror(errno));
+            return -1;
+        }
+    }
+    if (sonda.fds[0] < 0) {
+        if (errno == ESRCH) fprintf(stderr, "Processo %d não existe.\n", pid);
+        else fprintf(stderr, "perf_event_open indisponível: %s\n", strerror(errno));
+        return -1;
+    }
+    fechar_grupo(&sonda);
+
+    if (reconciliar(pc) != 0) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        perf_fechar(pc);
+        return -1;
+    }
+    return 0;
+}
+
+void perf_fechar(perf_contadores_t *pc) {
+    if (!pc) return;
+    for (size_t k = 0; k < pc->num; k++) fechar_grupo(&pc->threads[k]);
+    free(pc->threads);
+    pc->threads = NULL;
+    pc->num = pc->cap = 0;
+}
+
+int perf_ler(perf_contadores_t *pc, perf_leitura_t *out) {
+    if (!pc || !out) return -1;
+    if (reconciliar(pc) != 0) return -1;
+
+    memcpy(out->valores, pc->encerradas, sizeof(out->valores));
+    out->threads = 0;
+    for (size_t k = 0; k < pc->num; k++) {
+        unsigned long long v[PERF_NUM_EVENTOS];
+        if (ler_grupo(&pc->threads[k], v) != 0) continue;
+        for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) out->valores[ev] += v[ev];
+        out->threads++;
+    }
+    return 0;
+}
+
+/* ==================== LOOP CSV ==================== */
+
+// cpu_processo_percent na mesma escala do comando cpu (% da máquina), mas em ns
+static const saida_campo_t CAMPOS_PERF[] = {
+    { "timestamp",            CAMPO_TEXTO, 0 },
+    { "amostra",              CAMPO_INT,   0 },
+    { "cpu_processo_percent", CAMPO_FIXO,  2 },
+    { "task_clock_ms_s",      CAMPO_FIXO,  3 },
+    { "context_switches_ps",  CAMPO_FIXO,  1 },
+    { "cpu_migrations_ps",    CAMPO_FIXO,  1 },
+    { "page_faults_ps",       CAMPO_FIXO,  1 },
+    { "major_faults_ps",      CAMPO_FIXO,  1 },
+    { "threads",              CAMPO_INT,   0 },
+};
+#define NUM_CAMPOS_PERF (sizeof(CAMPOS_PERF) / sizeof(CAMPOS_PERF[0]))
+
+int perf_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
+    if (pid <= 0 || intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "perf_monitorar_pid_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    perf_contadores_t pc;
+    perf_leitura_t antes, depois;
+    if (perf_abrir(&pc, pid) != 0) return -1;
+    if (perf_ler(&pc, &antes) != 0) {
+        fprintf(stderr, "Processo %d não existe.\n", pid);
+        perf_fechar(&pc);
+        return -1;
+    }
+    carimbo_t quando;
+    carimbo_agora(&quando);
+    long long mono_antes = quando.mono_ns;
+    alvo_registrar(pid);
+
+    if (pc.so_usuario) {
+        fprintf(stderr, "Aviso: perf_event_paranoid só permite contar o modo usuário: "
+                        "context_switches_ps e cpu_migrations_ps ficam vazios "
+                        "(eventos do kernel); task_clock continua incluindo o tempo de kernel\n");
+    }
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+
+    fflush(saida);
+    saida_t out;
+    if (saida_abrir(&out, fileno(saida), saida_formato_padrao(), CAMPOS_PERF, NUM_CAMPOS_PERF,
+                    0, intervalo_ms < SAIDA_FLUSH_PADRAO_MS ? -1 : 0) != 0) {
+        alvo_remover(pid);
+        perf_fechar(&pc);
+        return -1;
+    }
+    saida_cabecalho(&out);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0, sem_fd_avisado = 0;
+    for (int i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        int falhou = perf_ler(&pc, &depois) != 0;
+
+        alvo_estado_t estado = alvo_estado(pid);
+        if (estado == ALVO_ENCERRADO || estado == ALVO_RECICLADO) {
+            alvo_relatar_fim(pid, estado, i);
+            break;
+        }
+        if (falhou) {
+            fprintf(stderr, "Falha ao ler contadores do processo %d (amostra %d)\n", pid, i);
+            rc = -1;
+            break;
+        }
+
+        // um carimbo por amostra: o texto da linha e o fim do intervalo das taxas
+        carimbo_agora(&quando);
+        long long mono_depois = quando.mono_ns;
+        double s = (double)(mono_depois - mono_antes) / 1e9;
+        if (s <= 0.0) s = 1e-9;
+
+        double d[PERF_NUM_EVENTOS];
+        for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) {
+            d[ev] = depois.valores[ev] > antes.valores[ev]
+                        ? (double)(depois.valores[ev] - antes.valores[ev]) : 0.0;
+        }
+
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(quando.real_ns, ts, sizeof(ts));
+        saida_texto(&out, ts);
+        saida_int(&out, i);
+        saida_fixo(&out, d[PERF_EV_TASK_CLOCK] / 1e9 / s / (double)ncpu * 100.0);
+        saida_fixo(&out, d[PERF_EV_TASK_CLOCK] / 1e6 / s);
+        for (int ev = PERF_EV_TROCAS_CONTEXTO; ev < PERF_NUM_EVENTOS; ev++) {
+            // campo vazio, não 0: "não medido" não pode parecer "nenhuma troca"
+            if (perf_evento_disponivel(&pc, (perf_evento_t)ev)) saida_fixo(&out, d[ev] / s);
+            else saida_nulo(&out);
+        }
+        saida_int(&out, depois.threads);
+        saida_fim_linha(&out);
+        if (intervalo_ms >= SAIDA_FLUSH_PADRAO_MS) saida_descarregar(&out);
+
+        if (pc.sem_fd > 0 && !sem_fd_avisado) {
+            fprintf(stderr, "Aviso: %d thread(s) sem contador (limite de descritores, ulimit -n)\n",
+                    pc.sem_fd);
+            sem_fd_avisado = 1;
+        }
+        antes      = depois;
+        mono_antes = mono_depois;
+    }
+
+    if (saida_fechar(&out) != 0 && rc == 0) rc = -1;
+    alvo_remover(pid);
+    agendador_relatar(&ag, "Monitoramento perf");
+    perf_fechar(&pc);
+    return rc;
+}
@@ -0,0 +1,503 @@
+// proc_batch.c - leitura em lote de /proc/<pid>/{stat,status,io} (io_uring ou pread)
+#define _GNU_SOURCE  // syscall()
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <linux/io_uring.h>
+
+#include "../include/proc_batch.h"
+
+#ifndef SYS_io_uring_setup
+#define SYS_io_uring_setup 425
+#endif
+#ifndef SYS_io_uring_enter
+#define SYS_io_uring_enter 426
+#endif
+
+/* ==================== CONFIGURAÇÃO ==================== */
+
+#define PROC_LOTE_ANEL      1024            // entradas do anel (leituras por submissão)
+#define PROC_LOTE_RESERVA   64              // descritores deixados para o resto do programa
+#define PROC_LOTE_BUF_MAX   (1024 * 1024)
+
+static const size_t TAM_INICIAL[PROC_ARQ_POR_PID] = { 1024, 4096, 512 };
+static const char *const NOMES[PROC_ARQ_POR_PID]  = { "stat", "status", "io" };
+
+static lote_modo_t modo_padrao = LOTE_PREAD;
+
+/* ==================== ANEL (io_uring sem liburing) ==================== */
+
+typedef struct {
+    int       fd;
+    unsigned  entradas;
+
+    void     *sq_mem;
+    size_t    sq_tam;
+    void     *cq_mem;               // == sq_mem com IORING_FEAT_SINGLE_MMAP
+    size_t    cq_tam;
+    struct io_uring_sqe *sqes;
+    size_t    sqes_tam;
+
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+} anel_t;
+
+static void anel_fechar(anel_t *a) {
+    if (!a) return;
+    if (a->sqes && a->sqes != MAP_FAILED) munmap(a->sqes, a->sqes_tam);
+    if (a->cq_mem && a->cq_mem != MAP_FAILED && a->cq_mem != a->sq_mem) {
+        munmap(a->cq_mem, a->cq_tam);
+    }
+    if (a->sq_mem && a->sq_mem != MAP_FAILED) munmap(a->sq_mem, a->sq_tam);
+    if (a->fd >= 0) close(a->fd);
+    free(a);
+}
+
+static anel_t *anel_abrir(unsigned entradas) {
+    anel_t *a = (anel_t *)calloc(1, sizeof(*a));
+    if (!a) return NULL;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    a->fd = (int)syscall(SYS_io_uring_setup, entradas, &p);
+    if (a->fd < 0) {  // ENOSYS, EPERM (io_uring_disabled/seccomp)...
+        free(a);
+        return NULL;
+    }
+    a->entradas = p.sq_entries;
+
+    a->sq_tam = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    a->cq_tam = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (a->cq_tam > a->sq_tam) a->sq_tam = a->cq_tam;
+        a->cq_tam = a->sq_tam;
+    }
+
+    a->sq_mem = mmap(NULL, a->sq_tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     a->fd, IORING_OFF_SQ_RING);
+    if (a->sq_mem == MAP_FAILED) goto falha;
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        a->cq_mem = a->sq_mem;
+    } else {
+        a->cq_mem = mmap(NULL, a->cq_tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         a->fd, IORING_OFF_CQ_RING);
+        if (a->cq_mem == MAP_FAILED) goto falha;
+    }
+
+    a->sqes_tam = p.sq_entries * sizeof(struct io_uring_sqe);
+    a->sqes = (struct io_uring_sqe *)mmap(NULL, a->sqes_tam, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, a->fd, IORING_OFF_SQES);
+    if (a->sqes == MAP_FAILED) goto falha;
+
+    char *sq = (char *)a->sq_mem;
+    char *cq = (char *)a->cq_mem;
+    a->sq_head  = (unsigned *)(sq + p.sq_off.head);
+    a->sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    a->sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    a->sq_array = (unsigned *)(sq + p.sq_off.array);
+    a->cq_head  = (unsigned *)(cq + p.cq_off.head);
+    a->cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    a->cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    a->cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return a;
+
+falha:
+    anel_fechar(a);
+    return NULL;
+}
+
+/* user_data: índice do alvo nos bits altos, arquivo nos 2 bits baixos */
+#define UD_MONTAR(i, arq) (((unsigned long long)(i) << 2) | (unsigned long long)(arq))
+#define UD_ALVO(ud)       ((size_t)((ud) >> 2))
+#define UD_ARQ(ud)        ((int)((ud) & 3u))
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static void fechar_alvo(proc_lote_t *l, lote_alvo_t *a) {
+    for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) {
+        if (a->fd[arq] >= 0) {
+            close(a->fd[arq]);
+            a->fd[arq] = -1;
+            __atomic_fetch_sub(&l->fds_abertos, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void liberar_alvo(proc_lote_t *l, lote_alvo_t *a) {
+    fechar_alvo(l, a);
+    for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) free(a->buf[arq]);
+}
+
+static void iniciar_alvo(lote_alvo_t *a, pid_t pid) {
+    memset(a, 0, sizeof(*a));
+    a->pid = pid;
+    for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) {
+        a->fd[arq]  = -1;
+        a->tam[arq] = -ENOENT;
+    }
+}
+
+static int garantir_buffer(lote_alvo_t *a, int arq) {
+    if (a->buf[arq]) return 0;
+    a->buf[arq] = (char *)malloc(TAM_INICIAL[arq]);
+    if (!a->buf[arq]) return -1;
+    a->cap[arq] = TAM_INICIAL[arq];
+    return 0;
+}
+
+/* Abre o descritor persistente se ainda couber no orçamento; -1 = usar leitura avulsa */
+static int abrir_persistente(proc_lote_t *l, lote_alvo_t *a, int arq) {
+    if (a->fd[arq] >= 0) return a->fd[arq];
+    if (__atomic_load_n(&l->fds_abertos, __ATOMIC_RELAXED) >= l->fds_max) {
+        errno = EMFILE;
+        return -1;
+    }
+
+    char caminho[48];
+    snprintf(caminho, sizeof(caminho), "%d/%s", a->pid, NOMES[arq]);
+    a->fd[arq] = openat(l->dirfd, caminho, O_RDONLY | O_CLOEXEC);
+    if (a->fd[arq] < 0) return -1;
+    __atomic_fetch_add(&l->fds_abertos, 1, __ATOMIC_RELAXED);
+    return a->fd[arq];
+}
+
+/*
+ * Caminho síncrono de um arquivo: pread no descritor persistente (crescendo o
+ * buffer se encher) ou open/read/close quando não há descritor. Um descritor
+ * que devolve ESRCH pertence a um processo que terminou: é reaberto uma vez,
+ * o que cobre um PID reciclado.
+ */
+static void ler_sincrono(proc_lote_t *l, lote_alvo_t *a, int arq) {
+    if (garantir_buffer(a, arq) != 0) {
+        a->tam[arq] = -ENOMEM;
+        return;
+    }
+
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        int fd = abrir_persistente(l, a, arq);
+        int avulso = 0;
+        if (fd < 0) {
+            if (errno == ENOENT || errno == ESRCH) {
+                a->tam[arq] = -errno;
+                return;
+            }
+            char caminho[48];
+            snprintf(caminho, sizeof(caminho), "%d/%s", a->pid, NOMES[arq]);
+            fd = openat(l->dirfd, caminho, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                a->tam[arq] = -errno;
+                return;
+            }
+            avulso = 1;
+        }
+
+        ssize_t n;
+        for (;;) {
+            n = pread(fd, a->buf[arq], a->cap[arq] - 1, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n >= 0 && (size_t)n == a->cap[arq] - 1 && a->cap[arq] < PROC_LOTE_BUF_MAX) {
+                char *novo = (char *)realloc(a->buf[arq], a->cap[arq] * 2);
+                if (!novo) break;
+                a->buf[arq] = novo;
+                a->cap[arq] *= 2;
+                continue;
+            }
+            break;
+        }
+        int erro = errno;
+        if (avulso) close(fd);
+
+        if (n >= 0) {
+            a->buf[arq][n] = '\0';
+            a->tam[arq] = (long)n;
+            return;
+        }
+        a->tam[arq] = -erro;
+        if (avulso || erro != ESRCH) return;
+
+        close(a->fd[arq]);  // descritor de um processo que já terminou
+        a->fd[arq] = -1;
+        __atomic_fetch_sub(&l->fds_abertos, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* ==================== MODO URING ==================== */
+
+/* Marca o resultado de uma conclusão; devolve 1 se o arquivo precisa do caminho síncrono */
+static int concluir(lote_alvo_t *a, int arq, int res) {
+    if (res < 0) {
+        a->tam[arq] = res;
+        return res == -ESRCH || res == -EINTR || res == -EAGAIN;
+    }
+    if ((size_t)res == a->cap[arq] - 1 && a->cap[arq] < PROC_LOTE_BUF_MAX) {
+        return 1;  // pode ter truncado: relê com buffer maior
+    }
+    a->buf[arq][res] = '\0';
+    a->tam[arq] = res;
+    return 0;
+}
+
+/*
+ * Falha no meio de um bloco: as leituras já consumidas pelo kernel ainda escrevem nos buffers
+ * dos alvos, então é preciso colher todas antes de devolver o controle. As SQEs que o kernel
+ * não chegou a consumir são retiradas do anel. Se nem a espera funcionar, o anel é fechado
+ * (o kernel cancela o que restou) e o lote segue em pread.
+ */
+static void drenar_uring(proc_lote_t *l, unsigned tail, unsigned colhidos) {
+    anel_t *an = (anel_t *)l->anel;
+
+    unsigned consumidos = __atomic_load_n(an->sq_head, __ATOMIC_ACQUIRE);
+    __atomic_store_n(an->sq_tail, consumidos, __ATOMIC_RELEASE);
+    unsigned faltam = consumidos - tail - colhidos;
+
+    while (faltam > 0) {
+        long r = syscall(SYS_io_uring_enter, an->fd, 0, faltam, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (r < 0 && errno != EINTR) {
+            anel_fechar(an);
+            l->anel = NULL;
+            l->modo = LOTE_PREAD;
+            return;
+        }
+        unsigned head = *an->cq_head;
+        unsigned fim  = __atomic_load_n(an->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != fim && faltam > 0; head++) faltam--;
+        __atomic_store_n(an->cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+static int ler_uring(proc_lote_t *l) {
+    anel_t *an = (anel_t *)l->anel;
+    size_t i = 0;
+    int    arq = 0;
+
+    for (;;) {
+        /* ---- preenche o anel com o próximo bloco de leituras ---- */
+        unsigned tail = *an->sq_tail;
+        unsigned enviados = 0;
+        while (i < l->num_alvos && enviados < an->entradas) {
+            lote_alvo_t *a = &l->alvos[i];
+            if ((l->mascara & LOTE_BIT(arq)) && garantir_buffer(a, arq) == 0) {
+                int fd = abrir_persistente(l, a, arq);
+                if (fd >= 0) {
+                    unsigned idx = (tail + enviados) & *an->sq_mask;
+                    struct io_uring_sqe *sqe = &an->sqes[idx];
+                    memset(sqe, 0, sizeof(*sqe));
+                    sqe->opcode    = IORING_OP_READ;
+                    sqe->fd        = fd;
+                    sqe->addr      = (unsigned long long)(uintptr_t)a->buf[arq];
+                    sqe->len       = (unsigned)(a->cap[arq] - 1);
+                    sqe->off       = 0;
+                    sqe->user_data = UD_MONTAR(i, arq);
+                    an->sq_array[idx] = idx;
+                    enviados++;
+                } else {
+                    ler_sincrono(l, a, arq);  // sem descritor persistente
+                }
+            }
+            if (++arq == PROC_ARQ_POR_PID) {
+                arq = 0;
+                i++;
+            }
+        }
+        if (enviados == 0) break;
+        __atomic_store_n(an->sq_tail, tail + enviados, __ATOMIC_RELEASE);
+
+        /* ---- uma syscall: submete o bloco e espera todas as conclusões ---- */
+        unsigned faltam = enviados;
+        while (faltam > 0) {
+            long r = syscall(SYS_io_uring_enter, an->fd, faltam == enviados ? enviados : 0,
+                             faltam, IORING_ENTER_GETEVENTS, NULL, 0);
+            if (r < 0 && errno != EINTR) {
+                fprintf(stderr, "proc_lote_ler: io_uring_enter: %s\n", strerror(errno));
+                drenar_uring(l, tail, enviados - faltam);
+                return -1;
+            }
+
+            unsigned head = *an->cq_head;
+            unsigned fim  = __atomic_load_n(an->cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != fim; head++) {
+                struct io_uring_cqe *cqe = &an->cqes[head & *an->cq_mask];
+                lote_alvo_t *a = &l->alvos[UD_ALVO(cqe->user_data)];
+                int          q = UD_ARQ(cqe->user_data);
+
+                if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+                    l->modo = LOTE_PREAD;  // kernel < 5.6: sem IORING_OP_READ
+                }
+                if (concluir(a, q, cqe->res)) ler_sincrono(l, a, q);
+                faltam--;
+            }
+            __atomic_store_n(an->cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    if (l->modo == LOTE_PREAD) {
+        anel_fechar(an);
+        l->anel = NULL;
+        fprintf(stderr, "proc_lote: kernel sem IORING_OP_READ, usando pread\n");
+    }
+    return 0;
+}
+
+/* ==================== API ==================== */
+
+int proc_lote_iniciar(proc_lote_t *l, int dirfd, unsigned mascara, lote_modo_t modo) {
+    mascara &= LOTE_BIT(PROC_ARQ_POR_PID) - 1;
+    if (!l || dirfd < 0 || mascara == 0) return -1;
+    memset(l, 0, sizeof(*l));
+    l->dirfd   = dirfd;
+    l->mascara = mascara;
+    l->modo    = LOTE_PREAD;
+
+    /* descritores persistentes até o limite flexível atual (quem chama decide se o eleva) */
+    struct rlimit rl;
+    l->fds_max = 256;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 &&
+        rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur > PROC_LOTE_RESERVA * 2) {
+        l->fds_max = (long)(rl.rlim_cur - PROC_LOTE_RESERVA);
+    }
+
+    if (modo == LOTE_URING) {
+        l->anel = anel_abrir(PROC_LOTE_ANEL);
+        if (l->anel) l->modo = LOTE_URING;
+    }
+    return 0;
+}
+
+void proc_lote_destruir(proc_lote_t *l) {
+    if (!l) return;
+    for (size_t i = 0; i < l->num_alvos; i++) liberar_alvo(l, &l->alvos[i]);
+    free(l->alvos);
+    anel_fechar((anel_t *)l->anel);
+    memset(l, 0, sizeof(*l));
+}
+
+static int comparar_pid(const void *a, const void *b) {
+    pid_t x = *(const pid_t *)a, y = *(const pid_t *)b;
+    return (x > y) - (x < y);
+}
+
+int proc_lote_definir(proc_lote_t *l, const pid_t *pids, size_t n) {
+    if (!l || (!pids && n > 0)) return -1;
+
+    /* readdir do /proc já entrega PIDs em ordem; só ordena se precisar */
+    pid_t *ordenados = NULL;
+    for (size_t k = 1; k < n; k++) {
+        if (pids[k] < pids[k - 1]) {
+            ordenados = (pid_t *)malloc(n * sizeof(pid_t));
+            if (!ordenados) return -1;
+            memcpy(ordenados, pids, n * sizeof(pid_t));
+            qsort(ordenados, n, sizeof(pid_t), comparar_pid);
+            pids = ordenados;
+            break;
+        }
+    }
+
+    lote_alvo_t *novos = (lote_alvo_t *)malloc((n ? n : 1) * sizeof(lote_alvo_t));
+    if (!novos) {
+        free(ordenados);
+        return -1;
+    }
+
+    /* intercala as duas listas ordenadas: quem continua leva descritores e buffers */
+    size_t i = 0;
+    for (size_t j = 0; j < n; j++) {
+        while (i < l->num_alvos && l->alvos[i].pid < pids[j]) {
+            liberar_alvo(l, &l->alvos[i++]);
+        }
+        if (i < l->num_alvos && l->alvos[i].pid == pids[j]) {
+            novos[j] = l->alvos[i++];
+        } else {
+            iniciar_alvo(&novos[j], pids[j]);
+        }
+    }
+    while (i < l->num_alvos) liberar_alvo(l, &l->alvos[i++]);
+
+    free(l->alvos);
+    free(ordenados);
+    l->alvos     = novos;
+    l->num_alvos = n;
+    l->cap_alvos = n;
+    return 0;
+}
+
+int proc_lote_ler(proc_lote_t *l) {
+    if (!l) return -1;
+
+    for (size_t i = 0; i < l->num_alvos; i++) {
+        for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) l->alvos[i].tam[arq] = -ENOENT;
+    }
+
+    if (l->modo == LOTE_URING && ler_uring(l) != 0) return -1;
+    if (l->modo == LOTE_PREAD) {
+        for (size_t i = 0; i < l->num_alvos; i++) {
+            for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) {
+                // no fallback pós-uring só relê o que ainda não foi lido
+                if ((l->mascara & LOTE_BIT(arq)) && l->alvos[i].tam[arq] < 0) {
+                    ler_sincrono(l, &l->alvos[i], arq);
+                }
+            }
+        }
+    }
+
+    int primeiro = 0;
+    while (!(l->mascara & LOTE_BIT(primeiro))) primeiro++;
+
+    int lidos = 0;
+    for (size_t i = 0; i < l->num_alvos; i++) {
+        if (l->alvos[i].tam[primeiro] >= 0) lidos++;
+    }
+    return lidos;
+}
+
+void proc_lote_ler_faixa(proc_lote_t *l, size_t inicio, size_t fim) {
+    if (!l || fim > l->num_alvos) return;
+    for (size_t i = inicio; i < fim; i++) {
+        for (int arq = 0; arq < PROC_ARQ_POR_PID; arq++) {
+            l->alvos[i].tam[arq] = -ENOENT;
+            if (l->mascara & LOTE_BIT(arq)) ler_sincrono(l, &l->alvos[i], arq);
+        }
+    }
+}
+
+const char *proc_lote_conteudo(const proc_lote_t *l, size_t i, proc_arquivo_t arq) {
+    if (!l || i >= l->num_alvos || (int)arq < 0 || arq >= PROC_ARQ_POR_PID) return NULL;
+    const lote_alvo_t *a = &l->alvos[i];
+    return (a->tam[arq] >= 0) ? a->buf[arq] : NULL;
+}
+
+int proc_lote_selecionar(const char *nome) {
+    if (nome && strcmp(nome, "pread") == 0) {
+        modo_padrao = LOTE_PREAD;
+    } else if (nome && strcmp(nome, "uring") == 0) {
+        modo_padrao = LOTE_URING;
+    } else {
+        fprintf(stderr, "Modo de leitura desconhecido: %s (use pread ou uring)\n",
+                nome ? nome : "(nulo)");
+        return -1;
+    }
+    return 0;
+}
+
+lote_modo_t proc_lote_padrao(void) {
+    return modo_padrao;
+}
+
+const char *proc_lote_modo_nome(lote_modo_t modo) {
+    return (modo == LOTE_URING) ? "uring" : "pread";
+}
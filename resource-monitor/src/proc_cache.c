@@ -0,0 +1,248 @@
+// proc_cache.c - descritores persistentes para arquivos quentes do /proc
+#define _POSIX_C_SOURCE 200809L  // pread/O_CLOEXEC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/types.h>
+
+#include "../include/proc_cache.h"
+
+/* ==================== CONFIGURAÇÃO ==================== */
+
+#define PROC_CACHE_MAX_PIDS   32            // PIDs mantidos abertos ao mesmo tempo
+#define PROC_CACHE_BUF_MAX    (1024 * 1024) // limite de crescimento de um buffer
+
+/* Tamanho inicial dos buffers (crescem sob demanda, ex.: /proc/stat em máquinas com muitos cores) */
+static const size_t TAM_INICIAL_PID[PROC_ARQ_POR_PID] = { 1024, 4096, 512 };
+static const size_t TAM_INICIAL_SIS[PROC_SIS_TOTAL]   = { 8192, 4096, 256, 256, 256 };
+
+static const char *const NOMES_PID[PROC_ARQ_POR_PID] = { "stat", "status", "io" };
+static const char *const CAMINHOS_SIS[PROC_SIS_TOTAL] = {
+    "/proc/stat", "/proc/meminfo",
+    "/proc/pressure/cpu", "/proc/pressure/memory", "/proc/pressure/io",
+};
+
+/* ==================== ESTADO INTERNO ==================== */
+
+typedef struct {
+    int    fd;
+    char  *buf;
+    size_t cap;
+} proc_arquivo_aberto_t;
+
+typedef struct {
+    pid_t                 pid;       // -1 = slot livre
+    unsigned long         ultimo_uso;
+    proc_arquivo_aberto_t arq[PROC_ARQ_POR_PID];
+} proc_cache_entrada_t;
+
+static proc_cache_entrada_t  g_entradas[PROC_CACHE_MAX_PIDS];
+static proc_arquivo_aberto_t g_sistema[PROC_SIS_TOTAL];
+static unsigned long         g_relogio = 0;
+static int                   g_iniciado = 0;
+
+static void iniciar_se_preciso(void) {
+    if (g_iniciado) return;
+    for (int i = 0; i < PROC_CACHE_MAX_PIDS; i++) {
+        g_entradas[i].pid = -1;
+        for (int a = 0; a < PROC_ARQ_POR_PID; a++) {
+            g_entradas[i].arq[a].fd  = -1;
+            g_entradas[i].arq[a].buf = NULL;
+            g_entradas[i].arq[a].cap = 0;
+        }
+    }
+    for (int a = 0; a < PROC_SIS_TOTAL; a++) {
+        g_sistema[a].fd  = -1;
+        g_sistema[a].buf = NULL;
+        g_sistema[a].cap = 0;
+    }
+    g_iniciado = 1;
+}
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static void fechar_entrada(proc_cache_entrada_t *e) {
+    for (int a = 0; a < PROC_ARQ_POR_PID; a++) {
+        if (e->arq[a].fd >= 0) {
+            close(e->arq[a].fd);
+            e->arq[a].fd = -1;
+        }
+    }
+    e->pid = -1;  // buffers ficam alocados para reaproveitamento do slot
+}
+
+/* Procura o slot do PID; se não existir, ocupa um livre ou o menos usado (LRU) */
+static proc_cache_entrada_t *obter_entrada(pid_t pid) {
+    proc_cache_entrada_t *livre = NULL, *lru = NULL;
+
+    for (int i = 0; i < PROC_CACHE_MAX_PIDS; i++) {
+        proc_cache_entrada_t *e = &g_entradas[i];
+        if (e->pid == pid) return e;
+        if (e->pid == -1) {
+            if (!livre) livre = e;
+        } else if (!lru || e->ultimo_uso < lru->ultimo_uso) {
+            lru = e;
+        }
+    }
+
+    proc_cache_entrada_t *e = livre ? livre : lru;
+    fechar_entrada(e);
+    e->pid = pid;
+    return e;
+}
+
+/*
+ * Lê o arquivo inteiro com pread a partir do offset 0.
+ * Se o buffer encher, dobra a capacidade e relê (o conteúdo do /proc é
+ * gerado novamente a cada leitura, então não há estado de offset a manter).
+ */
+static const char *reler(proc_arquivo_aberto_t *a, size_t tam_inicial, size_t *tamanho) {
+    if (!a->buf) {
+        a->buf = (char *)malloc(tam_inicial);
+        if (!a->buf) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        a->cap = tam_inicial;
+    }
+
+    for (;;) {
+        ssize_t n = pread(a->fd, a->buf, a->cap - 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return NULL;
+        }
+
+        if ((size_t)n == a->cap - 1 && a->cap < PROC_CACHE_BUF_MAX) {
+            char *novo = (char *)realloc(a->buf, a->cap * 2);
+            if (!novo) {
+                errno = ENOMEM;
+                return NULL;
+            }
+            a->buf = novo;
+            a->cap *= 2;
+            continue;
+        }
+
+        a->buf[n] = '\0';
+        if (tamanho) *tamanho = (size_t)n;
+        return a->buf;
+    }
+}
+
+/* ==================== API ==================== */
+
+const char *proc_cache_ler_pid(pid_t pid, proc_arquivo_t arq, size_t *tamanho) {
+    if (pid <= 0 || (int)arq < 0 || arq >= PROC_ARQ_POR_PID) {
+        errno = EINVAL;
+        return NULL;
+    }
+    iniciar_se_preciso();
+
+    proc_cache_entrada_t *e = obter_entrada(pid);
+    proc_arquivo_aberto_t *a = &e->arq[arq];
+    e->ultimo_uso = ++g_relogio;
+
+    if (a->fd < 0) {
+        char caminho[64];
+        snprintf(caminho, sizeof(caminho), "/proc/%d/%s", pid, NOMES_PID[arq]);
+        a->fd = open(caminho, O_RDONLY | O_CLOEXEC);
+        if (a->fd < 0) {
+            int erro = errno;
+            if (erro == ENOENT || erro == ESRCH) {
+                fechar_entrada(e);
+            }
+            errno = erro;
+            return NULL;
+        }
+    }
+
+    const char *conteudo = reler(a, TAM_INICIAL_PID[arq], tamanho);
+    if (!conteudo) {
+        int erro = errno;
+        // ESRCH: o descritor aponta para uma tarefa que já terminou
+        if (erro == ESRCH || erro == ENOENT) {
+            fechar_entrada(e);
+        }
+        errno = erro;
+    }
+    return conteudo;
+}
+
+const char *proc_cache_ler_sistema(proc_arquivo_sistema_t arq, size_t *tamanho) {
+    if ((int)arq < 0 || arq >= PROC_SIS_TOTAL) {
+        errno = EINVAL;
+        return NULL;
+    }
+    iniciar_se_preciso();
+
+    proc_arquivo_aberto_t *a = &g_sistema[arq];
+    if (a->fd < 0) {
+        a->fd = open(CAMINHOS_SIS[arq], O_RDONLY | O_CLOEXEC);
+        if (a->fd < 0) return NULL;
+    }
+    return reler(a, TAM_INICIAL_SIS[arq], tamanho);
+}
+
+void proc_cache_invalidar(pid_t pid) {
+    if (!g_iniciado) return;
+    for (int i = 0; i < PROC_CACHE_MAX_PIDS; i++) {
+        if (g_entradas[i].pid == pid) {
+            fechar_entrada(&g_entradas[i]);
+        }
+    }
+}
+
+void proc_cache_limpar(void) {
+    if (!g_iniciado) return;
+    for (int i = 0; i < PROC_CACHE_MAX_PIDS; i++) {
+        fechar_entrada(&g_entradas[i]);
+        for (int a = 0; a < PROC_ARQ_POR_PID; a++) {
+            free(g_entradas[i].arq[a].buf);
+            g_entradas[i].arq[a].buf = NULL;
+            g_entradas[i].arq[a].cap = 0;
+        }
+    }
+    for (int a = 0; a < PROC_SIS_TOTAL; a++) {
+        if (g_sistema[a].fd >= 0) close(g_sistema[a].fd);
+        free(g_sistema[a].buf);
+        g_sistema[a].fd  = -1;
+        g_sistema[a].buf = NULL;
+        g_sistema[a].cap = 0;
+    }
+    g_relogio = 0;
+}
+
+/* ==================== LEITURA AVULSA ==================== */
+
+long proc_ler_arquivo(int dirfd, const char *caminho, char *buf, size_t cap) {
+    if (!caminho || !buf || cap < 2) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = openat(dirfd, caminho, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    size_t total = 0;
+    while (total < cap - 1) {
+        ssize_t n = read(fd, buf + total, cap - 1 - total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int erro = errno;
+            close(fd);
+            errno = erro;
+            return -1;
+        }
+        if (n == 0) break;
+        total += (size_t)n;
+    }
+    close(fd);
+
+    buf[total] = '\0';
+    return (long)total;
+}
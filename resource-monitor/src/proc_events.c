@@ -0,0 +1,511 @@
+// proc_events.c - ciclo de vida de processos via proc connector (fork/exec/exit)
+#define _POSIX_C_SOURCE 200809L  // poll/openat
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/proc_events.h"
+#include "../include/proctree.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+
+#define EVENTOS_LOTE      256
+#define EVENTOS_RCVBUF    (1 << 20)   // rajadas de fork não podem estourar o socket
+
+/* ==================== SOCKET DO PROC CONNECTOR ==================== */
+
+/* Liga (LISTEN) ou desliga (IGNORE) o envio de eventos para este socket */
+static int enviar_op(int fd, enum proc_cn_mcast_op op) {
+    char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(op))];
+    memset(buf, 0, sizeof(buf));
+
+    struct nlmsghdr *n = (struct nlmsghdr *)buf;
+    n->nlmsg_len  = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    n->nlmsg_type = NLMSG_DONE;
+    n->nlmsg_pid  = 0;
+
+    struct cn_msg *cn = (struct cn_msg *)NLMSG_DATA(n);
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len    = sizeof(op);
+    memcpy((char *)(cn + 1), &op, sizeof(op));
+
+    return send(fd, buf, n->nlmsg_len, 0) < 0 ? -1 : 0;
+}
+
+int eventos_abrir(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd < 0) return -1;
+
+    int rcvbuf = EVENTOS_RCVBUF;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl local;
+    memset(&local, 0, sizeof(local));
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = CN_IDX_PROC;
+
+    if (bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0 ||
+        enviar_op(fd, PROC_CN_MCAST_LISTEN) != 0) {
+        int erro = errno;
+        close(fd);
+        errno = erro;
+        return -1;
+    }
+    return fd;
+}
+
+void eventos_fechar(int fd) {
+    if (fd < 0) return;
+    enviar_op(fd, PROC_CN_MCAST_IGNORE);
+    close(fd);
+}
+
+/* Converte uma proc_event do kernel; threads e eventos irrelevantes retornam 0 */
+static int converter_evento(const struct proc_event *pe, evento_proc_t *ev) {
+    switch (pe->what) {
+        case PROC_EVENT_FORK:
+            if (pe->event_data.fork.child_pid != pe->event_data.fork.child_tgid) return 0;
+            ev->tipo = EVENTO_FORK;
+            ev->pid  = pe->event_data.fork.child_tgid;
+            ev->ppid = pe->event_data.fork.parent_tgid;
+            ev->codigo_saida = 0;
+            return 1;
+        case PROC_EVENT_EXEC:
+            ev->tipo = EVENTO_EXEC;
+            ev->pid  = pe->event_data.exec.process_tgid;
+            ev->ppid = 0;
+            ev->codigo_saida = 0;
+            return 1;
+        case PROC_EVENT_EXIT:
+            if (pe->event_data.exit.process_pid != pe->event_data.exit.process_tgid) return 0;
+            ev->tipo = EVENTO_EXIT;
+            ev->pid  = pe->event_data.exit.process_tgid;
+            ev->ppid = 0;
+            ev->codigo_saida = (int)pe->event_data.exit.exit_code;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int eventos_ler(int fd, evento_proc_t *eventos, int max, unsigned long *perdidos) {
+    if (fd < 0 || !eventos || max <= 0) return -1;
+
+    // alinhado para os cabeçalhos netlink
+    union {
+        struct nlmsghdr n;
+        char            buf[4096];
+    } rx;
+
+    int lidos = 0;
+    while (lidos < max) {
+        struct sockaddr_nl origem;
+        socklen_t tam_origem = sizeof(origem);
+        ssize_t n = recvfrom(fd, rx.buf, sizeof(rx.buf), 0,
+                             (struct sockaddr *)&origem, &tam_origem);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                // o kernel descartou eventos: o chamador precisa revalidar o conjunto
+                if (perdidos) (*perdidos)++;
+                continue;
+            }
+            return -1;
+        }
+        if (origem.nl_pid != 0) continue;  // só aceita mensagens do kernel
+
+        for (struct nlmsghdr *h = &rx.n; NLMSG_OK(h, (unsigned int)n); h = NLMSG_NEXT(h, n)) {
+            if (h->nlmsg_type == NLMSG_ERROR || h->nlmsg_type == NLMSG_NOOP) continue;
+
+            const struct cn_msg *cn = (const struct cn_msg *)NLMSG_DATA(h);
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC) continue;
+
+            const struct proc_event *pe = (const struct proc_event *)(cn + 1);
+            if (lidos < max && converter_evento(pe, &eventos[lidos])) {
+                lidos++;
+            } else if (lidos >= max && perdidos) {
+                (*perdidos)++;
+            }
+        }
+    }
+    return lidos;
+}
+
+/* ==================== CONJUNTO MONITORADO ==================== */
+
+typedef struct {
+    pid_t              pid;
+    char               comm[32];
+    unsigned long long cpu_ticks;     // utime + stime
+    unsigned long long rss_kb;
+    unsigned long long read_bytes;    // rchar
+    unsigned long long write_bytes;   // wchar
+    int                io_disponivel;
+    double             cpu_percent;
+    double             read_bps;
+    double             write_bps;
+} membro_t;
+
+/* Totais finais de quem terminou durante o monitoramento */
+typedef struct {
+    pid_t              pid;
+    char               comm[32];
+    int                codigo_saida;
+    unsigned long long cpu_ticks;
+    unsigned long long read_bytes;
+    unsigned long long write_bytes;
+} encerrado_t;
+
+typedef struct {
+    membro_t     *membros;
+    size_t        num_membros, cap_membros;
+    encerrado_t  *encerrados;
+    size_t        num_encerrados, cap_encerrados;
+
+    pid_t         raiz;
+    const char   *nome;
+    int           dfd;              // dirfd de /proc
+    long          pagina_kb;
+    unsigned long anexados;         // processos que entraram por evento
+} conjunto_t;
+
+static membro_t *buscar_membro(conjunto_t *cj, pid_t pid) {
+    for (size_t i = 0; i < cj->num_membros; i++) {
+        if (cj->membros[i].pid == pid) return &cj->membros[i];
+    }
+    return NULL;
+}
+
+/* Relê stat (+ io) de um membro; -1 se o processo já não pode ser lido */
+static int ler_membro(conjunto_t *cj, membro_t *m) {
+    static const unsigned long long pedidos =
+        PSTAT_BIT(PSTAT_UTIME) | PSTAT_BIT(PSTAT_STIME) | PSTAT_BIT(PSTAT_RSS);
+
+    char caminho[64];
+    char buf[1024];
+
+    snprintf(caminho, sizeof(caminho), "%d/stat", m->pid);
+    if (proc_ler_arquivo(cj->dfd, caminho, buf, sizeof(buf)) <= 0) return -1;
+
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(buf, pedidos, &c) != 0) return -1;
+    memcpy(m->comm, c.comm, sizeof(m->comm));
+    m->cpu_ticks = c.campos[PSTAT_UTIME] + c.campos[PSTAT_STIME];
+    m->rss_kb    = c.campos[PSTAT_RSS] * (unsigned long long)cj->pagina_kb;
+
+    snprintf(caminho, sizeof(caminho), "%d/io", m->pid);
+    io_stats_t io;
+    if (proc_ler_arquivo(cj->dfd, caminho, buf, sizeof(buf)) > 0 &&
+        io_interpretar_processo(buf, NULL, &io) == 0) {
+        m->read_bytes    = io.read_bytes;
+        m->write_bytes   = io.write_bytes;
+        m->io_disponivel = 1;
+    }
+    return 0;
+}
+
+static int adicionar_membro(conjunto_t *cj, pid_t pid, const char *motivo) {
+    if (pid <= 0 || buscar_membro(cj, pid)) return 0;
+
+    if (cj->num_membros == cj->cap_membros) {
+        size_t nova = cj->cap_membros ? cj->cap_membros * 2 : 16;
+        membro_t *v = (membro_t *)realloc(cj->membros, nova * sizeof(*v));
+        if (!v) return -1;
+        cj->membros     = v;
+        cj->cap_membros = nova;
+    }
+
+    membro_t *m = &cj->membros[cj->num_membros];
+    memset(m, 0, sizeof(*m));
+    m->pid = pid;
+    if (ler_membro(cj, m) != 0) return 0;  // já terminou: o evento de saída vem em seguida
+    cj->num_membros++;
+
+    if (motivo) {
+        cj->anexados++;
+        fprintf(stderr, "+ %d %s (%s)\n", pid, m->comm, motivo);
+    }
+    return 0;
+}
+
+/*
+ * Tira o membro do conjunto guardando seus totais. A leitura no evento de
+ * saída ainda costuma achar o processo (zumbi até o wait do pai); se não,
+ * ficam os valores da última amostra.
+ */
+static void encerrar_membro(conjunto_t *cj, membro_t *m, int codigo_saida) {
+    ler_membro(cj, m);
+
+    if (cj->num_encerrados == cj->cap_encerrados) {
+        size_t nova = cj->cap_encerrados ? cj->cap_encerrados * 2 : 16;
+        encerrado_t *v = (encerrado_t *)realloc(cj->encerrados, nova * sizeof(*v));
+        if (v) {
+            cj->encerrados     = v;
+            cj->cap_encerrados = nova;
+        }
+    }
+    if (cj->num_encerrados < cj->cap_encerrados) {
+        encerrado_t *e = &cj->encerrados[cj->num_encerrados++];
+        e->pid          = m->pid;
+        e->codigo_saida = codigo_saida;
+        e->cpu_ticks    = m->cpu_ticks;
+        e->read_bytes   = m->read_bytes;
+        e->write_bytes  = m->write_bytes;
+        memcpy(e->comm, m->comm, sizeof(e->comm));
+    }
+
+    fprintf(stderr, "- %d %s terminou (status %d)\n", m->pid, m->comm, codigo_saida);
+
+    size_t idx = (size_t)(m - cj->membros);
+    cj->membros[idx] = cj->membros[--cj->num_membros];
+}
+
+static int comm_confere(conjunto_t *cj, pid_t pid) {
+    char caminho[64];
+    char comm[64];
+    snprintf(caminho, sizeof(caminho), "%d/comm", pid);
+    long n = proc_ler_arquivo(cj->dfd, caminho, comm, sizeof(comm));
+    if (n <= 0) return 0;
+    comm[strcspn(comm, "\n")] = '\0';
+    return strcmp(comm, cj->nome) == 0;
+}
+
+static void aplicar_evento(conjunto_t *cj, const evento_proc_t *ev) {
+    membro_t *m = buscar_membro(cj, ev->pid);
+
+    switch (ev->tipo) {
+        case EVENTO_FORK:
+            if (cj->raiz > 0 && buscar_membro(cj, ev->ppid)) {
+                adicionar_membro(cj, ev->pid, "fork");
+            }
+            break;
+        case EVENTO_EXEC:
+            if (m) {
+                ler_membro(cj, m);  // comm novo
+            } else if (cj->nome && comm_confere(cj, ev->pid)) {
+                adicionar_membro(cj, ev->pid, "exec");
+            }
+            break;
+        case EVENTO_EXIT:
+            if (m) encerrar_membro(cj, m, ev->codigo_saida);
+            break;
+    }
+}
+
+/* Processa tudo o que estiver pendente no socket */
+static int drenar_eventos(int fd, conjunto_t *cj, unsigned long *perdidos) {
+    evento_proc_t lote[EVENTOS_LOTE];
+    unsigned long perdidos_antes = *perdidos;
+    int n;
+
+    while ((n = eventos_ler(fd, lote, EVENTOS_LOTE, perdidos)) > 0) {
+        for (int i = 0; i < n; i++) aplicar_evento(cj, &lote[i]);
+        if (n < EVENTOS_LOTE) break;
+    }
+    if (n < 0) return -1;
+
+    // eventos perdidos: descarta membros que já não existem (sem varrer /proc)
+    if (*perdidos != perdidos_antes) {
+        for (size_t i = 0; i < cj->num_membros; ) {
+            if (kill(cj->membros[i].pid, 0) != 0 && errno == ESRCH) {
+                encerrar_membro(cj, &cj->membros[i], -1);
+            } else {
+                i++;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Conjunto inicial: raiz + descendentes vivos, ou processos com o comm pedido */
+static int popular_inicial(conjunto_t *cj) {
+    if (cj->raiz > 0) {
+        arvore_t arv;
+        if (arvore_iniciar(&arv, cj->raiz) != 0) return -1;
+        if (arvore_varrer(&arv) <= 0) {
+            arvore_destruir(&arv);
+            return -1;
+        }
+        for (size_t b = 0; b < arv.num_baldes; b++) {
+            for (arvore_proc_t *p = arv.baldes[b]; p; p = p->prox) {
+                if (p->membro == ARVORE_MEMBRO) adicionar_membro(cj, p->pid, NULL);
+            }
+        }
+        arvore_destruir(&arv);
+        return 0;
+    }
+
+    DIR *dir = fdopendir(dup(cj->dfd));
+    if (!dir) return -1;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] < '1' || ent->d_name[0] > '9') continue;
+        pid_t pid = (pid_t)atoi(ent->d_name);
+        if (comm_confere(cj, pid)) adicionar_membro(cj, pid, NULL);
+    }
+    closedir(dir);
+    return 0;
+}
+
+/* ==================== LOOP DE MONITORAMENTO ==================== */
+
+int eventos_monitorar_csv(pid_t raiz, const char *nome, int intervalo_ms, int amostras,
+                          FILE *saida) {
+    if ((raiz <= 0 && !nome) || intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "eventos_monitorar_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    // assina os eventos ANTES da varredura inicial para não perder forks no meio
+    int fd = eventos_abrir();
+    if (fd < 0) {
+        fprintf(stderr, "Proc connector indisponível: %s (requer CAP_NET_ADMIN)\n",
+                strerror(errno));
+        return -1;
+    }
+
+    conjunto_t cj;
+    memset(&cj, 0, sizeof(cj));
+    cj.raiz = raiz;
+    cj.nome = nome;
+    cj.pagina_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (cj.pagina_kb <= 0) cj.pagina_kb = 4;
+    cj.dfd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (cj.dfd < 0 || popular_inicial(&cj) != 0) {
+        fprintf(stderr, "Falha ao montar o conjunto inicial de processos\n");
+        if (cj.dfd >= 0) close(cj.dfd);
+        eventos_fechar(fd);
+        free(cj.membros);
+        return -1;
+    }
+
+    cpu_times_t sys_antes, sys_depois;
+    if (cpu_ler_times_sistema(&sys_antes) != 0) {
+        close(cj.dfd);
+        eventos_fechar(fd);
+        free(cj.membros);
+        return -1;
+    }
+    long long mono_antes = agendador_agora_ns();
+
+    fprintf(saida, "timestamp,amostra,pid,comm,cpu_percent,rss_kb,read_bps,write_bps\n");
+    fflush(saida);
+    fprintf(stderr, "Acompanhando %zu processo(s) por eventos fork/exec/exit\n", cj.num_membros);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    unsigned long perdidos = 0;
+    for (int i = 0; i < amostras && rc == 0; i++) {
+        /* atende eventos enquanto espera o prazo; o último trecho fica com o agendador */
+        long long falta;
+        while ((falta = agendador_restante_ns(&ag)) >= 1000000LL) {
+            struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+            int r = poll(&pfd, 1, (int)(falta / 1000000LL));
+            if (r < 0 && errno != EINTR) {
+                perror("poll");
+                rc = -1;
+                break;
+            }
+            if (r > 0 && drenar_eventos(fd, &cj, &perdidos) != 0) {
+                perror("eventos_ler");
+                rc = -1;
+                break;
+            }
+        }
+        if (rc != 0) break;
+
+        agendador_esperar(&ag);
+        if (drenar_eventos(fd, &cj, &perdidos) != 0) {
+            rc = -1;
+            break;
+        }
+
+        if (cpu_ler_times_sistema(&sys_depois) != 0) {
+            rc = -1;
+            break;
+        }
+        long long mono_depois = agendador_agora_ns();
+        unsigned long long delta_sys = (sys_depois.total > sys_antes.total)
+                                       ? sys_depois.total - sys_antes.total : 0;
+        double s = (double)(mono_depois - mono_antes) / 1e9;
+
+        char ts[CARIMBO_TAM];
+        carimbo_texto_agora(ts, sizeof(ts), NULL);
+
+        for (size_t k = 0; k < cj.num_membros; k++) {
+            membro_t *m = &cj.membros[k];
+            membro_t anterior = *m;
+            if (ler_membro(&cj, m) != 0) continue;  // saída já a caminho no socket
+
+            // quem entrou no meio do intervalo tem a base lida no momento da entrada
+            m->cpu_percent = (delta_sys && m->cpu_ticks >= anterior.cpu_ticks)
+                             ? (double)(m->cpu_ticks - anterior.cpu_ticks) / delta_sys * 100.0
+                             : 0.0;
+            m->read_bps  = (s > 0 && m->read_bytes >= anterior.read_bytes)
+                           ? (double)(m->read_bytes - anterior.read_bytes) / s : 0.0;
+            m->write_bps = (s > 0 && m->write_bytes >= anterior.write_bytes)
+                           ? (double)(m->write_bytes - anterior.write_bytes) / s : 0.0;
+
+            char comm[sizeof(m->comm)];
+            memcpy(comm, m->comm, sizeof(comm));
+            for (char *c = comm; *c; c++) {
+                if (*c == ',' || *c == '"') *c = '_';
+            }
+            fprintf(saida, "%s,%d,%d,%s,%.2f,%llu,%.0f,%.0f\n",
+                    ts, i, m->pid, comm, m->cpu_percent, m->rss_kb, m->read_bps, m->write_bps);
+        }
+        fflush(saida);
+
+        sys_antes  = sys_depois;
+        mono_antes = mono_depois;
+
+        if (cj.num_membros == 0 && raiz > 0) {
+            fprintf(stderr, "Todos os processos da árvore de %d terminaram (amostra %d)\n",
+                    raiz, i);
+            break;
+        }
+    }
+
+    agendador_relatar(&ag, "Monitoramento por eventos");
+
+    /* ---- resumo: anexados por evento e totais finais de quem terminou ---- */
+    long hz = sysconf(_SC_CLK_TCK);
+    if (hz <= 0) hz = 100;
+    fprintf(stderr, "\n%lu processo(s) anexado(s) por evento, %zu terminaram",
+            cj.anexados, cj.num_encerrados);
+    if (perdidos) fprintf(stderr, " (%lu rajada(s) de eventos perdidas)", perdidos);
+    fprintf(stderr, "\n");
+    for (size_t k = 0; k < cj.num_encerrados; k++) {
+        const encerrado_t *e = &cj.encerrados[k];
+        fprintf(stderr, "  %-7d %-16s cpu=%.2fs read=%llu KB write=%llu KB status=%d\n",
+                e->pid, e->comm, (double)e->cpu_ticks / (double)hz,
+                e->read_bytes / 1024, e->write_bytes / 1024, e->codigo_saida);
+    }
+
+    close(cj.dfd);
+    eventos_fechar(fd);
+    free(cj.membros);
+    free(cj.encerrados);
+    return rc;
+}
@@ -0,0 +1,123 @@
+// proc_parser.c - tokenizador reentrante para /proc/<pid>/stat e /proc/stat
+#include <string.h>
+
+#include "../include/proc_parser.h"
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static const char *pular_espacos(const char *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+/* Converte o próximo número decimal (com sinal opcional); não usa locale nem errno */
+static const char *ler_numero(const char *p, unsigned long long *valor) {
+    int negativo = 0;
+    if (*p == '-') {
+        negativo = 1;
+        p++;
+    }
+
+    unsigned long long v = 0;
+    while (*p >= '0' && *p <= '9') {
+        v = v * 10ULL + (unsigned long long)(*p - '0');
+        p++;
+    }
+
+    *valor = negativo ? (0ULL - v) : v;  // complemento de dois
+    return p;
+}
+
+static int maior_campo(unsigned long long mascara) {
+    int maior = 0;
+    for (int c = 0; c <= PSTAT_MAX_CAMPOS; c++) {
+        if (mascara & PSTAT_BIT(c)) maior = c;
+    }
+    return maior;
+}
+
+/* ==================== /proc/<pid>/stat ==================== */
+
+int proc_stat_interpretar(const char *buf, unsigned long long pedidos, proc_stat_campos_t *out) {
+    if (!buf || !out) return -1;
+
+    out->comm[0]     = '\0';
+    out->estado      = '?';
+    out->preenchidos = 0;
+
+    /* campo 1: pid */
+    const char *p = pular_espacos(buf);
+    unsigned long long valor;
+    p = ler_numero(p, &valor);
+    if (pedidos & PSTAT_BIT(PSTAT_PID)) {
+        out->campos[PSTAT_PID] = valor;
+        out->preenchidos |= PSTAT_BIT(PSTAT_PID);
+    }
+
+    /* campo 2: comm entre o primeiro '(' e o ÚLTIMO ')' */
+    const char *ini = strchr(p, '(');
+    const char *fim = ini ? strrchr(ini, ')') : NULL;
+    if (!ini || !fim) return -1;
+
+    size_t tam = (size_t)(fim - ini - 1);
+    if (tam >= sizeof(out->comm)) tam = sizeof(out->comm) - 1;
+    memcpy(out->comm, ini + 1, tam);
+    out->comm[tam] = '\0';
+    out->preenchidos |= PSTAT_BIT(PSTAT_COMM);
+
+    /* campo 3: estado (caractere) */
+    p = pular_espacos(fim + 1);
+    if (!*p) return -1;
+    out->estado = *p++;
+    out->preenchidos |= PSTAT_BIT(PSTAT_STATE);
+
+    /* campos 4..N: numéricos, separados por espaço */
+    int ultimo = maior_campo(pedidos);
+    for (int campo = PSTAT_PPID; campo <= ultimo; campo++) {
+        p = pular_espacos(p);
+        if (*p == '\0' || *p == '\n') break;
+
+        p = ler_numero(p, &valor);
+        if (pedidos & PSTAT_BIT(campo)) {
+            out->campos[campo] = valor;
+            out->preenchidos |= PSTAT_BIT(campo);
+        }
+
+        // token não numérico inesperado: descarta até o próximo espaço
+        while (*p && *p != ' ' && *p != '\n') p++;
+    }
+
+    return ((out->preenchidos & pedidos) == pedidos) ? 0 : -1;
+}
+
+/* ==================== /proc/stat ==================== */
+
+int proc_stat_linha_cpu(const char *linha, unsigned long long *valores, int max, int *indice_core) {
+    if (!linha || !valores || strncmp(linha, "cpu", 3) != 0) return -1;
+
+    const char *p = linha + 3;
+    int core = -1;
+    if (*p >= '0' && *p <= '9') {
+        unsigned long long n;
+        p = ler_numero(p, &n);
+        core = (int)n;
+    } else if (*p != ' ') {
+        return -1;
+    }
+    if (indice_core) *indice_core = core;
+
+    int lidos = 0;
+    while (lidos < max) {
+        p = pular_espacos(p);
+        if (*p < '0' || *p > '9') break;
+        p = ler_numero(p, &valores[lidos]);
+        lidos++;
+    }
+    return lidos;
+}
+
+const char *proc_proxima_linha(const char *linha) {
+    if (!linha) return NULL;
+    const char *fim = strchr(linha, '\n');
+    return (fim && fim[1]) ? fim + 1 : NULL;
+}
@@ -0,0 +1,728 @@
+// process_scanner.c - varredura de todos os processos do sistema ("modo top")
+#define _POSIX_C_SOURCE 200809L  // dirfd/openat/fileno
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+
+#include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/formatter.h"
+#include "../include/recording.h"
+#include "../include/scanner.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+
+#define SCANNER_BALDES_INICIAIS 1024
+#define SCANNER_TAM_SHARD       64      // PIDs por shard do pool
+
+static int workers_padrao = 0;
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static size_t hash_identidade(pid_t pid, unsigned long long starttime, size_t num_baldes) {
+    unsigned long long h = (unsigned long long)(unsigned int)pid * 0x9E3779B97F4A7C15ULL;
+    h ^= starttime + 0x7F4A7C15ULL + (h << 6) + (h >> 2);
+    return (size_t)(h & (num_baldes - 1));
+}
+
+static int nome_numerico(const char *nome) {
+    if (!*nome) return 0;
+    for (; *nome; nome++) {
+        if (*nome < '0' || *nome > '9') return 0;
+    }
+    return 1;
+}
+
+/* Dobra a tabela quando a carga passa de 1 processo por balde */
+static int redimensionar(scanner_t *sc) {
+    size_t novo_num = sc->num_baldes * 2;
+    scanner_proc_t **novos = (scanner_proc_t **)calloc(novo_num, sizeof(*novos));
+    if (!novos) return -1;
+
+    for (size_t b = 0; b < sc->num_baldes; b++) {
+        scanner_proc_t *p = sc->baldes[b];
+        while (p) {
+            scanner_proc_t *prox = p->prox;
+            size_t idx = hash_identidade(p->pid, p->starttime, novo_num);
+            p->prox = novos[idx];
+            novos[idx] = p;
+            p = prox;
+        }
+    }
+
+    free(sc->baldes);
+    sc->baldes     = novos;
+    sc->num_baldes = novo_num;
+    return 0;
+}
+
+/* Extrai de /proc/<pid>/stat: comm, estado, ppid, utime+stime, starttime, rss */
+static int interpretar_stat(const char *buf, scanner_proc_t *p, long pagina_kb) {
+    static const unsigned long long pedidos =
+        PSTAT_BIT(PSTAT_PPID) | PSTAT_BIT(PSTAT_UTIME) | PSTAT_BIT(PSTAT_STIME) |
+        PSTAT_BIT(PSTAT_STARTTIME) | PSTAT_BIT(PSTAT_RSS);
+
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(buf, pedidos, &c) != 0) return -1;
+
+    memcpy(p->comm, c.comm, sizeof(p->comm));
+    p->estado    = c.estado;
+    p->ppid      = (pid_t)c.campos[PSTAT_PPID];
+    p->utime     = c.campos[PSTAT_UTIME];
+    p->stime     = c.campos[PSTAT_STIME];
+    p->cpu_ticks = p->utime + p->stime;
+    p->starttime = c.campos[PSTAT_STARTTIME];
+    p->rss_kb    = c.campos[PSTAT_RSS] * (unsigned long long)pagina_kb;
+    return 0;
+}
+
+static int interpretar_io(const char *buf, unsigned long long *rchar, unsigned long long *wchar) {
+    int achados = 0;
+    for (const char *linha = buf; *linha; ) {
+        if (strncmp(linha, "rchar:", 6) == 0) {
+            *rchar = strtoull(linha + 6, NULL, 10);
+            achados++;
+        } else if (strncmp(linha, "wchar:", 6) == 0) {
+            *wchar = strtoull(linha + 6, NULL, 10);
+            achados++;
+        }
+        if (achados == 2) break;
+
+        const char *prox = strchr(linha, '\n');
+        if (!prox) break;
+        linha = prox + 1;
+    }
+    return achados == 2 ? 0 : -1;
+}
+
+static double valor_ordem(const scanner_proc_t *p, scanner_ordem_t ordem) {
+    switch (ordem) {
+        case SCANNER_ORDEM_RSS:   return (double)p->rss_kb;
+        case SCANNER_ORDEM_IO:    return p->read_bps + p->write_bps;
+        case SCANNER_ORDEM_READ:  return p->read_bps;
+        case SCANNER_ORDEM_WRITE: return p->write_bps;
+        case SCANNER_ORDEM_CPU:
+        default:                  return p->cpu_percent;
+    }
+}
+
+/* ==================== COLETA DE UM SHARD ==================== */
+
+typedef struct {
+    scanner_t *sc;
+    long       pagina_kb;
+    int        ler;          // 0 = o lote já foi lido inteiro (modo de 1 worker)
+} coleta_t;
+
+/*
+ * Lê e interpreta os PIDs [inicio, fim) para lidos[inicio..fim). Cada índice
+ * pertence a um único shard, então os workers escrevem o snapshot sem trava.
+ */
+static void coletar_faixa(void *arg, size_t inicio, size_t fim, int worker) {
+    coleta_t  *c  = (coleta_t *)arg;
+    scanner_t *sc = c->sc;
+    (void)worker;
+
+    if (c->ler) proc_lote_ler_faixa(&sc->lote, inicio, fim);
+
+    for (size_t k = inicio; k < fim; k++) {
+        scanner_proc_t *atual = &sc->lidos[k];
+        memset(atual, 0, sizeof(*atual));
+
+        const char *stat = proc_lote_conteudo(&sc->lote, k, PROC_ARQ_STAT);
+        if (!stat || interpretar_stat(stat, atual, c->pagina_kb) != 0) continue;  // já terminou
+
+        const char *io = proc_lote_conteudo(&sc->lote, k, PROC_ARQ_IO);
+        if (io && interpretar_io(io, &atual->read_bytes, &atual->write_bytes) == 0) {
+            atual->io_disponivel = 1;
+        }
+        atual->pid = sc->lote.alvos[k].pid;
+    }
+}
+
+/* ==================== CICLO DE VIDA ==================== */
+
+static int iniciar_em(scanner_t *sc, const char *diretorio, int num_workers) {
+    if (!sc) return -1;
+    memset(sc, 0, sizeof(*sc));
+
+    sc->baldes = (scanner_proc_t **)calloc(SCANNER_BALDES_INICIAIS, sizeof(*sc->baldes));
+    if (!sc->baldes) {
+        fprintf(stderr, "scanner_iniciar: sem memória\n");
+        return -1;
+    }
+    sc->num_baldes = SCANNER_BALDES_INICIAIS;
+
+    sc->dir = opendir(diretorio);
+    if (!sc->dir) {
+        fprintf(stderr, "scanner_iniciar: %s: %s\n", diretorio, strerror(errno));
+        free(sc->baldes);
+        sc->baldes = NULL;
+        return -1;
+    }
+
+    unsigned mascara = LOTE_BIT(PROC_ARQ_STAT) | LOTE_BIT(PROC_ARQ_IO);
+    if (proc_lote_iniciar(&sc->lote, dirfd(sc->dir), mascara, proc_lote_padrao()) != 0) {
+        fprintf(stderr, "scanner_iniciar: falha ao preparar leitura em lote\n");
+        closedir(sc->dir);
+        free(sc->baldes);
+        memset(sc, 0, sizeof(*sc));
+        return -1;
+    }
+    if (pool_iniciar(&sc->pool, num_workers) != 0) {
+        proc_lote_destruir(&sc->lote);
+        closedir(sc->dir);
+        free(sc->baldes);
+        memset(sc, 0, sizeof(*sc));
+        return -1;
+    }
+    if (sc->lote.modo == LOTE_URING && sc->pool.num_workers > 1) {
+        // cada shard lê a própria faixa com pread (proc_lote_ler_faixa)
+        fprintf(stderr, "Aviso: --leitura uring só vale com --workers 1; com %d workers a "
+                        "varredura usa pread\n", sc->pool.num_workers);
+    }
+    return 0;
+}
+
+void scanner_definir_workers(int num_workers) {
+    workers_padrao = num_workers < 0 ? 0 : num_workers;
+}
+
+int scanner_iniciar(scanner_t *sc) {
+    return iniciar_em(sc, "/proc", workers_padrao);
+}
+
+int scanner_iniciar_threads(scanner_t *sc, pid_t pid) {
+    if (pid <= 0) {
+        fprintf(stderr, "scanner_iniciar_threads: PID inválido: %d\n", pid);
+        return -1;
+    }
+
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/task", pid);
+    if (iniciar_em(sc, caminho, 1) != 0) return -1;
+
+    sc->pid_alvo = pid;
+    return 0;
+}
+
+void scanner_destruir(scanner_t *sc) {
+    if (!sc) return;
+    for (size_t b = 0; b < sc->num_baldes && sc->baldes; b++) {
+        scanner_proc_t *p = sc->baldes[b];
+        while (p) {
+            scanner_proc_t *prox = p->prox;
+            free(p);
+            p = prox;
+        }
+    }
+    free(sc->baldes);
+    pool_destruir(&sc->pool);
+    proc_lote_destruir(&sc->lote);
+    free(sc->pids);
+    free(sc->lidos);
+    if (sc->dir) closedir(sc->dir);
+    memset(sc, 0, sizeof(*sc));
+}
+
+/* ==================== VARREDURA ==================== */
+
+scanner_proc_t *scanner_buscar(const scanner_t *sc, pid_t pid, unsigned long long starttime) {
+    if (!sc || !sc->baldes) return NULL;
+    scanner_proc_t *p = sc->baldes[hash_identidade(pid, starttime, sc->num_baldes)];
+    for (; p; p = p->prox) {
+        if (p->pid == pid && p->starttime == starttime) return p;
+    }
+    return NULL;
+}
+
+int scanner_varrer(scanner_t *sc) {
+    if (!sc || !sc->baldes || !sc->dir) return -1;
+
+    long pagina_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (pagina_kb <= 0) pagina_kb = 4;
+
+    /* ---- referência de tempo: /proc/stat + relógio monotônico ---- */
+    cpu_times_t sys;
+    if (cpu_ler_times_sistema(&sys) != 0) return -1;
+    carimbo_t quando;
+    carimbo_agora(&quando);
+    long long agora_ns = quando.mono_ns;
+
+    unsigned long long delta_sys = 0;
+    double intervalo_s = 0.0;
+    if (sc->geracao > 0) {
+        delta_sys   = (sys.total > sc->sys_total_antes) ? sys.total - sc->sys_total_antes : 0;
+        intervalo_s = (double)(agora_ns - sc->mono_ns_antes) / 1e9;
+    }
+
+    sc->geracao++;
+    rewinddir(sc->dir);
+
+    /* ---- PIDs presentes: o readdir só lista; as leituras saem em lote ---- */
+    size_t num_pids = 0;
+    struct dirent *ent;
+    while ((ent = readdir(sc->dir)) != NULL) {
+        if (!nome_numerico(ent->d_name)) continue;
+        if (num_pids == sc->cap_pids) {
+            size_t nova = sc->cap_pids ? sc->cap_pids * 2 : 512;
+            // cap_pids só cresce quando os dois vetores já têm o tamanho novo
+            pid_t *v = (pid_t *)realloc(sc->pids, nova * sizeof(pid_t));
+            if (!v) {
+                fprintf(stderr, "scanner_varrer: sem memória\n");
+                return -1;
+            }
+            sc->pids = v;
+
+            scanner_proc_t *l = (scanner_proc_t *)realloc(sc->lidos, nova * sizeof(*l));
+            if (!l) {
+                fprintf(stderr, "scanner_varrer: sem memória\n");
+                return -1;
+            }
+            sc->lidos    = l;
+            sc->cap_pids = nova;
+        }
+        sc->pids[num_pids++] = (pid_t)atoi(ent->d_name);
+    }
+
+    if (proc_lote_definir(&sc->lote, sc->pids, num_pids) != 0) {
+        fprintf(stderr, "scanner_varrer: falha na leitura em lote\n");
+        return -1;
+    }
+
+    /* ---- leitura + interpretação: em shards pelo pool, ou o lote inteiro de uma vez ---- */
+    coleta_t coleta = { sc, pagina_kb, sc->pool.num_workers > 1 };
+    if (!coleta.ler && proc_lote_ler(&sc->lote) < 0) {
+        fprintf(stderr, "scanner_varrer: falha na leitura em lote\n");
+        return -1;
+    }
+    pool_executar(&sc->pool, num_pids, SCANNER_TAM_SHARD, coletar_faixa, &coleta);
+
+    /* ---- merge do snapshot na tabela (só a thread principal mexe na tabela) ---- */
+    for (size_t k = 0; k < num_pids; k++) {
+        scanner_proc_t atual = sc->lidos[k];
+        if (atual.pid == 0) continue;
+
+        scanner_proc_t *p = scanner_buscar(sc, atual.pid, atual.starttime);
+        if (!p) {
+            p = (scanner_proc_t *)malloc(sizeof(*p));
+            if (!p) {
+                fprintf(stderr, "scanner_varrer: sem memória\n");
+                return -1;
+            }
+            *p = atual;
+            size_t idx = hash_identidade(p->pid, p->starttime, sc->num_baldes);
+            p->prox = sc->baldes[idx];
+            sc->baldes[idx] = p;
+            sc->num_procs++;
+        } else {
+            /* deltas em relação à varredura anterior */
+            unsigned long long d_cpu = (atual.cpu_ticks >= p->cpu_ticks)
+                                       ? atual.cpu_ticks - p->cpu_ticks : 0;
+            unsigned long long d_usr = (atual.utime >= p->utime) ? atual.utime - p->utime : 0;
+            unsigned long long d_ker = (atual.stime >= p->stime) ? atual.stime - p->stime : 0;
+            if (delta_sys) {
+                atual.cpu_percent      = (double)d_cpu / (double)delta_sys * 100.0;
+                atual.cpu_user_percent = (double)d_usr / (double)delta_sys * 100.0;
+                atual.cpu_sys_percent  = (double)d_ker / (double)delta_sys * 100.0;
+            }
+
+            if (atual.io_disponivel && p->io_disponivel && intervalo_s > 0.0) {
+                unsigned long long d_r = (atual.read_bytes  >= p->read_bytes)
+                                         ? atual.read_bytes  - p->read_bytes  : 0;
+                unsigned long long d_w = (atual.write_bytes >= p->write_bytes)
+                                         ? atual.write_bytes - p->write_bytes : 0;
+                atual.read_bps  = (double)d_r / intervalo_s;
+                atual.write_bps = (double)d_w / intervalo_s;
+            }
+            atual.tem_anterior = 1;
+            atual.prox = p->prox;
+            *p = atual;
+        }
+        p->geracao = sc->geracao;
+    }
+
+    /* ---- remove quem não apareceu nesta varredura (processo terminou) ---- */
+    for (size_t b = 0; b < sc->num_baldes; b++) {
+        scanner_proc_t **ref = &sc->baldes[b];
+        while (*ref) {
+            if ((*ref)->geracao != sc->geracao) {
+                scanner_proc_t *morto = *ref;
+                *ref = morto->prox;
+                free(morto);
+                sc->num_procs--;
+            } else {
+                ref = &(*ref)->prox;
+            }
+        }
+    }
+
+    if (sc->num_procs > sc->num_baldes && redimensionar(sc) != 0) {
+        fprintf(stderr, "scanner_varrer: falha ao redimensionar tabela (continuando)\n");
+    }
+
+    sc->sys_total_antes = sys.total;
+    sc->mono_ns_antes   = agora_ns;
+    sc->real_ns         = quando.real_ns;
+    sc->intervalo_s     = intervalo_s;
+    return (int)sc->num_procs;
+}
+
+/* ==================== TOP-N ==================== */
+
+/* Min-heap de tamanho n: a raiz é o menor dos N maiores vistos até agora */
+static void heap_descer(scanner_proc_t **h, size_t n, size_t i, scanner_ordem_t ordem) {
+    for (;;) {
+        size_t menor = i, e = 2 * i + 1, d = 2 * i + 2;
+        if (e < n && valor_ordem(h[e], ordem) < valor_ordem(h[menor], ordem)) menor = e;
+        if (d < n && valor_ordem(h[d], ordem) < valor_ordem(h[menor], ordem)) menor = d;
+        if (menor == i) return;
+        scanner_proc_t *tmp = h[i]; h[i] = h[menor]; h[menor] = tmp;
+        i = menor;
+    }
+}
+
+static void heap_subir(scanner_proc_t **h, size_t i, scanner_ordem_t ordem) {
+    while (i > 0) {
+        size_t pai = (i - 1) / 2;
+        if (valor_ordem(h[pai], ordem) <= valor_ordem(h[i], ordem)) return;
+        scanner_proc_t *tmp = h[i]; h[i] = h[pai]; h[pai] = tmp;
+        i = pai;
+    }
+}
+
+size_t scanner_top(const scanner_t *sc, scanner_ordem_t ordem,
+                   scanner_proc_t **saida, size_t n) {
+    if (!sc || !saida || n == 0) return 0;
+
+    size_t usados = 0;
+    for (size_t b = 0; b < sc->num_baldes; b++) {
+        for (scanner_proc_t *p = sc->baldes[b]; p; p = p->prox) {
+            if (usados < n) {
+                saida[usados] = p;
+                heap_subir(saida, usados, ordem);
+                usados++;
+            } else if (valor_ordem(p, ordem) > valor_ordem(saida[0], ordem)) {
+                saida[0] = p;
+                heap_descer(saida, n, 0, ordem);
+            }
+        }
+    }
+
+    /* esvazia o heap do fim para o começo → ordem decrescente */
+    for (size_t fim = usados; fim > 1; fim--) {
+        scanner_proc_t *tmp = saida[0]; saida[0] = saida[fim - 1]; saida[fim - 1] = tmp;
+        heap_descer(saida, fim - 1, 0, ordem);
+    }
+    return usados;
+}
+
+int scanner_ordem_de_texto(const char *texto, scanner_ordem_t *ordem) {
+    if (!texto || !ordem) return -1;
+    if (strcmp(texto, "cpu") == 0)        *ordem = SCANNER_ORDEM_CPU;
+    else if (strcmp(texto, "rss") == 0)   *ordem = SCANNER_ORDEM_RSS;
+    else if (strcmp(texto, "io") == 0)    *ordem = SCANNER_ORDEM_IO;
+    else if (strcmp(texto, "read") == 0)  *ordem = SCANNER_ORDEM_READ;
+    else if (strcmp(texto, "write") == 0) *ordem = SCANNER_ORDEM_WRITE;
+    else return -1;
+    return 0;
+}
+
+/* ==================== LOOP "TOP" (CSV) ==================== */
+
+/* comm é texto livre: a camada de saída troca vírgulas e aspas no CSV e escapa no JSON */
+static const saida_campo_t CAMPOS_TOP[] = {
+    { "timestamp",   CAMPO_TEXTO, 0 },
+    { "iteracao",    CAMPO_INT,   0 },
+    { "posicao",     CAMPO_UINT,  0 },
+    { "pid",         CAMPO_INT,   0 },
+    { "comm",        CAMPO_TEXTO, 0 },
+    { "cpu_percent", CAMPO_FIXO,  2 },
+    { "rss_kb",      CAMPO_UINT,  0 },
+    { "read_bps",    CAMPO_FIXO,  0 },
+    { "write_bps",   CAMPO_FIXO,  0 },
+};
+#define NUM_CAMPOS_TOP (sizeof(CAMPOS_TOP) / sizeof(CAMPOS_TOP[0]))
+
+int scanner_monitorar_top_csv(int intervalo_ms, int iteracoes, size_t top_n,
+                              scanner_ordem_t ordem, FILE *saida) {
+    if (intervalo_ms < 1 || iteracoes <= 0 || top_n == 0) {
+        fprintf(stderr, "scanner_monitorar_top_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    scanner_t sc;
+    if (scanner_iniciar(&sc) != 0) return -1;
+
+    scanner_proc_t **top = (scanner_proc_t **)malloc(top_n * sizeof(*top));
+    if (!top) {
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    // varredura inicial: só forma a base dos deltas
+    if (scanner_varrer(&sc) < 0) {
+        fprintf(stderr, "Falha na varredura inicial de /proc\n");
+        free(top);
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    fflush(saida);  // o que já passou pelo stdio sai antes do buffer próprio
+    saida_t out;
+    if (saida_abrir(&out, fileno(saida), saida_formato_padrao(), CAMPOS_TOP, NUM_CAMPOS_TOP,
+                    0, intervalo_ms < SAIDA_FLUSH_PADRAO_MS ? -1 : 0) != 0) {
+        free(top);
+        scanner_destruir(&sc);
+        return -1;
+    }
+    saida_cabecalho(&out);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    for (int i = 0; i < iteracoes; i++) {
+        agendador_esperar(&ag);
+
+        int vivos = scanner_varrer(&sc);
+        if (vivos < 0) {
+            fprintf(stderr, "Falha na varredura de /proc (iteração %d)\n", i);
+            rc = -1;
+            break;
+        }
+
+        size_t n = scanner_top(&sc, ordem, top, top_n);
+
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(sc.real_ns, ts, sizeof(ts));
+        for (size_t k = 0; k < n; k++) {
+            saida_texto(&out, ts);
+            saida_int(&out, i);
+            saida_uint(&out, k + 1);
+            saida_int(&out, top[k]->pid);
+            saida_texto(&out, top[k]->comm);
+            saida_fixo(&out, top[k]->cpu_percent);
+            saida_uint(&out, top[k]->rss_kb);
+            saida_fixo(&out, top[k]->read_bps);
+            saida_fixo(&out, top[k]->write_bps);
+            saida_fim_linha(&out);
+        }
+        // intervalos longos: um write por tick; curtos: por tamanho ou a cada segundo
+        if (intervalo_ms >= SAIDA_FLUSH_PADRAO_MS) saida_descarregar(&out);
+
+        if (saida != stdout) {
+            fprintf(stderr, "Iteração %d/%d: %d processos vivos\n", i + 1, iteracoes, vivos);
+        }
+    }
+
+    if (saida_fechar(&out) != 0) rc = -1;
+    agendador_relatar(&ag, "Modo top");
+    if (sc.pool.num_workers > 1) {
+        fprintf(stderr, "Varredura paralela: %d workers, %lu shards roubados\n",
+                sc.pool.num_workers, sc.pool.roubos);
+    }
+    free(top);
+    scanner_destruir(&sc);
+    return rc;
+}
+
+/* ==================== GRAVAÇÃO BINÁRIA DO SISTEMA ==================== */
+
+/*
+ * Sem comm: o nome não muda entre ticks e dominaria o arquivo; quem precisa
+ * dele junta pelo PID com um "top" em CSV ou com o log de eventos.
+ */
+static const gravacao_coluna_t COLUNAS_TOP[] = {
+    { "timestamp",   GRAV_TEMPO, GRAV_DELTA2, 0 },
+    { "iteracao",    GRAV_INT,   GRAV_DELTA2, 0 },
+    { "pid",         GRAV_INT,   GRAV_DELTA,  0 },
+    { "cpu_percent", GRAV_FLOAT, GRAV_XOR,    2 },
+    { "rss_kb",      GRAV_INT,   GRAV_DELTA,  0 },
+    { "read_bps",    GRAV_FLOAT, GRAV_XOR,    0 },
+    { "write_bps",   GRAV_FLOAT, GRAV_XOR,    0 },
+};
+#define NUM_COLUNAS_TOP (sizeof(COLUNAS_TOP) / sizeof(COLUNAS_TOP[0]))
+
+int scanner_gravar_top(int intervalo_ms, int iteracoes, FILE *arq) {
+    if (intervalo_ms < 1 || iteracoes <= 0 || !arq) {
+        fprintf(stderr, "scanner_gravar_top: parâmetros inválidos\n");
+        return -1;
+    }
+
+    scanner_t sc;
+    if (scanner_iniciar(&sc) != 0) return -1;
+
+    if (scanner_varrer(&sc) < 0) {
+        fprintf(stderr, "Falha na varredura inicial de /proc\n");
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    char descricao[128];
+    snprintf(descricao, sizeof(descricao), "top intervalo=%dms", intervalo_ms);
+
+    gravador_t g;
+    if (gravador_abrir(&g, arq, descricao, COLUNAS_TOP, NUM_COLUNAS_TOP) != 0) {
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    for (int i = 0; i < iteracoes && rc == 0; i++) {
+        agendador_esperar(&ag);
+
+        int vivos = scanner_varrer(&sc);
+        if (vivos < 0) {
+            fprintf(stderr, "Falha na varredura de /proc (iteração %d)\n", i);
+            rc = -1;
+            break;
+        }
+
+        // o snapshot do lote está em ordem de PID: deltas pequenos na coluna pid
+        gravacao_valor_t linha[NUM_COLUNAS_TOP];
+        linha[0].i = sc.real_ns;
+        linha[1].i = i;
+        for (size_t k = 0; k < sc.lote.num_alvos; k++) {
+            if (sc.lidos[k].pid == 0) continue;
+            const scanner_proc_t *p = scanner_buscar(&sc, sc.lidos[k].pid, sc.lidos[k].starttime);
+            if (!p) continue;
+
+            linha[2].i = p->pid;
+            linha[3].f = p->cpu_percent;
+            linha[4].i = (long long)p->rss_kb;
+            linha[5].f = p->read_bps;
+            linha[6].f = p->write_bps;
+            if (gravador_linha(&g, linha) != 0) {
+                rc = -1;
+                break;
+            }
+        }
+
+        fprintf(stderr, "Iteração %d/%d: %d processos gravados\n", i + 1, iteracoes, vivos);
+    }
+
+    agendador_relatar(&ag, "Gravação top");
+    if (gravador_fechar(&g) != 0) rc = -1;
+    fprintf(stderr, "Gravação concluída: %llu linhas, %llu bytes (%.1f bytes/linha)\n",
+            g.total_linhas, g.total_bytes,
+            g.total_linhas ? (double)g.total_bytes / (double)g.total_linhas : 0.0);
+    scanner_destruir(&sc);
+    return rc;
+}
+
+/* ==================== LOOP "THREADS" (CSV) ==================== */
+
+static const saida_campo_t CAMPOS_THREADS[] = {
+    { "timestamp",    CAMPO_TEXTO, 0 },
+    { "iteracao",     CAMPO_INT,   0 },
+    { "posicao",      CAMPO_UINT,  0 },
+    { "tid",          CAMPO_INT,   0 },
+    { "comm",         CAMPO_TEXTO, 0 },
+    { "cpu_percent",  CAMPO_FIXO,  2 },
+    { "user_percent", CAMPO_FIXO,  2 },
+    { "sys_percent",  CAMPO_FIXO,  2 },
+    { "read_bps",     CAMPO_FIXO,  0 },
+    { "write_bps",    CAMPO_FIXO,  0 },
+};
+#define NUM_CAMPOS_THREADS (sizeof(CAMPOS_THREADS) / sizeof(CAMPOS_THREADS[0]))
+
+int scanner_monitorar_threads_csv(pid_t pid, int intervalo_ms, int iteracoes, size_t top_n,
+                                  scanner_ordem_t ordem, FILE *saida) {
+    if (pid <= 0 || intervalo_ms < 1 || iteracoes <= 0 || top_n == 0) {
+        fprintf(stderr, "scanner_monitorar_threads_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    scanner_t sc;
+    if (scanner_iniciar_threads(&sc, pid) != 0) {
+        fprintf(stderr, "Processo %d não encontrado ou sem permissão\n", pid);
+        return -1;
+    }
+
+    scanner_proc_t **top = (scanner_proc_t **)malloc(top_n * sizeof(*top));
+    if (!top) {
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    // varredura inicial: só forma a base dos deltas
+    if (scanner_varrer(&sc) <= 0) {
+        fprintf(stderr, "Falha na varredura inicial de /proc/%d/task\n", pid);
+        free(top);
+        scanner_destruir(&sc);
+        return -1;
+    }
+
+    fflush(saida);
+    saida_t out;
+    if (saida_abrir(&out, fileno(saida), saida_formato_padrao(), CAMPOS_THREADS,
+                    NUM_CAMPOS_THREADS, 0, intervalo_ms < SAIDA_FLUSH_PADRAO_MS ? -1 : 0) != 0) {
+        free(top);
+        scanner_destruir(&sc);
+        return -1;
+    }
+    saida_cabecalho(&out);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    for (int i = 0; i < iteracoes; i++) {
+        agendador_esperar(&ag);
+
+        // o diretório task de um processo encerrado fica vazio
+        int vivas = scanner_varrer(&sc);
+        if (vivas < 0) {
+            fprintf(stderr, "Falha na varredura de /proc/%d/task (iteração %d)\n", pid, i);
+            rc = -1;
+            break;
+        }
+        if (vivas == 0 || !processo_existe(pid)) {
+            fprintf(stderr, "Processo %d terminou (iteração %d)\n", pid, i);
+            break;
+        }
+
+        size_t n = scanner_top(&sc, ordem, top, top_n);
+
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(sc.real_ns, ts, sizeof(ts));
+        for (size_t k = 0; k < n; k++) {
+            saida_texto(&out, ts);
+            saida_int(&out, i);
+            saida_uint(&out, k + 1);
+            saida_int(&out, top[k]->pid);
+            saida_texto(&out, top[k]->comm);
+            saida_fixo(&out, top[k]->cpu_percent);
+            saida_fixo(&out, top[k]->cpu_user_percent);
+            saida_fixo(&out, top[k]->cpu_sys_percent);
+            saida_fixo(&out, top[k]->read_bps);
+            saida_fixo(&out, top[k]->write_bps);
+            saida_fim_linha(&out);
+        }
+        if (intervalo_ms >= SAIDA_FLUSH_PADRAO_MS) saida_descarregar(&out);
+
+        if (saida != stdout) {
+            fprintf(stderr, "Iteração %d/%d: %d threads, mais quente: %s (%.2f%%)\n",
+                    i + 1, iteracoes, vivas, n ? top[0]->comm : "-", n ? top[0]->cpu_percent : 0.0);
+        }
+    }
+
+    if (saida_fechar(&out) != 0) rc = -1;
+    agendador_relatar(&ag, "Modo threads");
+    free(top);
+    scanner_destruir(&sc);
+    return rc;
+}
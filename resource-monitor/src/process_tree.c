@@ -0,0 +1,406 @@
+// process_tree.c - soma de CPU, RSS e I/O sobre um processo e seus descendentes vivos
+#define _POSIX_C_SOURCE 200809L  // dirfd/openat
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <dirent.h>
+
+#include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/proctree.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+
+#define ARVORE_BALDES_INICIAIS  1024
+#define ARVORE_PROFUNDIDADE_MAX 512   // proteção contra ppid inconsistente
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static size_t hash_pid(pid_t pid, size_t num_baldes) {
+    unsigned long long h = (unsigned long long)(unsigned int)pid * 0x9E3779B97F4A7C15ULL;
+    return (size_t)((h >> 32) & (num_baldes - 1));
+}
+
+static int nome_numerico(const char *nome) {
+    if (!*nome) return 0;
+    for (; *nome; nome++) {
+        if (*nome < '0' || *nome > '9') return 0;
+    }
+    return 1;
+}
+
+static arvore_proc_t *buscar(const arvore_t *arv, pid_t pid) {
+    arvore_proc_t *p = arv->baldes[hash_pid(pid, arv->num_baldes)];
+    for (; p; p = p->prox) {
+        if (p->pid == pid) return p;
+    }
+    return NULL;
+}
+
+static int redimensionar(arvore_t *arv) {
+    size_t novo_num = arv->num_baldes * 2;
+    arvore_proc_t **novos = (arvore_proc_t **)calloc(novo_num, sizeof(*novos));
+    if (!novos) return -1;
+
+    for (size_t b = 0; b < arv->num_baldes; b++) {
+        arvore_proc_t *p = arv->baldes[b];
+        while (p) {
+            arvore_proc_t *prox = p->prox;
+            size_t idx = hash_pid(p->pid, novo_num);
+            p->prox = novos[idx];
+            novos[idx] = p;
+            p = prox;
+        }
+    }
+
+    free(arv->baldes);
+    arv->baldes     = novos;
+    arv->num_baldes = novo_num;
+    return 0;
+}
+
+/* Relê /proc/<pid>/stat: ppid, comm, tempos (com filhos recolhidos), starttime e RSS */
+static int ler_stat(arvore_t *arv, arvore_proc_t *p, long pagina_kb) {
+    static const unsigned long long pedidos =
+        PSTAT_BIT(PSTAT_PPID) | PSTAT_BIT(PSTAT_UTIME) | PSTAT_BIT(PSTAT_STIME) |
+        PSTAT_BIT(PSTAT_CUTIME) | PSTAT_BIT(PSTAT_CSTIME) | PSTAT_BIT(PSTAT_STARTTIME) |
+        PSTAT_BIT(PSTAT_RSS);
+
+    char caminho[64];
+    char buf[1024];
+    snprintf(caminho, sizeof(caminho), "%d/stat", p->pid);
+    arv->leituras++;
+    if (proc_ler_arquivo(dirfd(arv->dir), caminho, buf, sizeof(buf)) <= 0) return -1;
+
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(buf, pedidos, &c) != 0) return -1;
+
+    memcpy(p->comm, c.comm, sizeof(p->comm));
+    p->ppid      = (pid_t)c.campos[PSTAT_PPID];
+    p->cpu_ticks = c.campos[PSTAT_UTIME] + c.campos[PSTAT_STIME] +
+                   c.campos[PSTAT_CUTIME] + c.campos[PSTAT_CSTIME];
+    p->starttime = c.campos[PSTAT_STARTTIME];
+    p->rss_kb    = c.campos[PSTAT_RSS] * (unsigned long long)pagina_kb;
+    p->lido      = 1;
+    return 0;
+}
+
+/* /proc/<pid>/io pode ser negado (outro usuário): os contadores ficam como estavam */
+static void ler_io(arvore_t *arv, arvore_proc_t *p) {
+    char caminho[64];
+    char buf[1024];
+    snprintf(caminho, sizeof(caminho), "%d/io", p->pid);
+    arv->leituras++;
+    if (proc_ler_arquivo(dirfd(arv->dir), caminho, buf, sizeof(buf)) <= 0) return;
+
+    io_stats_t io;
+    if (io_interpretar_processo(buf, NULL, &io) == 0) {
+        p->read_bytes  = io.read_bytes;
+        p->write_bytes = io.write_bytes;
+    }
+}
+
+/*
+ * Sobe pela cadeia de ppid até achar a raiz, um processo já classificado ou
+ * um pai desconhecido; toda a cadeia percorrida recebe o mesmo resultado.
+ */
+static arvore_membro_t resolver_membro(arvore_t *arv, arvore_proc_t *p) {
+    arvore_proc_t *cadeia[ARVORE_PROFUNDIDADE_MAX];
+    size_t n = 0;
+    arvore_membro_t estado = ARVORE_FORA;
+
+    while (p) {
+        if (p->membro != ARVORE_INDEFINIDO) {
+            estado = p->membro;
+            break;
+        }
+        if (n == ARVORE_PROFUNDIDADE_MAX) break;
+        cadeia[n++] = p;
+        p = (p->ppid > 0) ? buscar(arv, p->ppid) : NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) cadeia[i]->membro = estado;
+    return estado;
+}
+
+/* ==================== CICLO DE VIDA ==================== */
+
+int arvore_iniciar(arvore_t *arv, pid_t raiz) {
+    if (!arv || raiz <= 0) {
+        fprintf(stderr, "arvore_iniciar: parâmetros inválidos\n");
+        return -1;
+    }
+    memset(arv, 0, sizeof(*arv));
+    arv->raiz = raiz;
+
+    arv->baldes = (arvore_proc_t **)calloc(ARVORE_BALDES_INICIAIS, sizeof(*arv->baldes));
+    if (!arv->baldes) {
+        fprintf(stderr, "arvore_iniciar: sem memória\n");
+        return -1;
+    }
+    arv->num_baldes = ARVORE_BALDES_INICIAIS;
+
+    arv->dir = opendir("/proc");
+    if (!arv->dir) {
+        perror("arvore_iniciar: /proc");
+        free(arv->baldes);
+        arv->baldes = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void arvore_destruir(arvore_t *arv) {
+    if (!arv) return;
+    for (size_t b = 0; b < arv->num_baldes && arv->baldes; b++) {
+        arvore_proc_t *p = arv->baldes[b];
+        while (p) {
+            arvore_proc_t *prox = p->prox;
+            free(p);
+            p = prox;
+        }
+    }
+    free(arv->baldes);
+    if (arv->dir) closedir(arv->dir);
+    memset(arv, 0, sizeof(*arv));
+}
+
+/* ==================== VARREDURA INCREMENTAL ==================== */
+
+int arvore_varrer(arvore_t *arv) {
+    if (!arv || !arv->baldes || !arv->dir) return -1;
+
+    long pagina_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (pagina_kb <= 0) pagina_kb = 4;
+
+    arv->geracao++;
+    arv->novos      = 0;
+    arv->encerrados = 0;
+    arv->leituras   = 0;
+    rewinddir(arv->dir);
+
+    /* ---- 1) lista /proc: só relê quem é membro, novo ou com inode diferente ---- */
+    struct dirent *ent;
+    while ((ent = readdir(arv->dir)) != NULL) {
+        if (!nome_numerico(ent->d_name)) continue;
+        pid_t pid = (pid_t)atoi(ent->d_name);
+
+        arvore_proc_t *p = buscar(arv, pid);
+        if (p) {
+            p->lido = 0;
+            if (p->membro != ARVORE_MEMBRO && p->ino == ent->d_ino) {
+                p->geracao = arv->geracao;
+                continue;
+            }
+
+            // relido numa cópia: o starttime decide se ainda é o mesmo processo
+            arvore_proc_t relido = *p;
+            if (ler_stat(arv, &relido, pagina_kb) != 0) continue;  // já terminou: sai na limpeza
+            if (relido.starttime == p->starttime) {
+                *p = relido;
+                p->ino     = ent->d_ino;
+                p->geracao = arv->geracao;
+                continue;
+            }
+
+            // mesmo PID, outro processo: recomeça do zero
+            if (p->membro == ARVORE_MEMBRO) arv->encerrados++;
+            arvore_proc_t *prox = p->prox;
+            memset(p, 0, sizeof(*p));
+            p->prox = prox;
+        } else {
+            p = (arvore_proc_t *)calloc(1, sizeof(*p));
+            if (!p) {
+                fprintf(stderr, "arvore_varrer: sem memória\n");
+                return -1;
+            }
+            size_t idx = hash_pid(pid, arv->num_baldes);
+            p->prox = arv->baldes[idx];
+            arv->baldes[idx] = p;
+            arv->num_procs++;
+        }
+
+        p->pid = pid;
+        p->ino = ent->d_ino;
+        if (ler_stat(arv, p, pagina_kb) != 0) continue;  // já terminou: sai na limpeza
+        p->geracao = arv->geracao;
+    }
+
+    /* ---- 2) remove quem sumiu ---- */
+    for (size_t b = 0; b < arv->num_baldes; b++) {
+        arvore_proc_t **ref = &arv->baldes[b];
+        while (*ref) {
+            if ((*ref)->geracao != arv->geracao) {
+                arvore_proc_t *morto = *ref;
+                if (morto->membro == ARVORE_MEMBRO) arv->encerrados++;
+                *ref = morto->prox;
+                free(morto);
+                arv->num_procs--;
+            } else {
+                ref = &(*ref)->prox;
+            }
+        }
+    }
+
+    /* ---- 3) órfãos: o pai sumiu, então o ppid mudou (init ou subreaper) ---- */
+    for (size_t b = 0; b < arv->num_baldes; b++) {
+        for (arvore_proc_t *p = arv->baldes[b]; p; p = p->prox) {
+            if (!p->lido && p->ppid > 0 && !buscar(arv, p->ppid)) {
+                ler_stat(arv, p, pagina_kb);
+            }
+        }
+    }
+
+    /* ---- 4) reclassifica (só memória) a partir do ppid de cada processo ---- */
+    arvore_proc_t *raiz = buscar(arv, arv->raiz);
+    if (!raiz) return 0;
+
+    for (size_t b = 0; b < arv->num_baldes; b++) {
+        for (arvore_proc_t *p = arv->baldes[b]; p; p = p->prox) {
+            p->era_membro = (p->membro == ARVORE_MEMBRO);
+            p->membro     = ARVORE_INDEFINIDO;
+        }
+    }
+    raiz->membro = ARVORE_MEMBRO;
+
+    memset(&arv->totais, 0, sizeof(arv->totais));
+    for (size_t b = 0; b < arv->num_baldes; b++) {
+        for (arvore_proc_t *p = arv->baldes[b]; p; p = p->prox) {
+            if (resolver_membro(arv, p) != ARVORE_MEMBRO) continue;
+
+            // entrou na árvore sem ter sido relido (adotado por um subreaper membro)
+            if (!p->lido) ler_stat(arv, p, pagina_kb);
+            ler_io(arv, p);
+            if (!p->era_membro) arv->novos++;
+
+            arv->totais.processos++;
+            arv->totais.cpu_ticks   += p->cpu_ticks;
+            arv->totais.rss_kb      += p->rss_kb;
+            arv->totais.read_bytes  += p->read_bytes;
+            arv->totais.write_bytes += p->write_bytes;
+        }
+    }
+
+    if (arv->num_procs > arv->num_baldes && redimensionar(arv) != 0) {
+        fprintf(stderr, "arvore_varrer: falha ao redimensionar tabela (continuando)\n");
+    }
+
+    return (int)arv->totais.processos;
+}
+
+/* ==================== CÁLCULO ==================== */
+
+void arvore_calcular_taxas(const arvore_totais_t *antes, const arvore_totais_t *depois,
+                           unsigned long long delta_sys, long long decorrido_ns,
+                           arvore_taxas_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!antes || !depois) return;
+
+    /*
+     * A soma pode cair quando um membro sai da árvore sem ser recolhido por
+     * outro membro (órfão adotado pelo init): esse intervalo conta como 0.
+     */
+    if (delta_sys > 0 && depois->cpu_ticks > antes->cpu_ticks) {
+        out->cpu_percent = (double)(depois->cpu_ticks - antes->cpu_ticks) /
+                           (double)delta_sys * 100.0;
+    }
+
+    if (decorrido_ns > 0) {
+        double s = (double)decorrido_ns / 1e9;
+        if (depois->read_bytes > antes->read_bytes) {
+            out->read_bps = (double)(depois->read_bytes - antes->read_bytes) / s;
+        }
+        if (depois->write_bytes > antes->write_bytes) {
+            out->write_bps = (double)(depois->write_bytes - antes->write_bytes) / s;
+        }
+    }
+}
+
+/* ==================== MONITORAMENTO CONTÍNUO (CSV) ==================== */
+
+int arvore_monitorar_csv(pid_t raiz, int intervalo_ms, int amostras, FILE *saida) {
+    if (raiz <= 0 || intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "arvore_monitorar_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    arvore_t arv;
+    if (arvore_iniciar(&arv, raiz) != 0) return -1;
+
+    cpu_times_t sys_antes, sys_depois;
+    if (cpu_ler_times_sistema(&sys_antes) != 0 || arvore_varrer(&arv) <= 0) {
+        fprintf(stderr, "Processo %d não encontrado ou sem permissão\n", raiz);
+        arvore_destruir(&arv);
+        return -1;
+    }
+    arvore_totais_t antes = arv.totais;
+    long long mono_antes = agendador_agora_ns();
+
+    fprintf(saida, "timestamp,amostra,processos,novos,encerrados,cpu_percent,rss_kb,"
+                   "read_bps,write_bps\n");
+    fflush(saida);
+
+    if (saida != stdout) {
+        fprintf(stderr, "Monitorando a árvore do PID %d (%d amostras, intervalo: %dms)\n",
+                raiz, amostras, intervalo_ms);
+    }
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    unsigned long long leituras = 0;
+    int i;
+    for (i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        if (cpu_ler_times_sistema(&sys_depois) != 0) {
+            rc = -1;
+            break;
+        }
+        int vivos = arvore_varrer(&arv);
+        long long mono_depois = agendador_agora_ns();
+        if (vivos < 0) {
+            fprintf(stderr, "Falha na varredura de /proc (amostra %d)\n", i);
+            rc = -1;
+            break;
+        }
+        if (vivos == 0) {
+            fprintf(stderr, "Processo raiz %d terminou (amostra %d)\n", raiz, i);
+            break;
+        }
+        leituras += arv.leituras;
+
+        arvore_taxas_t t;
+        unsigned long long delta_sys = (sys_depois.total > sys_antes.total)
+                                       ? sys_depois.total - sys_antes.total : 0;
+        arvore_calcular_taxas(&antes, &arv.totais, delta_sys, mono_depois - mono_antes, &t);
+
+        char ts[CARIMBO_TAM];
+        carimbo_texto_agora(ts, sizeof(ts), NULL);
+        fprintf(saida, "%s,%d,%zu,%zu,%zu,%.2f,%llu,%.0f,%.0f\n",
+                ts, i, arv.totais.processos, arv.novos, arv.encerrados,
+                t.cpu_percent, arv.totais.rss_kb, t.read_bps, t.write_bps);
+        fflush(saida);
+
+        antes      = arv.totais;
+        sys_antes  = sys_depois;
+        mono_antes = mono_depois;
+    }
+
+    agendador_relatar(&ag, "Monitoramento da árvore");
+    if (i > 0) {
+        fprintf(stderr, "Árvore do PID %d: %.1f leituras de /proc por amostra (%zu processos no sistema)\n",
+                raiz, (double)leituras / i, arv.num_procs);
+    }
+
+    arvore_destruir(&arv);
+    return rc;
+}
@@ -0,0 +1,359 @@
+// psi.c - Pressure Stall Information da máquina e de cgroups, com gatilhos POLLPRI
+#define _POSIX_C_SOURCE 200809L  // openat, AT_FDCWD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "../include/psi.h"
+#include "../include/proc_cache.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+
+static const char *const NOMES[PSI_NUM_RECURSOS] = { "cpu", "memory", "io" };
+
+const char *psi_nome_recurso(psi_recurso_t r) {
+    return (unsigned)r < PSI_NUM_RECURSOS ? NOMES[r] : "?";
+}
+
+/* ==================== LEITURA ==================== */
+
+int psi_interpretar(const char *conteudo, psi_t *out) {
+    if (!conteudo || !out) return -1;
+    memset(out, 0, sizeof(*out));
+
+    int tem_some = 0;
+    for (const char *linha = conteudo; linha && *linha; ) {
+        char tipo[8];
+        psi_linha_t l;
+        if (sscanf(linha, "%7s avg10=%lf avg60=%lf avg300=%lf total=%llu",
+                   tipo, &l.avg10, &l.avg60, &l.avg300, &l.total_us) == 5) {
+            if (strcmp(tipo, "some") == 0) {
+                out->some = l;
+                tem_some  = 1;
+            } else if (strcmp(tipo, "full") == 0) {
+                out->full     = l;
+                out->tem_full = 1;
+            }
+        }
+        linha = strchr(linha, '\n');
+        if (linha) linha++;
+    }
+    return tem_some ? 0 : -1;
+}
+
+int psi_ler_sistema(psi_recurso_t r, psi_t *out) {
+    if ((unsigned)r >= PSI_NUM_RECURSOS || !out) return -1;
+
+    // mesmo caminho de /proc/stat: descritor aberto entre amostras, pread no offset 0
+    const char *buf = proc_cache_ler_sistema((proc_arquivo_sistema_t)(PROC_SIS_PSI_CPU + (int)r), NULL);
+    if (!buf) return -1;
+    return psi_interpretar(buf, out);
+}
+
+/* v2 puro: /sys/fs/cgroup; híbrido: a árvore v2 fica em /sys/fs/cgroup/unified */
+static const char *raiz_cgroup2(void) {
+    static const char *raiz = NULL;
+    if (!raiz) {
+        raiz = access("/sys/fs/cgroup/cgroup.controllers", F_OK) == 0 ? "/sys/fs/cgroup"
+                                                                     : "/sys/fs/cgroup/unified";
+    }
+    return raiz;
+}
+
+static int caminho_pressao(const char *cgroup, int de_cgroup, psi_recurso_t r, char *out, size_t tam) {
+    int n;
+    if (!de_cgroup) {
+        n = snprintf(out, tam, "/proc/pressure/%s", NOMES[r]);
+    } else if (!cgroup || !cgroup[0]) {
+        n = snprintf(out, tam, "%s/%s.pressure", raiz_cgroup2(), NOMES[r]);
+    } else {
+        while (*cgroup == '/') cgroup++;
+        n = snprintf(out, tam, "%s/%s/%s.pressure", raiz_cgroup2(), cgroup, NOMES[r]);
+    }
+    return (n < 0 || (size_t)n >= tam) ? -1 : 0;
+}
+
+int psi_ler_cgroup(const char *cgroup, psi_recurso_t r, psi_t *out) {
+    if ((unsigned)r >= PSI_NUM_RECURSOS || !out) return -1;
+
+    char caminho[PSI_CGROUP_MAX + 64], buf[256];
+    if (caminho_pressao(cgroup, 1, r, caminho, sizeof(caminho)) != 0) return -1;
+    if (proc_ler_arquivo(AT_FDCWD, caminho, buf, sizeof(buf)) < 0) return -1;
+    return psi_interpretar(buf, out);
+}
+
+/* ==================== GATILHOS ==================== */
+
+/* "150ms", "2s", "500000us"; sem unidade = µs (como o kernel) */
+static int ler_duracao_us(const char *tok, unsigned *out) {
+    char *fim;
+    double v = strtod(tok, &fim);
+    double escala;
+    if (fim == tok || v <= 0.0) return -1;
+    if (*fim == '\0' || strcmp(fim, "us") == 0) escala = 1.0;
+    else if (strcmp(fim, "ms") == 0)            escala = 1e3;
+    else if (strcmp(fim, "s") == 0)             escala = 1e6;
+    else return -1;
+
+    double us = v * escala;
+    if (us < 1.0 || us > 4e9) return -1;
+    *out = (unsigned)(us + 0.5);
+    return 0;
+}
+
+static int gatilho_invalido(const char *texto, const char *motivo) {
+    fprintf(stderr, "Gatilho PSI inválido '%s': %s\n", texto, motivo);
+    return -1;
+}
+
+int psi_gatilho_interpretar(const char *texto, psi_gatilho_t *g) {
+    if (!texto || !g) return -1;
+    memset(g, 0, sizeof(*g));
+
+    char recurso[16], tipo[8], limite[32], janela[32], cgroup[PSI_CGROUP_MAX];
+    cgroup[0] = '\0';
+    int n = sscanf(texto, "%15s %7s %31s %31s %255s", recurso, tipo, limite, janela, cgroup);
+    if (n < 4) return gatilho_invalido(texto, "esperado <recurso> <some|full> <limite> <janela> [cgroup]");
+
+    int r;
+    for (r = 0; r < PSI_NUM_RECURSOS && strcmp(recurso, NOMES[r]) != 0; r++) {}
+    if (r == PSI_NUM_RECURSOS) return gatilho_invalido(texto, "recurso deve ser cpu, memory ou io");
+    g->recurso = (psi_recurso_t)r;
+
+    if (strcmp(tipo, "full") == 0)      g->full = 1;
+    else if (strcmp(tipo, "some") != 0) return gatilho_invalido(texto, "tipo deve ser some ou full");
+
+    if (ler_duracao_us(limite, &g->limite_us) != 0 || ler_duracao_us(janela, &g->janela_us) != 0) {
+        return gatilho_invalido(texto, "durações aceitam us, ms ou s (ex.: 150ms 2s)");
+    }
+    if (g->janela_us < PSI_JANELA_MIN_US || g->janela_us > PSI_JANELA_MAX_US) {
+        return gatilho_invalido(texto, "janela deve ficar entre 500ms e 10s");
+    }
+    if (g->limite_us > g->janela_us) return gatilho_invalido(texto, "limite maior que a janela");
+
+    if (n == 5) {
+        const char *cg = cgroup;
+        while (*cg == '/') cg++;
+        snprintf(g->cgroup, sizeof(g->cgroup), "%s", cg);
+        g->de_cgroup = 1;
+    }
+    return 0;
+}
+
+int psi_gatilho_abrir(const psi_gatilho_t *g) {
+    if (!g) return -1;
+
+    char caminho[PSI_CGROUP_MAX + 64];
+    if (caminho_pressao(g->cgroup, g->de_cgroup, g->recurso, caminho, sizeof(caminho)) != 0) return -1;
+
+    // o gatilho pertence ao fd: fechar o fd desfaz o registro no kernel
+    int fd = open(caminho, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Falha ao abrir %s: %s%s\n", caminho, strerror(errno),
+                errno == ENOENT ? " (kernel sem PSI, psi=0 no boot ou cgroup inexistente)" : "");
+        return -1;
+    }
+
+    char pedido[64];
+    snprintf(pedido, sizeof(pedido), "%s %u %u", g->full ? "full" : "some", g->limite_us, g->janela_us);
+    if (write(fd, pedido, strlen(pedido) + 1) < 0) {
+        int erro = errno;
+        fprintf(stderr, "Gatilho PSI recusado em %s (\"%s\"): %s%s\n", caminho, pedido, strerror(erro),
+                erro == EINVAL && g->janela_us % 2000000U != 0
+                    ? " (sem CAP_SYS_RESOURCE a janela precisa ser múltipla de 2s)" : "");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int psi_gatilho_ler(const psi_gatilho_t *g, psi_t *out) {
+    if (!g) return -1;
+    return g->de_cgroup ? psi_ler_cgroup(g->cgroup, g->recurso, out)
+                        : psi_ler_sistema(g->recurso, out);
+}
+
+void psi_gatilho_descrever(const psi_gatilho_t *g, char *buf, size_t tam) {
+    snprintf(buf, tam, "%s %s %.0fms/%.0fms%s%s", NOMES[g->recurso], g->full ? "full" : "some",
+             g->limite_us / 1e3, g->janela_us / 1e3, g->de_cgroup ? " /" : "", g->de_cgroup ? g->cgroup : "");
+}
+
+/* ==================== LOOPS CSV ==================== */
+
+static int ler_todos(const char *cgroup, psi_t p[PSI_NUM_RECURSOS], int *disponiveis) {
+    *disponiveis = 0;
+    for (int r = 0; r < PSI_NUM_RECURSOS; r++) {
+        int rc = cgroup ? psi_ler_cgroup(cgroup, (psi_recurso_t)r, &p[r])
+                        : psi_ler_sistema((psi_recurso_t)r, &p[r]);
+        if (rc == 0) (*disponiveis)++;
+        else memset(&p[r], 0, sizeof(p[r]));
+    }
+    return *disponiveis > 0 ? 0 : -1;
+}
+
+static double ms_por_segundo(unsigned long long depois, unsigned long long antes, double s) {
+    return depois > antes ? (double)(depois - antes) / 1e3 / s : 0.0;
+}
+
+int psi_monitorar_csv(const char *cgroup, int intervalo_ms, int amostras, FILE *saida) {
+    if (intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "psi_monitorar_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    psi_t antes[PSI_NUM_RECURSOS], depois[PSI_NUM_RECURSOS];
+    int disponiveis;
+    if (ler_todos(cgroup, antes, &disponiveis) != 0) {
+        fprintf(stderr, "Pressão indisponível para %s%s (kernel sem PSI, psi=0 no boot ou cgroup fora da "
+                        "árvore v2)\n", cgroup ? "o cgroup /" : "a máquina", cgroup ? cgroup : "");
+        return -1;
+    }
+    carimbo_t quando;
+    carimbo_agora(&quando);
+    long long mono_antes = quando.mono_ns;
+
+    // avg10 em % (média do kernel) e ms parados por segundo no intervalo (delta de total)
+    fprintf(saida, "timestamp,amostra");
+    for (int r = 0; r < PSI_NUM_RECURSOS; r++) {
+        fprintf(saida, ",%s_some_avg10,%s_some_ms_s,%s_full_avg10,%s_full_ms_s",
+                NOMES[r], NOMES[r], NOMES[r], NOMES[r]);
+    }
+    fprintf(saida, "\n");
+    fflush(saida);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0;
+    for (int i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        if (ler_todos(cgroup, depois, &disponiveis) != 0) {
+            fprintf(stderr, "Arquivos de pressão sumiram (amostra %d; cgroup removido?)\n", i);
+            rc = -1;
+            break;
+        }
+        // um carimbo por amostra: o texto da linha e o fim do intervalo das taxas
+        carimbo_agora(&quando);
+        long long mono_depois = quando.mono_ns;
+        double s = (double)(mono_depois - mono_antes) / 1e9;
+        if (s <= 0.0) s = 1e-9;
+
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(quando.real_ns, ts, sizeof(ts));
+        fprintf(saida, "%s,%d", ts, i);
+        for (int r = 0; r < PSI_NUM_RECURSOS; r++) {
+            fprintf(saida, ",%.2f,%.3f,%.2f,%.3f",
+                    depois[r].some.avg10, ms_por_segundo(depois[r].some.total_us, antes[r].some.total_us, s),
+                    depois[r].full.avg10, ms_por_segundo(depois[r].full.total_us, antes[r].full.total_us, s));
+        }
+        fprintf(saida, "\n");
+        fflush(saida);
+
+        memcpy(antes, depois, sizeof(antes));
+        mono_antes = mono_depois;
+    }
+
+    agendador_relatar(&ag, "Monitoramento de pressão");
+    return rc;
+}
+
+/* Campo CSV entre aspas (RFC 4180): a descrição traz espaços e o caminho do cgroup */
+static void csv_aspas(FILE *saida, const char *texto) {
+    fputc('"', saida);
+    for (; *texto; texto++) {
+        if (*texto == '"') fputc('"', saida);
+        fputc(*texto, saida);
+    }
+    fputc('"', saida);
+}
+
+int psi_vigiar_csv(const psi_gatilho_t *gatilhos, int num, int eventos, FILE *saida) {
+    if (!gatilhos || num <= 0 || eventos <= 0) {
+        fprintf(stderr, "psi_vigiar_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    struct pollfd *fds = (struct pollfd *)calloc((size_t)num, sizeof(*fds));
+    unsigned long long *base = (unsigned long long *)calloc((size_t)num, sizeof(*base));
+    if (!fds || !base) {
+        free(fds);
+        free(base);
+        return -1;
+    }
+
+    for (int k = 0; k < num; k++) fds[k].fd = -1;
+
+    int rc = 0, ativos = 0;
+    for (int k = 0; k < num; k++) {
+        fds[k].fd     = psi_gatilho_abrir(&gatilhos[k]);
+        fds[k].events = POLLPRI;
+        if (fds[k].fd < 0) {
+            rc = -1;
+            break;
+        }
+        psi_t p;
+        if (psi_gatilho_ler(&gatilhos[k], &p) == 0) base[k] = gatilhos[k].full ? p.full.total_us : p.some.total_us;
+        ativos++;
+    }
+
+    if (rc == 0) {
+        fprintf(saida, "timestamp,evento,gatilho,some_avg10,full_avg10,parado_ms\n");
+        fflush(saida);
+        fprintf(stderr, "Aguardando %d gatilho(s) de pressão (%d eventos)...\n", num, eventos);
+    }
+
+    // sem timeout: nenhuma amostra é feita enquanto não há saturação
+    int vistos = 0;
+    while (rc == 0 && vistos < eventos && ativos > 0) {
+        if (poll(fds, (nfds_t)num, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("psi: poll");
+            rc = -1;
+            break;
+        }
+        for (int k = 0; k < num && vistos < eventos; k++) {
+            char desc[PSI_CGROUP_MAX + 48];
+            psi_gatilho_descrever(&gatilhos[k], desc, sizeof(desc));
+            if (fds[k].revents & POLLERR) {
+                fprintf(stderr, "Gatilho '%s' encerrado (cgroup removido)\n", desc);
+                close(fds[k].fd);
+                fds[k].fd = -1;  // ignorado pelo poll daqui em diante
+                ativos--;
+                continue;
+            }
+            if (!(fds[k].revents & POLLPRI)) continue;
+
+            psi_t p;
+            memset(&p, 0, sizeof(p));
+            psi_gatilho_ler(&gatilhos[k], &p);
+            unsigned long long total = gatilhos[k].full ? p.full.total_us : p.some.total_us;
+
+            carimbo_t quando;
+            carimbo_agora(&quando);
+            char ts[CARIMBO_TAM];
+            carimbo_formatar(quando.real_ns, ts, sizeof(ts));
+            fprintf(saida, "%s,%d,", ts, vistos);
+            csv_aspas(saida, desc);
+            fprintf(saida, ",%.2f,%.2f,%.3f\n", p.some.avg10, p.full.avg10,
+                    total > base[k] ? (double)(total - base[k]) / 1e3 : 0.0);
+            fflush(saida);
+            base[k] = total;
+            vistos++;
+        }
+    }
+
+    for (int k = 0; k < num; k++) {
+        if (fds[k].fd >= 0) close(fds[k].fd);
+    }
+    free(fds);
+    free(base);
+    return rc;
+}
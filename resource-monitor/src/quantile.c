@@ -0,0 +1,129 @@
+// quantile.c - histograma log-linear mesclável para percentis com memória fixa
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/quantile.h"
+
+/* ==================== MAPEAMENTO VALOR <-> BALDE ==================== */
+
+/* Índice do balde de v > 0, ou -1 se v está abaixo da faixa */
+static int balde_de(double v) {
+    int e;
+    double m = frexp(v, &e);    // v = m * 2^e, m em [0.5, 1)
+    if (e <= QUANTIL_EXP_MIN) return -1;
+    if (e > QUANTIL_EXP_MAX) return QUANTIL_BALDES - 1;
+    int sub = (int)((m - 0.5) * 2.0 * QUANTIL_SUB);
+    if (sub >= QUANTIL_SUB) sub = QUANTIL_SUB - 1;
+    return (e - QUANTIL_EXP_MIN - 1) * QUANTIL_SUB + sub;
+}
+
+/* Ponto médio do balde: metade da largura é o erro máximo */
+static double centro_do_balde(int b) {
+    int e   = b / QUANTIL_SUB + QUANTIL_EXP_MIN + 1;
+    int sub = b % QUANTIL_SUB;
+    return ldexp(0.5 + (sub + 0.5) / (2.0 * QUANTIL_SUB), e);
+}
+
+/* ==================== API ==================== */
+
+int quantil_iniciar(quantil_t *q) {
+    if (!q) return -1;
+    memset(q, 0, sizeof(*q));
+    q->baldes = (uint32_t *)calloc(QUANTIL_BALDES, sizeof(uint32_t));
+    if (!q->baldes) {
+        fprintf(stderr, "quantil_iniciar: sem memória\n");
+        return -1;
+    }
+    return 0;
+}
+
+void quantil_liberar(quantil_t *q) {
+    if (!q) return;
+    free(q->baldes);
+    memset(q, 0, sizeof(*q));
+}
+
+void quantil_zerar(quantil_t *q) {
+    if (!q || !q->baldes) return;
+    memset(q->baldes, 0, QUANTIL_BALDES * sizeof(uint32_t));
+    q->zeros = q->contagem = 0;
+    q->min = q->max = q->soma = 0.0;
+}
+
+void quantil_registrar(quantil_t *q, double valor) {
+    if (!q || !q->baldes || valor != valor) return;
+
+    if (q->contagem == 0) {
+        q->min = q->max = valor;
+    } else {
+        if (valor < q->min) q->min = valor;
+        if (valor > q->max) q->max = valor;
+    }
+    q->soma += valor;
+    q->contagem++;
+
+    int b = valor > 0 ? balde_de(valor) : -1;
+    if (b < 0) q->zeros++;
+    else       q->baldes[b]++;
+}
+
+int quantil_mesclar(quantil_t *dest, const quantil_t *orig) {
+    if (!dest || !dest->baldes || !orig || !orig->baldes) return -1;
+    if (orig->contagem == 0) return 0;
+
+    if (dest->contagem == 0) {
+        dest->min = orig->min;
+        dest->max = orig->max;
+    } else {
+        if (orig->min < dest->min) dest->min = orig->min;
+        if (orig->max > dest->max) dest->max = orig->max;
+    }
+    for (int b = 0; b < QUANTIL_BALDES; b++) dest->baldes[b] += orig->baldes[b];
+    dest->zeros    += orig->zeros;
+    dest->contagem += orig->contagem;
+    dest->soma     += orig->soma;
+    return 0;
+}
+
+double quantil_valor(const quantil_t *q, double p) {
+    if (!q || !q->baldes || q->contagem == 0) return 0.0;
+    if (p <= 0.0) return q->min;
+    if (p >= 1.0) return q->max;
+
+    // posição (1..contagem) da amostra que corresponde ao percentil
+    unsigned long long alvo = (unsigned long long)ceil(p * (double)q->contagem);
+    if (alvo == 0) alvo = 1;
+
+    double v = q->max;
+    unsigned long long acumulado = q->zeros;
+    if (acumulado >= alvo) {
+        v = q->min < 0 ? q->min : 0.0;
+    } else {
+        for (int b = 0; b < QUANTIL_BALDES; b++) {
+            acumulado += q->baldes[b];
+            if (acumulado >= alvo) {
+                v = centro_do_balde(b);
+                break;
+            }
+        }
+    }
+    // o centro do balde pode cair fora do que foi realmente observado
+    if (v < q->min) v = q->min;
+    if (v > q->max) v = q->max;
+    return v;
+}
+
+double quantil_media(const quantil_t *q) {
+    return (q && q->contagem) ? q->soma / (double)q->contagem : 0.0;
+}
+
+void quantil_imprimir(FILE *out, const quantil_t *q, const char *rotulo, const char *unidade) {
+    if (!out || !q || q->contagem == 0) return;
+    fprintf(out, "  %-14s mín %10.2f | p50 %10.2f | p90 %10.2f | p99 %10.2f | máx %10.2f %s\n",
+            rotulo ? rotulo : "", q->min, quantil_valor(q, 0.50), quantil_valor(q, 0.90),
+            quantil_valor(q, 0.99), q->max, unidade ? unidade : "");
+}
@@ -0,0 +1,502 @@
+// recording.c - gravação binária colunar (delta, delta-of-delta, XOR) e conversão para CSV
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/formatter.h"
+#include "../include/recording.h"
+#include "../include/timestamp.h"
+
+static const char MAGICO[4] = { 'R', 'M', 'B', '1' };
+#define VERSAO        1
+#define MARCA_BLOCO   0xB1
+#define COLUNAS_MAX   256
+
+/* pior caso por valor: varint de 10 bytes ou 2+5+6+64 bits de XOR */
+#define BYTES_POR_VALOR_MAX 10
+#define CAP_COLUNA (GRAVACAO_LINHAS_BLOCO * BYTES_POR_VALOR_MAX + 16)
+
+/* ==================== VARINT / ZIGZAG ==================== */
+
+static unsigned long long zigzag(long long v) {
+    return ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63);
+}
+
+static long long dezigzag(unsigned long long u) {
+    return (long long)(u >> 1) ^ -(long long)(u & 1);
+}
+
+/* diferença sem overflow com sinal */
+static long long diferenca(long long a, long long b) {
+    return (long long)((unsigned long long)a - (unsigned long long)b);
+}
+
+static long long soma(long long a, long long b) {
+    return (long long)((unsigned long long)a + (unsigned long long)b);
+}
+
+static size_t por_varint(unsigned char *p, unsigned long long v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+/* Retorna bytes consumidos ou 0 se o buffer acabou / varint longo demais */
+static size_t tirar_varint(const unsigned char *p, size_t tam, unsigned long long *v) {
+    unsigned long long r = 0;
+    for (size_t n = 0; n < tam && n < 10; n++) {
+        r |= (unsigned long long)(p[n] & 0x7f) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *v = r;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static int escrever_varint(FILE *f, unsigned long long v, unsigned long long *bytes) {
+    unsigned char tmp[10];
+    size_t n = por_varint(tmp, v);
+    if (bytes) *bytes += n;
+    return fwrite(tmp, 1, n, f) == n ? 0 : -1;
+}
+
+static int ler_varint(FILE *f, unsigned long long *v) {
+    unsigned long long r = 0;
+    for (int n = 0; n < 10; n++) {
+        int c = fgetc(f);
+        if (c == EOF) return -1;
+        r |= (unsigned long long)(c & 0x7f) << (7 * n);
+        if (!(c & 0x80)) {
+            *v = r;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ==================== FLUXO DE BITS (XOR) ==================== */
+
+typedef struct {
+    unsigned char *p;
+    size_t         cap;
+    size_t         pos;     // em bits
+} bits_t;
+
+static void bits_por(bits_t *b, unsigned long long v, int n) {
+    for (int k = n - 1; k >= 0; k--) {
+        size_t byte = b->pos >> 3;
+        int    bit  = 7 - (int)(b->pos & 7);
+        if (bit == 7) b->p[byte] = 0;
+        b->p[byte] |= (unsigned char)(((v >> k) & 1u) << bit);
+        b->pos++;
+    }
+}
+
+static int bits_tirar(bits_t *b, int n, unsigned long long *v) {
+    if (b->pos + (size_t)n > b->cap * 8) return -1;
+    unsigned long long r = 0;
+    for (int k = 0; k < n; k++) {
+        size_t byte = b->pos >> 3;
+        int    bit  = 7 - (int)(b->pos & 7);
+        r = (r << 1) | ((b->p[byte] >> bit) & 1u);
+        b->pos++;
+    }
+    *v = r;
+    return 0;
+}
+
+static unsigned long long bits_de_double(double d) {
+    unsigned long long u;
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+static double double_de_bits(unsigned long long u) {
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+/* ==================== CODIFICAÇÃO DE UMA COLUNA ==================== */
+
+static size_t codificar(const gravacao_valor_t *v, size_t n, gravacao_codec_t codec,
+                        unsigned char *saida) {
+    if (codec == GRAV_XOR) {
+        bits_t b = { saida, CAP_COLUNA, 0 };
+        unsigned long long ant = bits_de_double(v[0].f);
+        int lead_ant = -1, trail_ant = 0;
+        bits_por(&b, ant, 64);
+
+        for (size_t k = 1; k < n; k++) {
+            unsigned long long atual = bits_de_double(v[k].f);
+            unsigned long long x = atual ^ ant;
+            ant = atual;
+            if (x == 0) {
+                bits_por(&b, 0, 1);  // repetido: 1 bit
+                continue;
+            }
+            int lead  = __builtin_clzll(x);
+            int trail = __builtin_ctzll(x);
+            if (lead > 31) lead = 31;
+
+            bits_por(&b, 1, 1);
+            if (lead_ant >= 0 && lead >= lead_ant && trail >= trail_ant) {
+                // cabe na janela anterior: só os bits significativos
+                bits_por(&b, 0, 1);
+                bits_por(&b, x >> trail_ant, 64 - lead_ant - trail_ant);
+            } else {
+                int sig = 64 - lead - trail;
+                bits_por(&b, 1, 1);
+                bits_por(&b, (unsigned long long)lead, 5);
+                bits_por(&b, (unsigned long long)(sig & 63), 6);  // 64 vira 0
+                bits_por(&b, x >> trail, sig);
+                lead_ant  = lead;
+                trail_ant = trail;
+            }
+        }
+        return (b.pos + 7) / 8;
+    }
+
+    size_t tam = por_varint(saida, zigzag(v[0].i));
+    long long delta_ant = 0;
+    for (size_t k = 1; k < n; k++) {
+        long long delta = diferenca(v[k].i, v[k - 1].i);
+        if (codec == GRAV_DELTA2) {
+            tam += por_varint(saida + tam, zigzag(diferenca(delta, delta_ant)));
+            delta_ant = delta;
+        } else {
+            tam += por_varint(saida + tam, zigzag(delta));
+        }
+    }
+    return tam;
+}
+
+static int decodificar(const unsigned char *dados, size_t tam, gravacao_codec_t codec,
+                       gravacao_valor_t *v, size_t n) {
+    if (n == 0) return 0;
+
+    if (codec == GRAV_XOR) {
+        bits_t b = { (unsigned char *)dados, tam, 0 };
+        unsigned long long ant, x;
+        if (bits_tirar(&b, 64, &ant) != 0) return -1;
+        v[0].f = double_de_bits(ant);
+        int lead = 0, trail = 0;
+
+        for (size_t k = 1; k < n; k++) {
+            unsigned long long flag;
+            if (bits_tirar(&b, 1, &flag) != 0) return -1;
+            if (flag) {
+                unsigned long long nova;
+                if (bits_tirar(&b, 1, &nova) != 0) return -1;
+                if (nova) {
+                    unsigned long long l, s;
+                    if (bits_tirar(&b, 5, &l) != 0 || bits_tirar(&b, 6, &s) != 0) return -1;
+                    int sig = s ? (int)s : 64;
+                    lead  = (int)l;
+                    trail = 64 - lead - sig;
+                    if (trail < 0) return -1;
+                }
+                int sig = 64 - lead - trail;
+                if (bits_tirar(&b, sig, &x) != 0) return -1;
+                ant ^= x << trail;
+            }
+            v[k].f = double_de_bits(ant);
+        }
+        return 0;
+    }
+
+    size_t pos = 0, usados;
+    unsigned long long u;
+    if ((usados = tirar_varint(dados, tam, &u)) == 0) return -1;
+    pos += usados;
+    v[0].i = dezigzag(u);
+
+    long long delta = 0;
+    for (size_t k = 1; k < n; k++) {
+        if ((usados = tirar_varint(dados + pos, tam - pos, &u)) == 0) return -1;
+        pos += usados;
+        if (codec == GRAV_DELTA2) delta = soma(delta, dezigzag(u));
+        else                      delta = dezigzag(u);
+        v[k].i = soma(v[k - 1].i, delta);
+    }
+    return 0;
+}
+
+/* ==================== ESCRITA ==================== */
+
+static int gravar_bloco(gravador_t *g) {
+    if (g->linhas == 0) return 0;
+
+    if (fputc(MARCA_BLOCO, g->arq) == EOF) return -1;
+    g->total_bytes++;
+    if (escrever_varint(g->arq, g->linhas, &g->total_bytes) != 0) return -1;
+
+    for (size_t c = 0; c < g->num_colunas; c++) {
+        size_t tam = codificar(&g->valores[c * GRAVACAO_LINHAS_BLOCO], g->linhas,
+                               g->colunas[c].codec, g->buf);
+        if (escrever_varint(g->arq, tam, &g->total_bytes) != 0 ||
+            fwrite(g->buf, 1, tam, g->arq) != tam) {
+            return -1;
+        }
+        g->total_bytes += tam;
+    }
+    g->linhas = 0;
+    return fflush(g->arq) == 0 ? 0 : -1;
+}
+
+int gravador_abrir(gravador_t *g, FILE *arq, const char *descricao,
+                   const gravacao_coluna_t *colunas, size_t num_colunas) {
+    if (!g || !arq || !colunas || num_colunas == 0 || num_colunas > COLUNAS_MAX) return -1;
+    memset(g, 0, sizeof(*g));
+
+    g->arq         = arq;
+    g->num_colunas = num_colunas;
+    g->colunas = (gravacao_coluna_t *)malloc(num_colunas * sizeof(*g->colunas));
+    g->valores = (gravacao_valor_t *)malloc(num_colunas * GRAVACAO_LINHAS_BLOCO *
+                                            sizeof(*g->valores));
+    g->buf     = (unsigned char *)malloc(CAP_COLUNA);
+    g->cap_buf = CAP_COLUNA;
+    if (!g->colunas || !g->valores || !g->buf) {
+        fprintf(stderr, "gravador_abrir: sem memória\n");
+        gravador_fechar(g);
+        return -1;
+    }
+    memcpy(g->colunas, colunas, num_colunas * sizeof(*g->colunas));
+
+    const char *d = descricao ? descricao : "";
+    size_t tam_d = strlen(d);
+    int erro = fwrite(MAGICO, 1, sizeof(MAGICO), arq) != sizeof(MAGICO);
+    erro |= escrever_varint(arq, VERSAO, NULL);
+    erro |= escrever_varint(arq, tam_d, NULL);
+    erro |= fwrite(d, 1, tam_d, arq) != tam_d;
+    erro |= escrever_varint(arq, num_colunas, NULL);
+    for (size_t c = 0; c < num_colunas && !erro; c++) {
+        size_t tam_n = strnlen(colunas[c].nome, GRAVACAO_NOME_MAX - 1);
+        erro |= escrever_varint(arq, tam_n, NULL);
+        erro |= fwrite(colunas[c].nome, 1, tam_n, arq) != tam_n;
+        erro |= fputc(colunas[c].tipo, arq) == EOF;
+        erro |= fputc(colunas[c].codec, arq) == EOF;
+        erro |= fputc(colunas[c].casas, arq) == EOF;
+    }
+    if (erro) {
+        perror("gravador_abrir: escrita do cabeçalho");
+        gravador_fechar(g);
+        return -1;
+    }
+    g->total_bytes = (unsigned long long)ftell(arq);
+    return 0;
+}
+
+int gravador_linha(gravador_t *g, const gravacao_valor_t *linha) {
+    if (!g || !g->valores || !linha) return -1;
+    for (size_t c = 0; c < g->num_colunas; c++) {
+        g->valores[c * GRAVACAO_LINHAS_BLOCO + g->linhas] = linha[c];
+    }
+    g->linhas++;
+    g->total_linhas++;
+
+    if (g->linhas == GRAVACAO_LINHAS_BLOCO && gravar_bloco(g) != 0) {
+        perror("gravador_linha: escrita do bloco");
+        return -1;
+    }
+    return 0;
+}
+
+int gravador_fechar(gravador_t *g) {
+    if (!g) return -1;
+    int rc = 0;
+    if (g->arq && g->valores && gravar_bloco(g) != 0) {
+        perror("gravador_fechar: escrita do bloco");
+        rc = -1;
+    }
+    free(g->colunas);
+    free(g->valores);
+    free(g->buf);
+    g->colunas = NULL;
+    g->valores = NULL;
+    g->buf     = NULL;
+    return rc;
+}
+
+/* ==================== LEITURA ==================== */
+
+int leitor_abrir(leitor_gravacao_t *l, FILE *arq) {
+    if (!l || !arq) return -1;
+    memset(l, 0, sizeof(*l));
+    l->arq = arq;
+
+    char magico[4];
+    unsigned long long versao, tam_d, ncol;
+    if (fread(magico, 1, 4, arq) != 4 || memcmp(magico, MAGICO, 4) != 0) {
+        fprintf(stderr, "Arquivo não é uma gravação do resource-monitor\n");
+        return -1;
+    }
+    if (ler_varint(arq, &versao) != 0 || versao != VERSAO) {
+        fprintf(stderr, "Versão de gravação não suportada\n");
+        return -1;
+    }
+    if (ler_varint(arq, &tam_d) != 0) goto corrompido;
+    for (unsigned long long k = 0; k < tam_d; k++) {
+        int ch = fgetc(arq);
+        if (ch == EOF) goto corrompido;
+        if (k < sizeof(l->descricao) - 1) l->descricao[k] = (char)ch;
+    }
+    if (ler_varint(arq, &ncol) != 0 || ncol == 0 || ncol > COLUNAS_MAX) goto corrompido;
+
+    l->num_colunas = (size_t)ncol;
+    l->colunas = (gravacao_coluna_t *)calloc(l->num_colunas, sizeof(*l->colunas));
+    l->valores = (gravacao_valor_t *)malloc(l->num_colunas * GRAVACAO_LINHAS_BLOCO *
+                                            sizeof(*l->valores));
+    l->buf     = (unsigned char *)malloc(CAP_COLUNA);
+    l->cap_buf = CAP_COLUNA;
+    if (!l->colunas || !l->valores || !l->buf) {
+        fprintf(stderr, "leitor_abrir: sem memória\n");
+        leitor_fechar(l);
+        return -1;
+    }
+
+    for (size_t c = 0; c < l->num_colunas; c++) {
+        unsigned long long tam_n;
+        if (ler_varint(arq, &tam_n) != 0 || tam_n >= GRAVACAO_NOME_MAX ||
+            fread(l->colunas[c].nome, 1, (size_t)tam_n, arq) != tam_n) {
+            goto corrompido;
+        }
+        int tipo = fgetc(arq), codec = fgetc(arq), casas = fgetc(arq);
+        if (tipo < GRAV_TEMPO || tipo > GRAV_FLOAT || codec < GRAV_DELTA || codec > GRAV_XOR ||
+            casas == EOF) {
+            goto corrompido;
+        }
+        l->colunas[c].tipo  = (gravacao_tipo_t)tipo;
+        l->colunas[c].codec = (gravacao_codec_t)codec;
+        l->colunas[c].casas = casas;
+    }
+    return 0;
+
+corrompido:
+    fprintf(stderr, "Cabeçalho da gravação corrompido\n");
+    leitor_fechar(l);
+    return -1;
+}
+
+void leitor_fechar(leitor_gravacao_t *l) {
+    if (!l) return;
+    free(l->colunas);
+    free(l->valores);
+    free(l->buf);
+    l->colunas = NULL;
+    l->valores = NULL;
+    l->buf     = NULL;
+}
+
+static int ler_bloco(leitor_gravacao_t *l) {
+    int marca = fgetc(l->arq);
+    if (marca == EOF) return 0;
+    if (marca != MARCA_BLOCO) return -1;
+
+    unsigned long long linhas;
+    if (ler_varint(l->arq, &linhas) != 0 || linhas == 0 || linhas > GRAVACAO_LINHAS_BLOCO) {
+        return -1;
+    }
+    for (size_t c = 0; c < l->num_colunas; c++) {
+        unsigned long long tam;
+        if (ler_varint(l->arq, &tam) != 0 || tam > l->cap_buf ||
+            fread(l->buf, 1, (size_t)tam, l->arq) != tam) {
+            return -1;
+        }
+        if (decodificar(l->buf, (size_t)tam, l->colunas[c].codec,
+                        &l->valores[c * GRAVACAO_LINHAS_BLOCO], (size_t)linhas) != 0) {
+            return -1;
+        }
+    }
+    l->linhas  = (size_t)linhas;
+    l->proxima = 0;
+    return 1;
+}
+
+int leitor_proxima(leitor_gravacao_t *l, gravacao_valor_t *linha) {
+    if (!l || !l->valores || !linha) return -1;
+    if (l->proxima == l->linhas) {
+        int rc = ler_bloco(l);
+        if (rc <= 0) return rc;
+    }
+    for (size_t c = 0; c < l->num_colunas; c++) {
+        linha[c] = l->valores[c * GRAVACAO_LINHAS_BLOCO + l->proxima];
+    }
+    l->proxima++;
+    return 1;
+}
+
+/* ==================== CONVERSÃO PARA CSV ==================== */
+
+int gravacao_converter_csv(FILE *entrada, FILE *saida) {
+    leitor_gravacao_t l;
+    if (leitor_abrir(&l, entrada) != 0) return -1;
+
+    gravacao_valor_t *linha = (gravacao_valor_t *)malloc(l.num_colunas * sizeof(*linha));
+    saida_campo_t    *campos = (saida_campo_t *)malloc(l.num_colunas * sizeof(*campos));
+    saida_t out;
+    fflush(saida);
+    if (!linha || !campos) {
+        fprintf(stderr, "gravacao_converter_csv: sem memória\n");
+        free(linha);
+        free(campos);
+        leitor_fechar(&l);
+        return -1;
+    }
+
+    for (size_t c = 0; c < l.num_colunas; c++) {
+        campos[c].nome  = l.colunas[c].nome;
+        campos[c].casas = l.colunas[c].casas;
+        campos[c].tipo  = l.colunas[c].tipo == GRAV_TEMPO ? CAMPO_TEXTO :
+                          l.colunas[c].tipo == GRAV_FLOAT ? CAMPO_FIXO  : CAMPO_INT;
+    }
+    // arquivo inteiro de uma vez: só flush por tamanho
+    if (saida_abrir(&out, fileno(saida), saida_formato_padrao(), campos, l.num_colunas,
+                    0, 0) != 0) {
+        free(linha);
+        free(campos);
+        leitor_fechar(&l);
+        return -1;
+    }
+    saida_cabecalho(&out);
+
+    int rc;
+    unsigned long long linhas = 0;
+    char ts[CARIMBO_TAM];
+    while ((rc = leitor_proxima(&l, linha)) == 1) {
+        for (size_t c = 0; c < l.num_colunas; c++) {
+            switch (l.colunas[c].tipo) {
+                case GRAV_TEMPO:
+                    // mesmo formato (e precisão) das saídas CSV diretas
+                    carimbo_formatar(linha[c].i, ts, sizeof(ts));
+                    saida_texto(&out, ts);
+                    break;
+                case GRAV_FLOAT:
+                    saida_fixo(&out, linha[c].f);
+                    break;
+                case GRAV_INT:
+                default:
+                    saida_int(&out, linha[c].i);
+                    break;
+            }
+        }
+        saida_fim_linha(&out);
+        linhas++;
+    }
+    if (rc < 0) {
+        fprintf(stderr, "Gravação corrompida após %llu linhas\n", linhas);
+    }
+    if (saida_fechar(&out) != 0) rc = -1;
+
+    free(linha);
+    free(campos);
+    leitor_fechar(&l);
+    return rc < 0 ? -1 : 0;
+}
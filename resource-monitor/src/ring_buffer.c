@@ -0,0 +1,133 @@
+// ring_buffer.c - fila SPSC sem trava e thread escritora da saída CSV
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "../include/ring_buffer.h"
+
+/* ==================== FILA SPSC ==================== */
+
+int fila_iniciar(fila_spsc_t *f, size_t capacidade, size_t tam_registro) {
+    if (!f || capacidade == 0 || tam_registro == 0) return -1;
+    memset(f, 0, sizeof(*f));
+
+    size_t cap = 1;
+    while (cap < capacidade) cap <<= 1;
+
+    f->dados = (unsigned char *)malloc(cap * tam_registro);
+    if (!f->dados) {
+        fprintf(stderr, "fila_iniciar: sem memória (%zu registros de %zu bytes)\n",
+                cap, tam_registro);
+        return -1;
+    }
+    f->capacidade   = cap;
+    f->tam_registro = tam_registro;
+    return 0;
+}
+
+void fila_destruir(fila_spsc_t *f) {
+    if (!f) return;
+    free(f->dados);
+    memset(f, 0, sizeof(*f));
+}
+
+int fila_publicar(fila_spsc_t *f, const void *registro) {
+    unsigned long long cauda  = __atomic_load_n(&f->cauda, __ATOMIC_RELAXED);
+    unsigned long long cabeca = __atomic_load_n(&f->cabeca, __ATOMIC_ACQUIRE);
+    if (cauda - cabeca >= f->capacidade) {
+        __atomic_fetch_add(&f->descartados, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    size_t pos = (size_t)(cauda & (f->capacidade - 1));
+    memcpy(f->dados + pos * f->tam_registro, registro, f->tam_registro);
+    __atomic_store_n(&f->cauda, cauda + 1, __ATOMIC_RELEASE);  // publica o conteúdo
+    return 0;
+}
+
+int fila_consumir(fila_spsc_t *f, void *destino) {
+    unsigned long long cabeca = __atomic_load_n(&f->cabeca, __ATOMIC_RELAXED);
+    unsigned long long cauda  = __atomic_load_n(&f->cauda, __ATOMIC_ACQUIRE);
+    if (cabeca == cauda) return 0;
+
+    size_t pos = (size_t)(cabeca & (f->capacidade - 1));
+    memcpy(destino, f->dados + pos * f->tam_registro, f->tam_registro);
+    __atomic_store_n(&f->cabeca, cabeca + 1, __ATOMIC_RELEASE);  // libera a posição
+    return 1;
+}
+
+/* ==================== ESCRITOR ==================== */
+
+static void *laco_escritor(void *arg) {
+    escritor_t *e = (escritor_t *)arg;
+    void *reg = malloc(e->fila.tam_registro);
+    if (!reg) {
+        fprintf(stderr, "escritor: sem memória\n");
+        return NULL;
+    }
+
+    for (;;) {
+        while (sem_wait(&e->sinal) != 0 && errno == EINTR) { }
+
+        // lido ANTES de esvaziar: com 'encerrar' visto, tudo que o produtor publicou já está na fila
+        int fim = __atomic_load_n(&e->encerrar, __ATOMIC_ACQUIRE);
+
+        int escritos = 0;
+        while (fila_consumir(&e->fila, reg)) {
+            e->formatar(e->saida, reg, e->ctx);
+            escritos++;
+        }
+        if (escritos) fflush(e->saida);
+        if (fim) break;
+    }
+    free(reg);
+    return NULL;
+}
+
+int escritor_iniciar(escritor_t *e, FILE *saida, size_t tam_registro, size_t capacidade,
+                     escritor_formatar_t formatar, void *ctx) {
+    if (!e || !saida || !formatar) return -1;
+    memset(e, 0, sizeof(*e));
+    e->saida    = saida;
+    e->formatar = formatar;
+    e->ctx      = ctx;
+
+    if (fila_iniciar(&e->fila, capacidade, tam_registro) != 0) return -1;
+    if (sem_init(&e->sinal, 0, 0) != 0) {
+        perror("escritor_iniciar: sem_init");
+        fila_destruir(&e->fila);
+        return -1;
+    }
+    int rc = pthread_create(&e->thread, NULL, laco_escritor, e);
+    if (rc != 0) {
+        fprintf(stderr, "escritor_iniciar: pthread_create: %s\n", strerror(rc));
+        sem_destroy(&e->sinal);
+        fila_destruir(&e->fila);
+        return -1;
+    }
+    return 0;
+}
+
+int escritor_enviar(escritor_t *e, const void *registro) {
+    if (fila_publicar(&e->fila, registro) != 0) return -1;
+    sem_post(&e->sinal);  // futex: não bloqueia o produtor
+    return 0;
+}
+
+unsigned long escritor_encerrar(escritor_t *e) {
+    if (!e || !e->fila.dados) return 0;
+
+    __atomic_store_n(&e->encerrar, 1, __ATOMIC_RELEASE);
+    sem_post(&e->sinal);
+    pthread_join(e->thread, NULL);
+
+    unsigned long descartados = __atomic_load_n(&e->fila.descartados, __ATOMIC_RELAXED);
+    sem_destroy(&e->sinal);
+    fila_destruir(&e->fila);
+    return descartados;
+}
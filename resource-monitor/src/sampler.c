@@ -0,0 +1,344 @@
+// sampler.c - coleta unificada de CPU, memória e I/O em um único tick
+#define _POSIX_C_SOURCE 200809L  // fileno
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <errno.h>
+
+#include "../include/monitor.h"
+#include "../include/proc_cache.h"
+#include "../include/formatter.h"
+#include "../include/recording.h"
+#include "../include/sampler.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+#include "../include/alerts.h"
+
+/* ==================== COLETA ==================== */
+
+int sampler_coletar(pid_t pid, sampler_snapshot_t *out) {
+    if (!out || pid <= 0) {
+        fprintf(stderr, "sampler_coletar: parâmetros inválidos\n");
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->pid = pid;
+    carimbo_t quando;
+    carimbo_agora(&quando);
+    out->mono_ns = quando.mono_ns;
+    out->real_ns = quando.real_ns;
+
+    /* ---- arquivos do sistema ---- */
+    const char *stat_sis = proc_cache_ler_sistema(PROC_SIS_STAT, NULL);
+    if (!stat_sis || cpu_interpretar_stat_sistema(stat_sis, &out->cpu_sistema) != 0) {
+        fprintf(stderr, "sampler_coletar: falha ao ler /proc/stat\n");
+        return -1;
+    }
+
+    const char *meminfo = proc_cache_ler_sistema(PROC_SIS_MEMINFO, NULL);
+    if (!meminfo || mem_interpretar_sistema(meminfo, &out->mem_sistema) != 0) {
+        fprintf(stderr, "sampler_coletar: falha ao ler /proc/meminfo\n");
+        return -1;
+    }
+
+    /* ---- arquivos do processo: /proc/<pid>/stat é lido uma única vez ---- */
+    const char *stat = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+    if (!stat || cpu_interpretar_stat_processo(stat, &out->cpu_processo) != 0) {
+        return -1;
+    }
+
+    const char *status = proc_cache_ler_pid(pid, PROC_ARQ_STATUS, NULL);
+    if (!status) {
+        return -1;
+    }
+
+    /*
+     * O buffer de stat continua válido: o cache só o sobrescreve numa nova
+     * leitura do MESMO arquivo do MESMO PID.
+     */
+    if (mem_interpretar_processo(status, stat, &out->mem_processo) != 0) {
+        return -1;
+    }
+
+    const char *io = proc_cache_ler_pid(pid, PROC_ARQ_IO, NULL);
+    if (io && io_interpretar_processo(io, stat, &out->io_processo) == 0) {
+        out->io_disponivel = 1;
+    }
+
+    return 0;
+}
+
+/* ==================== CÁLCULO ==================== */
+
+int sampler_calcular(const sampler_snapshot_t *antes, const sampler_snapshot_t *depois,
+                     sampler_metricas_t *out) {
+    if (!antes || !depois || !out) {
+        fprintf(stderr, "sampler_calcular: parâmetros inválidos\n");
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+
+    out->cpu_sistema_percent  = cpu_calculo_percentual(&antes->cpu_sistema, &depois->cpu_sistema);
+    out->cpu_processo_percent = cpu_calculo_percentual_processo(&antes->cpu_processo,
+                                                                &depois->cpu_processo,
+                                                                &antes->cpu_sistema,
+                                                                &depois->cpu_sistema);
+    out->mem_processo_percent = mem_calcular_percentual_uso(&depois->mem_processo,
+                                                            &depois->mem_sistema);
+
+    // taxas sobre o tempo medido entre os dois snapshots, não o intervalo nominal
+    long long decorrido_ns = depois->mono_ns - antes->mono_ns;
+    if (antes->io_disponivel && depois->io_disponivel && decorrido_ns > 0) {
+        if (io_calcular_taxas_ns(&antes->io_processo, &depois->io_processo,
+                                 decorrido_ns, &out->io_taxas) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* ==================== MONITORAMENTO CONTÍNUO (CSV) ==================== */
+
+static const saida_campo_t CAMPOS_ALL[] = {
+    { "timestamp",            CAMPO_TEXTO, 0 },
+    { "amostra",              CAMPO_INT,   0 },
+    { "cpu_processo_percent", CAMPO_FIXO,  2 },
+    { "cpu_sistema_percent",  CAMPO_FIXO,  2 },
+    { "rss_kb",               CAMPO_UINT,  0 },
+    { "vsz_kb",               CAMPO_UINT,  0 },
+    { "shared_kb",            CAMPO_UINT,  0 },
+    { "swap_kb",              CAMPO_UINT,  0 },
+    { "minor_faults",         CAMPO_UINT,  0 },
+    { "major_faults",         CAMPO_UINT,  0 },
+    { "proc_mem_percent",     CAMPO_FIXO,  2 },
+    { "read_bps",             CAMPO_UINT,  0 },
+    { "write_bps",            CAMPO_UINT,  0 },
+    { "read_syscalls_ps",     CAMPO_UINT,  0 },
+    { "write_syscalls_ps",    CAMPO_UINT,  0 },
+    { "disk_ops_ps",          CAMPO_UINT,  0 },
+};
+#define NUM_CAMPOS_ALL (sizeof(CAMPOS_ALL) / sizeof(CAMPOS_ALL[0]))
+
+void sampler_observar_alertas(alertas_t *al, const sampler_snapshot_t *s, const sampler_metricas_t *m) {
+    if (!al || al->num == 0) return;
+    const mem_proc_stats_t *p = &s->mem_processo;
+    const io_stats_t       *t = &m->io_taxas;
+    const struct { const char *nome; double valor; } v[] = {
+        { "cpu_processo_percent", m->cpu_processo_percent },
+        { "cpu_sistema_percent",  m->cpu_sistema_percent },
+        { "rss_kb",               (double)p->rss_kb },
+        { "vsz_kb",               (double)p->vsz_kb },
+        { "shared_kb",            (double)p->shared_kb },
+        { "swap_kb",              (double)p->swap_kb },
+        { "minor_faults",         (double)p->minor_faults },
+        { "major_faults",         (double)p->major_faults },
+        { "proc_mem_percent",     m->mem_processo_percent },
+        { "read_bps",             (double)t->read_bytes },
+        { "write_bps",            (double)t->write_bytes },
+        { "read_syscalls_ps",     (double)t->read_syscalls },
+        { "write_syscalls_ps",    (double)t->write_syscalls },
+        { "disk_ops_ps",          (double)t->disk_operations },
+    };
+    for (size_t k = 0; k < sizeof(v) / sizeof(v[0]); k++) {
+        alertas_observar(al, s->pid, v[k].nome, s->mono_ns, v[k].valor);
+    }
+}
+
+int sampler_monitorar_pid_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
+    if (pid <= 0 || intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "sampler_monitorar_pid_csv: parâmetros inválidos\n");
+        return -1;
+    }
+
+    if (!saida) saida = stdout;
+
+    sampler_snapshot_t antes, depois;
+    sampler_metricas_t m;
+
+    if (sampler_coletar(pid, &antes) != 0) {
+        fprintf(stderr, "Processo %d não encontrado ou sem permissão\n", pid);
+        return -1;
+    }
+
+    if (!antes.io_disponivel) {
+        fprintf(stderr, "Aviso: /proc/%d/io indisponível, colunas de I/O ficarão zeradas\n", pid);
+    }
+
+    fflush(saida);
+    saida_t out;
+    if (saida_abrir(&out, fileno(saida), saida_formato_padrao(), CAMPOS_ALL, NUM_CAMPOS_ALL,
+                    0, intervalo_ms < SAIDA_FLUSH_PADRAO_MS ? -1 : 0) != 0) {
+        return -1;
+    }
+    saida_cabecalho(&out);
+
+    if (saida != stdout) {
+        fprintf(stderr, "Monitorando CPU/memória/I/O do PID %d (%d amostras, intervalo: %dms)\n",
+                pid, amostras, intervalo_ms);
+    }
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    for (int i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        if (sampler_coletar(pid, &depois) != 0) {
+            fprintf(stderr, "Processo %d terminou durante o monitoramento (amostra %d)\n",
+                    pid, i);
+            saida_fechar(&out);
+            return -1;
+        }
+
+        if (sampler_calcular(&antes, &depois, &m) != 0) {
+            fprintf(stderr, "Erro ao calcular métricas (amostra %d)\n", i);
+            saida_fechar(&out);
+            return -1;
+        }
+
+        char ts[CARIMBO_TAM];
+        carimbo_formatar(depois.real_ns, ts, sizeof(ts));
+        saida_texto(&out, ts);
+        saida_int(&out, i);
+        saida_fixo(&out, m.cpu_processo_percent);
+        saida_fixo(&out, m.cpu_sistema_percent);
+        saida_uint(&out, depois.mem_processo.rss_kb);
+        saida_uint(&out, depois.mem_processo.vsz_kb);
+        saida_uint(&out, depois.mem_processo.shared_kb);
+        saida_uint(&out, depois.mem_processo.swap_kb);
+        saida_uint(&out, depois.mem_processo.minor_faults);
+        saida_uint(&out, depois.mem_processo.major_faults);
+        saida_fixo(&out, m.mem_processo_percent);
+        saida_uint(&out, m.io_taxas.read_bytes);
+        saida_uint(&out, m.io_taxas.write_bytes);
+        saida_uint(&out, m.io_taxas.read_syscalls);
+        saida_uint(&out, m.io_taxas.write_syscalls);
+        saida_uint(&out, m.io_taxas.disk_operations);
+        saida_fim_linha(&out);
+        if (intervalo_ms >= SAIDA_FLUSH_PADRAO_MS) saida_descarregar(&out);
+        sampler_observar_alertas(alertas_padrao(), &depois, &m);
+
+        antes = depois;
+
+        if (saida != stdout && (amostras <= 10 || (i + 1) % 10 == 0)) {
+            fprintf(stderr, "Amostra %d/%d: cpu=%.2f%%, RSS=%llu KB, read=%.2f KB/s, write=%.2f KB/s\n",
+                    i + 1, amostras, m.cpu_processo_percent,
+                    depois.mem_processo.rss_kb,
+                    m.io_taxas.read_bytes  / 1024.0,
+                    m.io_taxas.write_bytes / 1024.0);
+        }
+    }
+
+    int rc = saida_fechar(&out);
+    agendador_relatar(&ag, "Monitoramento unificado");
+    if (saida != stdout) {
+        fprintf(stderr, "Monitoramento unificado concluído: %d amostras coletadas\n", amostras);
+    }
+    alertas_relatar(alertas_padrao());
+
+    return rc;
+}
+
+/* ==================== GRAVAÇÃO BINÁRIA ==================== */
+
+static const gravacao_coluna_t COLUNAS_ALL[] = {
+    { "timestamp",            GRAV_TEMPO, GRAV_DELTA2, 0 },
+    { "amostra",              GRAV_INT,   GRAV_DELTA2, 0 },
+    { "cpu_processo_percent", GRAV_FLOAT, GRAV_XOR,    2 },
+    { "cpu_sistema_percent",  GRAV_FLOAT, GRAV_XOR,    2 },
+    { "rss_kb",               GRAV_INT,   GRAV_DELTA,  0 },
+    { "vsz_kb",               GRAV_INT,   GRAV_DELTA,  0 },
+    { "shared_kb",            GRAV_INT,   GRAV_DELTA,  0 },
+    { "swap_kb",              GRAV_INT,   GRAV_DELTA,  0 },
+    { "minor_faults",         GRAV_INT,   GRAV_DELTA,  0 },
+    { "major_faults",         GRAV_INT,   GRAV_DELTA,  0 },
+    { "proc_mem_percent",     GRAV_FLOAT, GRAV_XOR,    2 },
+    { "read_bps",             GRAV_INT,   GRAV_DELTA,  0 },
+    { "write_bps",            GRAV_INT,   GRAV_DELTA,  0 },
+    { "read_syscalls_ps",     GRAV_INT,   GRAV_DELTA,  0 },
+    { "write_syscalls_ps",    GRAV_INT,   GRAV_DELTA,  0 },
+    { "disk_ops_ps",          GRAV_INT,   GRAV_DELTA,  0 },
+};
+#define NUM_COLUNAS_ALL (sizeof(COLUNAS_ALL) / sizeof(COLUNAS_ALL[0]))
+
+int sampler_gravar_pid(pid_t pid, int intervalo_ms, int amostras, FILE *arq) {
+    if (pid <= 0 || intervalo_ms < 1 || amostras <= 0 || !arq) {
+        fprintf(stderr, "sampler_gravar_pid: parâmetros inválidos\n");
+        return -1;
+    }
+
+    sampler_snapshot_t antes, depois;
+    sampler_metricas_t m;
+
+    if (sampler_coletar(pid, &antes) != 0) {
+        fprintf(stderr, "Processo %d não encontrado ou sem permissão\n", pid);
+        return -1;
+    }
+
+    char descricao[128];
+    snprintf(descricao, sizeof(descricao), "all pid=%d intervalo=%dms", pid, intervalo_ms);
+
+    gravador_t g;
+    if (gravador_abrir(&g, arq, descricao, COLUNAS_ALL, NUM_COLUNAS_ALL) != 0) {
+        return -1;
+    }
+
+    fprintf(stderr, "Gravando CPU/memória/I/O do PID %d (%d amostras, intervalo: %dms)\n",
+            pid, amostras, intervalo_ms);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    int rc = 0, coletadas = 0;
+    for (int i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        if (sampler_coletar(pid, &depois) != 0) {
+            fprintf(stderr, "Processo %d terminou durante a gravação (amostra %d)\n", pid, i);
+            break;  // o que já foi coletado continua válido no arquivo
+        }
+        if (sampler_calcular(&antes, &depois, &m) != 0) {
+            fprintf(stderr, "Erro ao calcular métricas (amostra %d)\n", i);
+            rc = -1;
+            break;
+        }
+
+        gravacao_valor_t linha[NUM_COLUNAS_ALL];
+        linha[0].i  = depois.real_ns;
+        linha[1].i  = i;
+        linha[2].f  = m.cpu_processo_percent;
+        linha[3].f  = m.cpu_sistema_percent;
+        linha[4].i  = (long long)depois.mem_processo.rss_kb;
+        linha[5].i  = (long long)depois.mem_processo.vsz_kb;
+        linha[6].i  = (long long)depois.mem_processo.shared_kb;
+        linha[7].i  = (long long)depois.mem_processo.swap_kb;
+        linha[8].i  = (long long)depois.mem_processo.minor_faults;
+        linha[9].i  = (long long)depois.mem_processo.major_faults;
+        linha[10].f = m.mem_processo_percent;
+        linha[11].i = (long long)m.io_taxas.read_bytes;
+        linha[12].i = (long long)m.io_taxas.write_bytes;
+        linha[13].i = (long long)m.io_taxas.read_syscalls;
+        linha[14].i = (long long)m.io_taxas.write_syscalls;
+        linha[15].i = (long long)m.io_taxas.disk_operations;
+
+        if (gravador_linha(&g, linha) != 0) {
+            rc = -1;
+            break;
+        }
+        coletadas++;
+        antes = depois;
+    }
+
+    agendador_relatar(&ag, "Gravação unificada");
+    if (gravador_fechar(&g) != 0) rc = -1;
+    fprintf(stderr, "Gravação concluída: %d amostras, %llu bytes (%.1f bytes/amostra)\n",
+            coletadas, g.total_bytes,
+            coletadas ? (double)g.total_bytes / coletadas : 0.0);
+    return rc;
+}
@@ -0,0 +1,85 @@
+// scheduler.c - amostragem com prazos absolutos (sem deriva)
+#define _POSIX_C_SOURCE 200809L  // clock_nanosleep/TIMER_ABSTIME
+
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+
+#include "../include/scheduler.h"
+
+#define NS_POR_SEG 1000000000LL
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static struct timespec ns_para_timespec(long long ns) {
+    struct timespec ts = {
+        .tv_sec  = (time_t)(ns / NS_POR_SEG),
+        .tv_nsec = (long)(ns % NS_POR_SEG)
+    };
+    return ts;
+}
+
+/* Dorme até o instante absoluto 'alvo_ns'; EINTR retoma com o MESMO alvo */
+static void dormir_ate(long long alvo_ns) {
+    struct timespec alvo = ns_para_timespec(alvo_ns);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &alvo, NULL) == EINTR) {
+        // prazo absoluto: não há "resto" a recalcular
+    }
+}
+
+/* ==================== API ==================== */
+
+long long agendador_agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * NS_POR_SEG + ts.tv_nsec;
+}
+
+void agendador_iniciar(agendador_t *ag, int intervalo_ms) {
+    if (!ag) return;
+    if (intervalo_ms < 1) intervalo_ms = 1;
+
+    ag->inicio_ns       = agendador_agora_ns();
+    ag->periodo_ns      = (long long)intervalo_ms * 1000000LL;
+    ag->proximo_ns      = ag->inicio_ns + ag->periodo_ns;
+    ag->ticks           = 0;
+    ag->prazos_perdidos = 0;
+}
+
+long long agendador_esperar(agendador_t *ag) {
+    if (!ag) return agendador_agora_ns();
+
+    long long agora = agendador_agora_ns();
+
+    if (agora < ag->proximo_ns) {
+        dormir_ate(ag->proximo_ns);
+        agora = agendador_agora_ns();
+    } else {
+        // atrasado: coleta imediatamente e descarta os prazos inteiros já vencidos
+        long long atraso = agora - ag->proximo_ns;
+        long long pulados = atraso / ag->periodo_ns;
+        ag->prazos_perdidos += 1 + (unsigned long)pulados;
+        ag->proximo_ns += pulados * ag->periodo_ns;
+    }
+
+    ag->ticks++;
+    ag->proximo_ns += ag->periodo_ns;
+    return agora;
+}
+
+long long agendador_restante_ns(const agendador_t *ag) {
+    if (!ag) return 0;
+    return ag->proximo_ns - agendador_agora_ns();
+}
+
+void agendador_dormir_ms(int ms) {
+    if (ms <= 0) return;
+    dormir_ate(agendador_agora_ns() + (long long)ms * 1000000LL);
+}
+
+void agendador_relatar(const agendador_t *ag, const char *rotulo) {
+    if (!ag || ag->prazos_perdidos == 0) return;
+    fprintf(stderr, "%s: %lu prazo(s) de amostragem perdido(s) em %lu ticks (intervalo %lld ms)\n",
+            rotulo ? rotulo : "Agendador", ag->prazos_perdidos, ag->ticks,
+            ag->periodo_ns / 1000000LL);
+}
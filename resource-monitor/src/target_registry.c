@@ -0,0 +1,138 @@
+// target_registry.c - identidade e término dos PIDs monitorados via pidfd
+#define _GNU_SOURCE  // syscall()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/syscall.h>
+
+#include "../include/proc_cache.h"
+#include "../include/proc_parser.h"
+#include "../include/targets.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434   // mesmo número em todas as arquiteturas
+#endif
+
+/* -------------------- Estado do módulo -------------------- */
+
+typedef struct {
+    pid_t              pid;
+    int                pidfd;       // -1 se o kernel não tem pidfd_open
+    unsigned long long starttime;
+} alvo_t;
+
+static alvo_t *alvos     = NULL;
+static size_t  num_alvos = 0;
+static size_t  cap_alvos = 0;
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+static alvo_t *buscar(pid_t pid) {
+    for (size_t i = 0; i < num_alvos; i++) {
+        if (alvos[i].pid == pid) return &alvos[i];
+    }
+    return NULL;
+}
+
+/* starttime atual do PID (campo 22), ou 0 se o processo não existe */
+static unsigned long long ler_starttime(pid_t pid) {
+    const char *stat = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+    // ESRCH: o descritor em cache era do processo que terminou (o cache já fechou a
+    // entrada); reabrir lê quem tem o PID agora, senão um PID reciclado pareceria encerrado
+    if (!stat && errno == ESRCH) stat = proc_cache_ler_pid(pid, PROC_ARQ_STAT, NULL);
+    if (!stat) return 0;
+
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(stat, PSTAT_BIT(PSTAT_STARTTIME), &c) != 0) return 0;
+    return c.campos[PSTAT_STARTTIME];
+}
+
+/* ==================== API ==================== */
+
+int alvo_registrar(pid_t pid) {
+    if (pid <= 0) return -1;
+    if (buscar(pid)) return 0;
+
+    if (num_alvos == cap_alvos) {
+        size_t nova = cap_alvos ? cap_alvos * 2 : 8;
+        alvo_t *v = (alvo_t *)realloc(alvos, nova * sizeof(*v));
+        if (!v) return -1;
+        alvos     = v;
+        cap_alvos = nova;
+    }
+
+    alvo_t a;
+    a.pid   = pid;
+    a.pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (a.pidfd < 0 && errno == ESRCH) return -1;
+
+    // lido depois do pidfd: se o processo já era outro, o pidfd aponta para ele também
+    a.starttime = ler_starttime(pid);
+    if (a.starttime == 0) {
+        if (a.pidfd >= 0) close(a.pidfd);
+        return -1;
+    }
+
+    alvos[num_alvos++] = a;
+    return 0;
+}
+
+alvo_estado_t alvo_estado(pid_t pid) {
+    alvo_t *a = buscar(pid);
+    if (!a) return ALVO_DESCONHECIDO;
+
+    if (a->pidfd >= 0) {
+        struct pollfd pfd = { .fd = a->pidfd, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLIN | POLLHUP))) {
+            // terminou; se /proc/<pid> ainda existe com outro starttime, já é outro processo
+            unsigned long long st = ler_starttime(pid);
+            proc_cache_invalidar(pid);  // os descritores não servem mais a este alvo
+            return (st != 0 && st != a->starttime) ? ALVO_RECICLADO : ALVO_ENCERRADO;
+        }
+        return ALVO_VIVO;
+    }
+
+    /* sem pidfd: kill(0) + starttime (um zumbi ainda conta como vivo aqui) */
+    if (kill(pid, 0) != 0 && errno == ESRCH) {
+        proc_cache_invalidar(pid);
+        return ALVO_ENCERRADO;
+    }
+    unsigned long long st = ler_starttime(pid);
+    if (st == a->starttime) return ALVO_VIVO;
+    proc_cache_invalidar(pid);
+    return st == 0 ? ALVO_ENCERRADO : ALVO_RECICLADO;
+}
+
+int alvo_fd(pid_t pid) {
+    alvo_t *a = buscar(pid);
+    return a ? a->pidfd : -1;
+}
+
+void alvo_relatar_fim(pid_t pid, alvo_estado_t estado, int amostra) {
+    if (estado == ALVO_RECICLADO) {
+        fprintf(stderr, "Processo %d terminou e o PID foi reutilizado por outro processo "
+                        "(amostra %d descartada)\n", pid, amostra);
+    } else {
+        fprintf(stderr, "Processo %d terminou (amostra %d): fim do monitoramento\n",
+                pid, amostra);
+    }
+}
+
+void alvo_remover(pid_t pid) {
+    alvo_t *a = buscar(pid);
+    if (!a) return;
+    if (a->pidfd >= 0) close(a->pidfd);
+    *a = alvos[--num_alvos];
+
+    if (num_alvos == 0) {
+        free(alvos);
+        alvos     = NULL;
+        cap_alvos = 0;
+    }
+}
@@ -0,0 +1,342 @@
+// taskstats_backend.c - coleta por genetlink TASKSTATS (alternativa binária ao /proc)
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
+
+#include "../include/monitor.h"
+#include "../include/taskstats_backend.h"
+#include "../include/scheduler.h"
+#include "../include/timestamp.h"
+
+/* Espaço para a resposta: cabeçalhos + atributos aninhados + struct taskstats */
+#define TS_BUF_TAM 4096
+
+/* -------------------- Estado do módulo -------------------- */
+
+static backend_t backend     = BACKEND_PROC;
+static int       ts_sock     = -1;
+static __u16     ts_familia  = 0;
+static __u32     ts_seq      = 0;
+
+/* ==================== FUNÇÕES AUXILIARES ==================== */
+
+/* Acrescenta um atributo netlink ao fim da mensagem (retorna -1 se não couber) */
+static int anexar_attr(struct nlmsghdr *n, size_t cap, __u16 tipo, const void *dados, size_t tam) {
+    size_t ocupado = NLMSG_ALIGN(n->nlmsg_len);
+    size_t total   = NLA_HDRLEN + tam;
+    if (ocupado + NLA_ALIGN(total) > cap) return -1;
+
+    struct nlattr *na = (struct nlattr *)((char *)n + ocupado);
+    na->nla_type = tipo;
+    na->nla_len  = (__u16)total;
+    memcpy((char *)na + NLA_HDRLEN, dados, tam);
+    n->nlmsg_len = (__u32)(ocupado + NLA_ALIGN(total));
+    return 0;
+}
+
+/* Envia um comando genetlink e recebe a resposta correspondente em 'resp' */
+static long transacao(__u16 tipo, __u8 cmd, __u8 versao, __u16 attr,
+                      const void *dados, size_t tam, char *resp, size_t cap) {
+    union {
+        struct nlmsghdr n;
+        char            buf[256];
+    } req;
+    memset(&req, 0, sizeof(req));
+
+    req.n.nlmsg_len   = NLMSG_LENGTH(GENL_HDRLEN);
+    req.n.nlmsg_type  = tipo;
+    req.n.nlmsg_flags = NLM_F_REQUEST;
+    req.n.nlmsg_seq   = ++ts_seq;
+    req.n.nlmsg_pid   = 0;
+
+    struct genlmsghdr *g = (struct genlmsghdr *)NLMSG_DATA(&req.n);
+    g->cmd     = cmd;
+    g->version = versao;
+
+    if (anexar_attr(&req.n, sizeof(req), attr, dados, tam) != 0) return -1;
+
+    struct sockaddr_nl destino;
+    memset(&destino, 0, sizeof(destino));
+    destino.nl_family = AF_NETLINK;
+
+    if (sendto(ts_sock, &req, req.n.nlmsg_len, 0,
+               (struct sockaddr *)&destino, sizeof(destino)) < 0) {
+        return -1;
+    }
+
+    // descarta respostas atrasadas de consultas anteriores (ex.: após timeout)
+    for (;;) {
+        ssize_t n = recv(ts_sock, resp, cap, 0);
+        if (n < 0) return -1;
+
+        struct nlmsghdr *h = (struct nlmsghdr *)resp;
+        if (!NLMSG_OK(h, (unsigned int)n)) {
+            errno = EBADMSG;
+            return -1;
+        }
+        if (h->nlmsg_seq != req.n.nlmsg_seq) continue;
+
+        if (h->nlmsg_type == NLMSG_ERROR) {
+            struct nlmsgerr *e = (struct nlmsgerr *)NLMSG_DATA(h);
+            errno = e->error ? -e->error : EIO;
+            return -1;
+        }
+        return (long)n;
+    }
+}
+
+/* Percorre os atributos de [ini, ini+tam) procurando 'tipo' */
+static struct nlattr *achar_attr(char *ini, size_t tam, __u16 tipo) {
+    size_t pos = 0;
+    while (pos + NLA_HDRLEN <= tam) {
+        struct nlattr *na = (struct nlattr *)(ini + pos);
+        if (na->nla_len < NLA_HDRLEN || pos + na->nla_len > tam) return NULL;
+        if ((na->nla_type & NLA_TYPE_MASK) == tipo) return na;
+        pos += NLA_ALIGN(na->nla_len);
+    }
+    return NULL;
+}
+
+static char *attr_dados(struct nlattr *na) { return (char *)na + NLA_HDRLEN; }
+static size_t attr_tam(const struct nlattr *na) { return (size_t)na->nla_len - NLA_HDRLEN; }
+
+/* ==================== SOCKET E FAMÍLIA ==================== */
+
+int taskstats_abrir(void) {
+    if (ts_sock >= 0) return 0;
+
+    ts_sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (ts_sock < 0) return -1;
+
+    struct sockaddr_nl local;
+    memset(&local, 0, sizeof(local));
+    local.nl_family = AF_NETLINK;
+    if (bind(ts_sock, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        taskstats_fechar();
+        return -1;
+    }
+
+    // um kernel que não responde não pode travar o loop de amostragem
+    struct timeval limite = { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(ts_sock, SOL_SOCKET, SO_RCVTIMEO, &limite, sizeof(limite));
+
+    char resp[TS_BUF_TAM];
+    long n = transacao(GENL_ID_CTRL, CTRL_CMD_GETFAMILY, 1, CTRL_ATTR_FAMILY_NAME,
+                       TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME), resp, sizeof(resp));
+    if (n < 0) {
+        taskstats_fechar();
+        return -1;
+    }
+
+    struct nlmsghdr *h = (struct nlmsghdr *)resp;
+    char  *attrs = (char *)NLMSG_DATA(h) + GENL_HDRLEN;
+    size_t tam   = h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+
+    struct nlattr *id = achar_attr(attrs, tam, CTRL_ATTR_FAMILY_ID);
+    if (!id || attr_tam(id) < sizeof(__u16)) {
+        taskstats_fechar();
+        errno = ENOENT;
+        return -1;
+    }
+    memcpy(&ts_familia, attr_dados(id), sizeof(ts_familia));
+    return 0;
+}
+
+void taskstats_fechar(void) {
+    if (ts_sock >= 0) close(ts_sock);
+    ts_sock    = -1;
+    ts_familia = 0;
+}
+
+/* ==================== CONSULTA ==================== */
+
+int taskstats_ler_pid(pid_t pid, taskstats_info_t *out) {
+    if (!out || pid <= 0) return -1;
+    if (taskstats_abrir() != 0) return -1;
+
+    char resp[TS_BUF_TAM];
+    __u32 tgid = (__u32)pid;
+    long n = transacao(ts_familia, TASKSTATS_CMD_GET, TASKSTATS_VERSION,
+                       TASKSTATS_CMD_ATTR_TGID, &tgid, sizeof(tgid), resp, sizeof(resp));
+    if (n < 0) return -1;
+
+    /* resposta: AGGR_TGID { TGID, STATS } */
+    struct nlmsghdr *h = (struct nlmsghdr *)resp;
+    char  *attrs = (char *)NLMSG_DATA(h) + GENL_HDRLEN;
+    size_t tam   = h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+
+    struct nlattr *aggr = achar_attr(attrs, tam, TASKSTATS_TYPE_AGGR_TGID);
+    if (!aggr) return -1;
+    struct nlattr *st = achar_attr(attr_dados(aggr), attr_tam(aggr), TASKSTATS_TYPE_STATS);
+    if (!st) return -1;
+
+    // kernels mais antigos mandam uma struct menor: o que faltar fica zerado
+    struct taskstats ts;
+    memset(&ts, 0, sizeof(ts));
+    size_t copiar = attr_tam(st) < sizeof(ts) ? attr_tam(st) : sizeof(ts);
+    memcpy(&ts, attr_dados(st), copiar);
+
+    memset(out, 0, sizeof(*out));
+    out->utime_us        = ts.ac_utime;
+    out->stime_us        = ts.ac_stime;
+    out->cpu_run_real_ns = ts.cpu_run_real_total;
+    out->cpu_delay_ns    = ts.cpu_delay_total;
+    out->cpu_count       = ts.cpu_count;
+    out->blkio_delay_ns  = ts.blkio_delay_total;
+    out->blkio_count     = ts.blkio_count;
+    out->swapin_delay_ns = ts.swapin_delay_total;
+    out->swapin_count    = ts.swapin_count;
+    out->read_char       = ts.read_char;
+    out->write_char      = ts.write_char;
+    out->read_syscalls   = ts.read_syscalls;
+    out->write_syscalls  = ts.write_syscalls;
+    out->read_bytes      = ts.read_bytes;
+    out->write_bytes     = ts.write_bytes;
+    out->minflt          = ts.ac_minflt;
+    out->majflt          = ts.ac_majflt;
+    out->io_disponivel   = (ts.read_char | ts.write_char | ts.read_syscalls | ts.write_syscalls) != 0;
+    return 0;
+}
+
+/* ==================== CONVERSÕES ==================== */
+
+void taskstats_para_proc_cpu(const taskstats_info_t *ts, proc_cpu_t *out) {
+    if (!ts || !out) return;
+
+    // µs → ticks, para comparar com os deltas de /proc/stat
+    long hz = sysconf(_SC_CLK_TCK);
+    if (hz <= 0) hz = 100;
+    out->utime = ts->utime_us * (unsigned long long)hz / 1000000ULL;
+    out->stime = ts->stime_us * (unsigned long long)hz / 1000000ULL;
+
+    // taskstats não traz cutime/cstime: ao contrário do /proc, filhos já recolhidos
+    // não entram (por isso um run nunca mistura as duas origens num delta)
+    out->total_time = out->utime + out->stime;
+}
+
+void taskstats_para_io(const taskstats_info_t *ts, io_stats_t *out) {
+    if (!ts || !out) return;
+    out->read_bytes      = ts->read_char;
+    out->write_bytes     = ts->write_char;
+    out->read_syscalls   = ts->read_syscalls;
+    out->write_syscalls  = ts->write_syscalls;
+    out->disk_operations = ts->majflt;
+}
+
+/* ==================== SELEÇÃO DE BACKEND ==================== */
+
+int backend_selecionar(const char *nome) {
+    if (!nome || strcmp(nome, "proc") == 0) {
+        backend = BACKEND_PROC;
+        return 0;
+    }
+    if (strcmp(nome, "taskstats") != 0 && strcmp(nome, "auto") != 0) {
+        fprintf(stderr, "Backend desconhecido: %s (use proc, taskstats ou auto)\n", nome);
+        return -1;
+    }
+
+    // testa de verdade: a família pode existir e a consulta ainda exigir CAP_NET_ADMIN
+    taskstats_info_t teste;
+    if (taskstats_ler_pid(getpid(), &teste) == 0) {
+        backend = BACKEND_TASKSTATS;
+        return 0;
+    }
+
+    if (strcmp(nome, "taskstats") == 0) {
+        fprintf(stderr, "Aviso: taskstats indisponível (%s); usando /proc\n", strerror(errno));
+    }
+    taskstats_fechar();
+    backend = BACKEND_PROC;
+    return 0;
+}
+
+backend_t backend_atual(void) {
+    return backend;
+}
+
+const char *backend_nome(backend_t b) {
+    return (b == BACKEND_TASKSTATS) ? "taskstats" : "proc";
+}
+
+int taskstats_atrasos_ativos(void) {
+    FILE *f = fopen("/proc/sys/kernel/task_delayacct", "r");
+    if (!f) return 1;  // kernels < 5.14 não têm o sysctl: delayacct ligado por padrão
+    int ativo = 1;
+    if (fscanf(f, "%d", &ativo) != 1) ativo = 1;
+    fclose(f);
+    return ativo;
+}
+
+/* ==================== MONITORAMENTO DE ATRASOS (CSV) ==================== */
+
+int taskstats_monitorar_atrasos_csv(pid_t pid, int intervalo_ms, int amostras, FILE *saida) {
+    if (pid <= 0 || intervalo_ms < 1 || amostras <= 0) {
+        fprintf(stderr, "taskstats_monitorar_atrasos_csv: parâmetros inválidos\n");
+        return -1;
+    }
+    if (!saida) saida = stdout;
+
+    taskstats_info_t antes, depois;
+    if (taskstats_ler_pid(pid, &antes) != 0) {
+        fprintf(stderr, "taskstats indisponível para o PID %d: %s\n", pid, strerror(errno));
+        return -1;
+    }
+    long long mono_antes = agendador_agora_ns();
+
+    if (!taskstats_atrasos_ativos()) {
+        fprintf(stderr, "Aviso: kernel.task_delayacct=0, colunas de atraso ficarão zeradas "
+                        "(sysctl -w kernel.task_delayacct=1)\n");
+    }
+
+    // ms de espera por segundo de relógio: 1000 = uma thread esperando o tempo todo
+    fprintf(saida, "timestamp,amostra,cpu_run_ms_s,cpu_wait_ms_s,blkio_wait_ms_s,"
+                   "swapin_wait_ms_s,cpu_wait_medio_us\n");
+    fflush(saida);
+
+    agendador_t ag;
+    agendador_iniciar(&ag, intervalo_ms);
+
+    for (int i = 0; i < amostras; i++) {
+        agendador_esperar(&ag);
+
+        if (taskstats_ler_pid(pid, &depois) != 0) {
+            fprintf(stderr, "Processo %d terminou durante o monitoramento (amostra %d)\n",
+                    pid, i);
+            return -1;
+        }
+        long long mono_depois = agendador_agora_ns();
+        double s = (double)(mono_depois - mono_antes) / 1e9;
+        if (s <= 0.0) s = 1e-9;
+
+#define TS_DELTA(campo) ((depois.campo > antes.campo) ? (double)(depois.campo - antes.campo) : 0.0)
+        double run_ms    = TS_DELTA(cpu_run_real_ns) / 1e6 / s;
+        double cpu_ms    = TS_DELTA(cpu_delay_ns)    / 1e6 / s;
+        double blkio_ms  = TS_DELTA(blkio_delay_ns)  / 1e6 / s;
+        double swapin_ms = TS_DELTA(swapin_delay_ns) / 1e6 / s;
+        double eventos   = TS_DELTA(cpu_count);
+        double medio_us  = eventos > 0.0 ? TS_DELTA(cpu_delay_ns) / 1e3 / eventos : 0.0;
+#undef TS_DELTA
+
+        char ts[CARIMBO_TAM];
+        carimbo_texto_agora(ts, sizeof(ts), NULL);
+        fprintf(saida, "%s,%d,%.2f,%.2f,%.2f,%.2f,%.1f\n",
+                ts, i, run_ms, cpu_ms, blkio_ms, swapin_ms, medio_us);
+        fflush(saida);
+
+        antes      = depois;
+        mono_antes = mono_depois;
+    }
+
+    agendador_relatar(&ag, "Monitoramento de atrasos");
+    return 0;
+}
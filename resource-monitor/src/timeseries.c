@@ -0,0 +1,264 @@
+// timeseries.c - histórico em memória com anéis bruto/10 s/1 min e agregação incremental
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/timeseries.h"
+
+#define NS_POR_SEG        1000000000LL
+#define HIST_BALDES_MIN   64
+
+static const size_t    CAP_NIVEL[HIST_NUM_NIVEIS]   = { HIST_CAP_BRUTO, HIST_CAP_10S, HIST_CAP_1MIN };
+static const long long PASSO_NIVEL[HIST_NUM_NIVEIS] = { 0, 10 * NS_POR_SEG, 60 * NS_POR_SEG };
+
+/* ==================== ANEL DE PONTOS ==================== */
+
+static void anel_empurrar(hist_anel_t *a, const hist_ponto_t *p) {
+    a->pontos[a->proximo] = *p;
+    a->proximo = (a->proximo + 1) % a->cap;
+    if (a->num < a->cap) a->num++;
+}
+
+static const hist_ponto_t *anel_ponto(const hist_anel_t *a, size_t i) {
+    // i = 0 é o mais antigo ainda no anel
+    return &a->pontos[(a->proximo + a->cap - a->num + i) % a->cap];
+}
+
+static void ponto_iniciar(hist_ponto_t *p, long long inicio_ns, double v) {
+    p->inicio_ns = inicio_ns;
+    p->min = p->max = p->soma = p->ultimo = v;
+    p->contagem = 1;
+}
+
+static void ponto_acumular(hist_ponto_t *p, double v) {
+    if (v < p->min) p->min = v;
+    if (v > p->max) p->max = v;
+    p->soma  += v;
+    p->ultimo = v;
+    p->contagem++;
+}
+
+static void anel_registrar(hist_anel_t *a, long long t, double v) {
+    if (a->passo_ns == 0) {
+        // hist_consultar faz busca binária: o anel bruto nunca pode voltar no tempo
+        if (a->num > 0) {
+            long long ultimo = anel_ponto(a, a->num - 1)->inicio_ns;
+            if (t < ultimo) t = ultimo;
+        }
+        hist_ponto_t p;
+        ponto_iniciar(&p, t, v);
+        anel_empurrar(a, &p);
+        return;
+    }
+
+    long long inicio = t - t % a->passo_ns;
+    if (a->aberto.contagem == 0) {
+        ponto_iniciar(&a->aberto, inicio, v);
+    } else if (inicio == a->aberto.inicio_ns) {
+        ponto_acumular(&a->aberto, v);
+    } else if (inicio > a->aberto.inicio_ns) {
+        anel_empurrar(a, &a->aberto);  // intervalo fechado
+        ponto_iniciar(&a->aberto, inicio, v);
+    }
+    // amostra de um intervalo já fechado: só o nível bruto a guarda
+}
+
+/* ==================== TABELA DE SÉRIES ==================== */
+
+static size_t hash_serie(pid_t pid, const char *metrica, size_t num_baldes) {
+    unsigned long long h = 1469598103934665603ULL;  // FNV-1a
+    for (const char *c = metrica; *c; c++) {
+        h ^= (unsigned char)*c;
+        h *= 1099511628211ULL;
+    }
+    h ^= (unsigned long long)(unsigned int)pid * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h & (num_baldes - 1));
+}
+
+static hist_serie_t *buscar(const historico_t *h, pid_t pid, const char *metrica) {
+    if (!h || !h->baldes || !metrica) return NULL;
+    hist_serie_t *s = h->baldes[hash_serie(pid, metrica, h->num_baldes)];
+    for (; s; s = s->prox) {
+        if (s->pid == pid && strcmp(s->metrica, metrica) == 0) return s;
+    }
+    return NULL;
+}
+
+static void liberar_serie(hist_serie_t *s) {
+    for (int n = 0; n < HIST_NUM_NIVEIS; n++) free(s->niveis[n].pontos);
+    free(s);
+}
+
+static hist_serie_t *criar_serie(historico_t *h, pid_t pid, const char *metrica) {
+    if (h->num_series >= h->max_series) {
+        h->recusadas++;
+        return NULL;
+    }
+
+    hist_serie_t *s = (hist_serie_t *)calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->pid = pid;
+    snprintf(s->metrica, sizeof(s->metrica), "%s", metrica);
+    for (int n = 0; n < HIST_NUM_NIVEIS; n++) {
+        s->niveis[n].cap      = CAP_NIVEL[n];
+        s->niveis[n].passo_ns = PASSO_NIVEL[n];
+        s->niveis[n].pontos   = (hist_ponto_t *)malloc(CAP_NIVEL[n] * sizeof(hist_ponto_t));
+        if (!s->niveis[n].pontos) {
+            liberar_serie(s);
+            return NULL;
+        }
+    }
+
+    size_t b = hash_serie(pid, s->metrica, h->num_baldes);
+    s->prox = h->baldes[b];
+    h->baldes[b] = s;
+    h->num_series++;
+    return s;
+}
+
+/* ==================== API ==================== */
+
+int hist_iniciar(historico_t *h, size_t max_series) {
+    if (!h) return -1;
+    memset(h, 0, sizeof(*h));
+    h->max_series = max_series ? max_series : HIST_SERIES_PADRAO;
+
+    // tabela fixa: ~1 série por balde no limite, sem redimensionar
+    size_t baldes = HIST_BALDES_MIN;
+    while (baldes < h->max_series) baldes <<= 1;
+    h->baldes = (hist_serie_t **)calloc(baldes, sizeof(*h->baldes));
+    if (!h->baldes) {
+        fprintf(stderr, "hist_iniciar: sem memória\n");
+        return -1;
+    }
+    h->num_baldes = baldes;
+    return 0;
+}
+
+void hist_destruir(historico_t *h) {
+    if (!h || !h->baldes) return;
+    for (size_t b = 0; b < h->num_baldes; b++) {
+        hist_serie_t *s = h->baldes[b];
+        while (s) {
+            hist_serie_t *prox = s->prox;
+            liberar_serie(s);
+            s = prox;
+        }
+    }
+    free(h->baldes);
+    memset(h, 0, sizeof(*h));
+}
+
+int hist_registrar(historico_t *h, pid_t pid, const char *metrica,
+                   long long real_ns, double valor) {
+    if (!h || !h->baldes || !metrica || !*metrica) return -1;
+
+    hist_serie_t *s = buscar(h, pid, metrica);
+    if (!s && (s = criar_serie(h, pid, metrica)) == NULL) return -1;
+
+    for (int n = 0; n < HIST_NUM_NIVEIS; n++) {
+        anel_registrar(&s->niveis[n], real_ns, valor);
+    }
+    return 0;
+}
+
+size_t hist_consultar(const historico_t *h, pid_t pid, const char *metrica,
+                      hist_nivel_t nivel, long long desde_ns,
+                      hist_ponto_t *saida, size_t max) {
+    if (nivel < 0 || nivel >= HIST_NUM_NIVEIS || !saida || max == 0) return 0;
+    const hist_serie_t *s = buscar(h, pid, metrica);
+    if (!s) return 0;
+
+    const hist_anel_t *a = &s->niveis[nivel];
+    int    com_aberto = a->aberto.contagem > 0 && a->aberto.inicio_ns >= desde_ns;
+
+    // anel em ordem de tempo: o primeiro ponto elegível é achado por busca binária
+    size_t lo = 0, hi = a->num;
+    while (lo < hi) {
+        size_t meio = (lo + hi) / 2;
+        if (anel_ponto(a, meio)->inicio_ns < desde_ns) lo = meio + 1;
+        else hi = meio;
+    }
+
+    size_t elegiveis = a->num - lo + (com_aberto ? 1 : 0);
+    if (elegiveis > max) lo += elegiveis - max;  // mantém os mais recentes
+
+    size_t n = 0;
+    for (size_t i = lo; i < a->num && n < max; i++) saida[n++] = *anel_ponto(a, i);
+    if (com_aberto && n < max) saida[n++] = a->aberto;
+    return n;
+}
+
+int hist_resumo(const historico_t *h, pid_t pid, const char *metrica,
+                hist_nivel_t nivel, long long desde_ns, hist_ponto_t *resumo) {
+    if (nivel < 0 || nivel >= HIST_NUM_NIVEIS || !resumo) return -1;
+    const hist_serie_t *s = buscar(h, pid, metrica);
+    if (!s) return -1;
+
+    const hist_anel_t *a = &s->niveis[nivel];
+    int vazio = 1;
+    for (size_t i = 0; i <= a->num; i++) {
+        const hist_ponto_t *p = (i < a->num) ? anel_ponto(a, i) : &a->aberto;
+        if (p->contagem == 0 || p->inicio_ns < desde_ns) continue;
+        if (vazio) {
+            *resumo = *p;
+            vazio = 0;
+            continue;
+        }
+        if (p->min < resumo->min) resumo->min = p->min;
+        if (p->max > resumo->max) resumo->max = p->max;
+        resumo->soma     += p->soma;
+        resumo->ultimo    = p->ultimo;
+        resumo->contagem += p->contagem;
+    }
+    return vazio ? -1 : 0;
+}
+
+void hist_remover_alvo(historico_t *h, pid_t pid) {
+    if (!h || !h->baldes) return;
+    for (size_t b = 0; b < h->num_baldes; b++) {
+        hist_serie_t **ref = &h->baldes[b];
+        while (*ref) {
+            if ((*ref)->pid == pid) {
+                hist_serie_t *morta = *ref;
+                *ref = morta->prox;
+                liberar_serie(morta);
+                h->num_series--;
+            } else {
+                ref = &(*ref)->prox;
+            }
+        }
+    }
+}
+
+double hist_media(const hist_ponto_t *p) {
+    return (p && p->contagem) ? p->soma / (double)p->contagem : 0.0;
+}
+
+/* ==================== HISTÓRICO DO PROCESSO ==================== */
+
+static historico_t padrao;
+static int         padrao_iniciado = 0;
+
+historico_t *hist_padrao(void) {
+    if (!padrao_iniciado) {
+        if (hist_iniciar(&padrao, 0) != 0) return NULL;
+        padrao_iniciado = 1;
+    }
+    return &padrao;
+}
+
+void hist_imprimir_tendencia(FILE *out, const historico_t *h, pid_t pid,
+                             const char *metrica, const char *rotulo, const char *unidade) {
+    hist_ponto_t r;
+    if (!out || hist_resumo(h, pid, metrica, HIST_BRUTO, 0, &r) != 0 || r.contagem < 2) return;
+
+    // hist_consultar com max = 1 devolveria o mais recente; a base é o mais antigo
+    const hist_ponto_t *primeiro = anel_ponto(&buscar(h, pid, metrica)->niveis[HIST_BRUTO], 0);
+    double delta = r.ultimo - primeiro->ultimo;
+    fprintf(out, "  Tendência %-9s: mín %.2f | média %.2f | máx %.2f %s (%u leituras, %s%.2f desde a 1ª)\n",
+            rotulo, r.min, hist_media(&r), r.max, unidade, r.contagem,
+            delta >= 0 ? "+" : "", delta);
+}
@@ -0,0 +1,92 @@
+// timestamp.c - carimbos de tempo (parede + monotônico) com formatação em cache
+#define _POSIX_C_SOURCE 200809L  // clock_gettime/localtime_r
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/timestamp.h"
+
+#define NS_POR_SEG 1000000000LL
+
+static carimbo_precisao_t precisao = CARIMBO_MS;
+
+/* Último segundo formatado por esta thread (escritores e amostrador têm o seu) */
+static __thread time_t cache_seg = (time_t)-1;
+static __thread char   cache_prefixo[CARIMBO_TAM];
+static __thread size_t cache_tam;
+
+/* ==================== API ==================== */
+
+void carimbo_agora(carimbo_t *c) {
+    struct timespec real, mono;
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    clock_gettime(CLOCK_REALTIME, &real);
+    c->mono_ns = (long long)mono.tv_sec * NS_POR_SEG + mono.tv_nsec;
+    c->real_ns = (long long)real.tv_sec * NS_POR_SEG + real.tv_nsec;
+}
+
+void carimbo_formatar(long long real_ns, char *buf, size_t tam) {
+    if (!buf || tam == 0) return;
+
+    long long ns_frac = real_ns % NS_POR_SEG;
+    time_t    seg     = (time_t)(real_ns / NS_POR_SEG);
+    if (ns_frac < 0) {  // antes da época: a fração continua positiva
+        ns_frac += NS_POR_SEG;
+        seg--;
+    }
+
+    if (seg != cache_seg) {
+        struct tm tm_info;
+        if (!localtime_r(&seg, &tm_info)) {
+            snprintf(buf, tam, "ERRO_TIMESTAMP");
+            return;
+        }
+        cache_tam = strftime(cache_prefixo, sizeof(cache_prefixo), "%Y-%m-%d %H:%M:%S", &tm_info);
+        cache_seg = seg;
+    }
+
+    int    digitos = precisao == CARIMBO_US ? 6 : (precisao == CARIMBO_MS ? 3 : 0);
+    size_t total   = cache_tam + (digitos ? (size_t)digitos + 1 : 0);
+    if (total + 1 > tam) {
+        snprintf(buf, tam, "%s", cache_prefixo);  // buffer curto: só até os segundos
+        return;
+    }
+
+    memcpy(buf, cache_prefixo, cache_tam);
+    if (digitos) {
+        long long frac = ns_frac / (digitos == 6 ? 1000LL : 1000000LL);
+        buf[cache_tam] = '.';
+        for (int k = digitos; k >= 1; k--) {
+            buf[cache_tam + (size_t)k] = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+    }
+    buf[total] = '\0';
+}
+
+void carimbo_texto_agora(char *buf, size_t tam, carimbo_t *c) {
+    carimbo_t local;
+    if (!c) c = &local;
+    carimbo_agora(c);
+    carimbo_formatar(c->real_ns, buf, tam);
+}
+
+int carimbo_selecionar(const char *nome) {
+    if (nome && strcmp(nome, "s") == 0) {
+        precisao = CARIMBO_SEG;
+    } else if (nome && strcmp(nome, "ms") == 0) {
+        precisao = CARIMBO_MS;
+    } else if (nome && strcmp(nome, "us") == 0) {
+        precisao = CARIMBO_US;
+    } else {
+        fprintf(stderr, "Precisão de timestamp desconhecida: %s (use s, ms ou us)\n",
+                nome ? nome : "(nulo)");
+        return -1;
+    }
+    return 0;
+}
+
+carimbo_precisao_t carimbo_precisao(void) {
+    return precisao;
+}
@@ -0,0 +1,230 @@
+// worker_pool.c - threads fixadas em cores que dividem (e roubam) shards de trabalho
+#define _GNU_SOURCE  // pthread_setaffinity_np / CPU_SET
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "../include/worker_pool.h"
+
+#define POOL_MAX_WORKERS 256
+
+/* ==================== FILAS DE SHARDS ==================== */
+
+#define FAIXA(inicio, fim)  (((unsigned long long)(inicio) << 32) | (unsigned long long)(fim))
+#define FAIXA_INICIO(v)     ((unsigned)((v) >> 32))
+#define FAIXA_FIM(v)        ((unsigned)((v) & 0xffffffffu))
+
+/* Dono: tira o primeiro shard da própria fila */
+static int pegar(pool_fila_t *f, unsigned *shard) {
+    unsigned long long v = __atomic_load_n(&f->faixa, __ATOMIC_ACQUIRE);
+    for (;;) {
+        unsigned i = FAIXA_INICIO(v), fim = FAIXA_FIM(v);
+        if (i >= fim) return 0;
+        if (__atomic_compare_exchange_n(&f->faixa, &v, FAIXA(i + 1, fim), 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *shard = i;
+            return 1;
+        }
+    }
+}
+
+/* Ladrão: leva a metade final da fila da vítima para a própria fila (que está vazia) */
+static int roubar(pool_fila_t *vitima, pool_fila_t *minha) {
+    unsigned long long v = __atomic_load_n(&vitima->faixa, __ATOMIC_ACQUIRE);
+    for (;;) {
+        unsigned i = FAIXA_INICIO(v), fim = FAIXA_FIM(v);
+        if (i >= fim) return 0;
+        unsigned corte = fim - (fim - i + 1) / 2;
+        if (__atomic_compare_exchange_n(&vitima->faixa, &v, FAIXA(i, corte), 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&minha->faixa, FAIXA(corte, fim), __ATOMIC_RELEASE);
+            return 1;
+        }
+    }
+}
+
+static void trabalhar(pool_t *p, int w) {
+    pool_fila_t *minha = &p->filas[w];
+    unsigned shard;
+
+    for (;;) {
+        while (pegar(minha, &shard)) {
+            size_t inicio = (size_t)shard * p->tam_shard;
+            size_t fim    = inicio + p->tam_shard;
+            if (fim > p->num_itens) fim = p->num_itens;
+            p->tarefa(p->ctx, inicio, fim, w);
+        }
+
+        /* fila vazia: procura trabalho nos outros, a partir do vizinho */
+        int roubou = 0;
+        for (int k = 1; k < p->num_workers && !roubou; k++) {
+            roubou = roubar(&p->filas[(w + k) % p->num_workers], minha);
+        }
+        if (!roubou) return;  // nenhum shard sobrando em lugar nenhum
+        __atomic_fetch_add(&p->roubos, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* ==================== THREADS ==================== */
+
+typedef struct {
+    pool_t *pool;
+    int     indice;
+} pool_arg_t;
+
+static void *laco_worker(void *arg) {
+    pool_arg_t a = *(pool_arg_t *)arg;
+    pool_t    *p = a.pool;
+    free(arg);
+
+    unsigned long vista = 0;
+    for (;;) {
+        pthread_mutex_lock(&p->trava);
+        while (p->geracao == vista && !p->encerrar) pthread_cond_wait(&p->largada, &p->trava);
+        vista = p->geracao;
+        int sair = p->encerrar;
+        pthread_mutex_unlock(&p->trava);
+        if (sair) break;
+
+        trabalhar(p, a.indice);
+
+        pthread_mutex_lock(&p->trava);
+        if (--p->pendentes == 0) pthread_cond_signal(&p->chegada);
+        pthread_mutex_unlock(&p->trava);
+    }
+    return NULL;
+}
+
+int pool_cpus_disponiveis(void) {
+    cpu_set_t cpus;
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) != 0) return 1;
+    int n = CPU_COUNT(&cpus);
+    return n > 0 ? n : 1;
+}
+
+/* i-ésima CPU da máscara de afinidade (circular) */
+static int cpu_da_mascara(const cpu_set_t *cpus, int i) {
+    int total = CPU_COUNT(cpus);
+    if (total <= 0) return -1;
+    i %= total;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, cpus) && i-- == 0) return c;
+    }
+    return -1;
+}
+
+/* ==================== API ==================== */
+
+int pool_iniciar(pool_t *p, int num_workers) {
+    if (!p) return -1;
+    memset(p, 0, sizeof(*p));
+
+    if (num_workers <= 0) num_workers = pool_cpus_disponiveis();
+    if (num_workers > POOL_MAX_WORKERS) num_workers = POOL_MAX_WORKERS;
+    p->num_workers = num_workers;
+
+    p->filas = (pool_fila_t *)calloc((size_t)num_workers, sizeof(pool_fila_t));
+    if (!p->filas) {
+        fprintf(stderr, "pool_iniciar: sem memória\n");
+        return -1;
+    }
+    if (num_workers == 1) return 0;
+
+    p->threads = (pthread_t *)calloc((size_t)num_workers - 1, sizeof(pthread_t));
+    if (!p->threads) {
+        fprintf(stderr, "pool_iniciar: sem memória\n");
+        free(p->filas);
+        p->filas = NULL;
+        return -1;
+    }
+    pthread_mutex_init(&p->trava, NULL);
+    pthread_cond_init(&p->largada, NULL);
+    pthread_cond_init(&p->chegada, NULL);
+
+    cpu_set_t cpus;
+    int tem_mascara = sched_getaffinity(0, sizeof(cpus), &cpus) == 0;
+
+    for (int w = 1; w < num_workers; w++) {
+        pool_arg_t *arg = (pool_arg_t *)malloc(sizeof(*arg));
+        if (arg) {
+            arg->pool   = p;
+            arg->indice = w;
+        }
+        if (!arg || pthread_create(&p->threads[w - 1], NULL, laco_worker, arg) != 0) {
+            // segue com os workers já criados
+            free(arg);
+            fprintf(stderr, "pool_iniciar: só %d de %d workers criados\n", w, num_workers);
+            p->num_workers = w;
+            break;
+        }
+
+        if (tem_mascara) {
+            int cpu = cpu_da_mascara(&cpus, w);
+            if (cpu >= 0) {
+                cpu_set_t uma;
+                CPU_ZERO(&uma);
+                CPU_SET(cpu, &uma);
+                pthread_setaffinity_np(p->threads[w - 1], sizeof(uma), &uma);
+            }
+        }
+    }
+    return 0;
+}
+
+void pool_destruir(pool_t *p) {
+    if (!p || !p->filas) return;
+    if (p->threads) {
+        pthread_mutex_lock(&p->trava);
+        p->encerrar = 1;
+        pthread_cond_broadcast(&p->largada);
+        pthread_mutex_unlock(&p->trava);
+        for (int w = 1; w < p->num_workers; w++) pthread_join(p->threads[w - 1], NULL);
+        pthread_cond_destroy(&p->largada);
+        pthread_cond_destroy(&p->chegada);
+        pthread_mutex_destroy(&p->trava);
+    }
+    free(p->threads);
+    free(p->filas);
+    memset(p, 0, sizeof(*p));
+}
+
+void pool_executar(pool_t *p, size_t num_itens, size_t tam_shard,
+                   pool_tarefa_t tarefa, void *ctx) {
+    if (!p || !tarefa || num_itens == 0) return;
+    if (tam_shard == 0) tam_shard = 1;
+
+    if (p->num_workers <= 1) {
+        tarefa(ctx, 0, num_itens, 0);
+        return;
+    }
+
+    p->tarefa    = tarefa;
+    p->ctx       = ctx;
+    p->num_itens = num_itens;
+    p->tam_shard = tam_shard;
+
+    /* faixas contíguas de shards, o resto espalhado pelos primeiros workers */
+    size_t shards = (num_itens + tam_shard - 1) / tam_shard;
+    size_t base = shards / (size_t)p->num_workers, resto = shards % (size_t)p->num_workers;
+    size_t s = 0;
+    for (int w = 0; w < p->num_workers; w++) {
+        size_t n = base + ((size_t)w < resto ? 1 : 0);
+        __atomic_store_n(&p->filas[w].faixa, FAIXA(s, s + n), __ATOMIC_RELAXED);
+        s += n;
+    }
+
+    pthread_mutex_lock(&p->trava);  // a trava publica tarefa/ctx/filas para as threads
+    p->pendentes = p->num_workers - 1;
+    p->geracao++;
+    pthread_cond_broadcast(&p->largada);
+    pthread_mutex_unlock(&p->trava);
+
+    trabalhar(p, 0);
+
+    pthread_mutex_lock(&p->trava);
+    while (p->pendentes > 0) pthread_cond_wait(&p->chegada, &p->trava);
+    pthread_mutex_unlock(&p->trava);
+}
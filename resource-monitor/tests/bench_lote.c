@@ -0,0 +1,149 @@
+// tests/bench_lote.c - ticks/s lendo stat+status+io de N PIDs: open/read/close vs pread vs io_uring
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../include/proc_batch.h"
+
+#define FILHOS_MAX    1000      // processos reais; N > FILHOS_MAX repete PIDs
+#define LEITURAS_TICK 300000    // ~leituras por medição (define quantos ticks)
+
+static const int TAMANHOS_PADRAO[] = { 1000, 10000, 50000 };
+
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ==================== CAMINHO ANTIGO (open/read/close por arquivo) ==================== */
+
+static void tick_avulso(int dfd, const pid_t *pids, size_t n) {
+    static const char *const nomes[] = { "stat", "status", "io" };
+    char caminho[48];
+    char buf[4096];
+    for (size_t i = 0; i < n; i++) {
+        for (int a = 0; a < 3; a++) {
+            snprintf(caminho, sizeof(caminho), "%d/%s", pids[i], nomes[a]);
+            proc_ler_arquivo(dfd, caminho, buf, sizeof(buf));
+        }
+    }
+}
+
+static double medir_avulso(int dfd, const pid_t *pids, size_t n, int ticks) {
+    tick_avulso(dfd, pids, n);
+    long long t0 = agora_ns();
+    for (int t = 0; t < ticks; t++) tick_avulso(dfd, pids, n);
+    return ticks / ((agora_ns() - t0) / 1e9);
+}
+
+/* ==================== LOTE (pread / uring) ==================== */
+
+static double medir_lote(int dfd, const pid_t *pids, size_t n, int ticks, lote_modo_t modo,
+                         lote_modo_t *efetivo, long *persistentes) {
+    proc_lote_t l;
+    unsigned mascara = LOTE_BIT(PROC_ARQ_STAT) | LOTE_BIT(PROC_ARQ_STATUS) | LOTE_BIT(PROC_ARQ_IO);
+    if (proc_lote_iniciar(&l, dfd, mascara, modo) != 0 || proc_lote_definir(&l, pids, n) != 0) {
+        return -1.0;
+    }
+
+    proc_lote_ler(&l);  // abre os descritores persistentes fora da medição
+    long long t0 = agora_ns();
+    for (int t = 0; t < ticks; t++) proc_lote_ler(&l);
+    double tps = ticks / ((agora_ns() - t0) / 1e9);
+
+    *efetivo      = l.modo;
+    *persistentes = l.fds_abertos;
+    proc_lote_destruir(&l);
+    return tps;
+}
+
+int main(int argc, char *argv[]) {
+    int    tamanhos[8];
+    size_t num_tamanhos = 0;
+    for (int i = 1; i < argc && num_tamanhos < 8; i++) {
+        int v = atoi(argv[i]);
+        if (v > 0) tamanhos[num_tamanhos++] = v;
+    }
+    if (num_tamanhos == 0) {
+        for (size_t i = 0; i < sizeof(TAMANHOS_PADRAO) / sizeof(TAMANHOS_PADRAO[0]); i++) {
+            tamanhos[num_tamanhos++] = TAMANHOS_PADRAO[i];
+        }
+    }
+
+    /* root pode passar do limite rígido de descritores (3 por PID no lote) */
+    struct rlimit rl = { 1 << 20, 1 << 20 };
+    if (setrlimit(RLIMIT_NOFILE, &rl) != 0) {
+        getrlimit(RLIMIT_NOFILE, &rl);
+        printf("RLIMIT_NOFILE = %llu: PIDs além do limite usam open/read/close\n",
+               (unsigned long long)rl.rlim_cur);
+    }
+
+    int maior = 0;
+    for (size_t i = 0; i < num_tamanhos; i++) if (tamanhos[i] > maior) maior = tamanhos[i];
+
+    /* filhos parados em pause(): alvos reais com stat/status/io legíveis */
+    int num_filhos = maior < FILHOS_MAX ? maior : FILHOS_MAX;
+    pid_t *filhos = (pid_t *)calloc((size_t)num_filhos, sizeof(pid_t));
+    pid_t *pids   = (pid_t *)calloc((size_t)maior, sizeof(pid_t));
+    if (!filhos || !pids) {
+        perror("calloc");
+        return 1;
+    }
+    int criados = 0;
+    for (; criados < num_filhos; criados++) {
+        pid_t p = fork();
+        if (p < 0) break;
+        if (p == 0) {
+            pause();
+            _exit(0);
+        }
+        filhos[criados] = p;
+    }
+    if (criados == 0) {
+        perror("fork");
+        return 1;
+    }
+
+    int dfd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0) {
+        perror("/proc");
+        return 1;
+    }
+
+    printf("Leitura de stat+status+io por tick (%d processos reais)\n", criados);
+    printf("%8s  %14s  %14s  %14s  %s\n", "PIDs", "open/read/close", "pread", "uring", "modo");
+
+    for (size_t k = 0; k < num_tamanhos; k++) {
+        size_t n = (size_t)tamanhos[k];
+        for (size_t i = 0; i < n; i++) pids[i] = filhos[i % (size_t)criados];
+
+        int ticks = (int)(LEITURAS_TICK / (3 * n));
+        if (ticks < 3) ticks = 3;
+
+        lote_modo_t efetivo;
+        long persist_pread, persist_uring;
+        double t_avulso = medir_avulso(dfd, pids, n, ticks);
+        double t_pread  = medir_lote(dfd, pids, n, ticks, LOTE_PREAD, &efetivo, &persist_pread);
+        double t_uring  = medir_lote(dfd, pids, n, ticks, LOTE_URING, &efetivo, &persist_uring);
+
+        printf("%8zu  %12.1f/s  %12.1f/s  %12.1f/s  %s (%ld fds)\n", n, t_avulso, t_pread,
+               t_uring, proc_lote_modo_nome(efetivo), persist_uring);
+    }
+
+    for (int i = 0; i < criados; i++) kill(filhos[i], SIGKILL);
+    while (wait(NULL) > 0) { }
+    close(dfd);
+    free(filhos);
+    free(pids);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// tests/bench_parser.c - tokenizador de /proc/<pid>/stat vs caminho antigo com sscanf
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/proc_parser.h"
+
+#define ITERACOES 1000000
+
+/* Linha com comm "maliciosa" (espaços e ')'), como o kernel pode gerar */
+static const char *LINHA_COMM_DIFICIL =
+    "4242 (a) b (c)) S 1 4242 4242 0 -1 4194560 1500 20 3 0 "
+    "120 45 7 2 20 0 4 0 98765 123456789 2048 18446744073709551615 "
+    "1 1 0 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0\n";
+
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ==================== CAMINHO ANTIGO (sscanf) ==================== */
+
+static int via_sscanf(const char *linha, unsigned long long *u, unsigned long long *s) {
+    const char *p = strrchr(linha, ')');
+    if (!p) return -1;
+    unsigned long long cu, cs;
+    int n = sscanf(p + 1,
+                   " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %llu %llu",
+                   u, s, &cu, &cs);
+    return (n == 4) ? 0 : -1;
+}
+
+/* ==================== TOKENIZADOR ==================== */
+
+static int via_tokenizador(const char *linha, unsigned long long *u, unsigned long long *s) {
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(linha, PSTAT_BIT(PSTAT_UTIME) | PSTAT_BIT(PSTAT_STIME) |
+                                     PSTAT_BIT(PSTAT_CUTIME) | PSTAT_BIT(PSTAT_CSTIME), &c) != 0) {
+        return -1;
+    }
+    *u = c.campos[PSTAT_UTIME];
+    *s = c.campos[PSTAT_STIME];
+    return 0;
+}
+
+static double medir(int (*fn)(const char *, unsigned long long *, unsigned long long *),
+                    const char *linha) {
+    volatile unsigned long long soma = 0;
+    unsigned long long u = 0, s = 0;
+
+    long long t0 = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        if (fn(linha, &u, &s) == 0) soma += u + s;
+    }
+    long long t1 = agora_ns();
+
+    (void)soma;
+    return (double)(t1 - t0) / ITERACOES;
+}
+
+int main(void) {
+    char linha[1024];
+    FILE *f = fopen("/proc/self/stat", "r");
+    if (!f || !fgets(linha, sizeof(linha), f)) {
+        perror("/proc/self/stat");
+        if (f) fclose(f);
+        return 1;
+    }
+    fclose(f);
+
+    /* Os dois caminhos devem concordar antes de comparar velocidade */
+    unsigned long long u1, s1, u2, s2;
+    if (via_sscanf(LINHA_COMM_DIFICIL, &u1, &s1) != 0 ||
+        via_tokenizador(LINHA_COMM_DIFICIL, &u2, &s2) != 0 ||
+        u1 != u2 || s1 != s2 || u2 != 120 || s2 != 45) {
+        fprintf(stderr, "Divergência entre sscanf e tokenizador\n");
+        return 1;
+    }
+
+    proc_stat_campos_t c;
+    if (proc_stat_interpretar(LINHA_COMM_DIFICIL, PSTAT_BIT(PSTAT_PPID), &c) != 0 ||
+        strcmp(c.comm, "a) b (c)") != 0 || c.estado != 'S' || c.campos[PSTAT_PPID] != 1) {
+        fprintf(stderr, "Tokenizador interpretou comm/estado/ppid incorretamente\n");
+        return 1;
+    }
+
+    printf("Microbenchmark /proc/<pid>/stat (%d iterações)\n", ITERACOES);
+    printf("  %-22s %8s %8s\n", "linha", "sscanf", "tokeniz.");
+    printf("  %-22s %6.1fns %6.1fns\n", "/proc/self/stat",
+           medir(via_sscanf, linha), medir(via_tokenizador, linha));
+    printf("  %-22s %6.1fns %6.1fns\n", "comm com ')' e espaços",
+           medir(via_sscanf, LINHA_COMM_DIFICIL), medir(via_tokenizador, LINHA_COMM_DIFICIL));
+
+    return 0;
+}
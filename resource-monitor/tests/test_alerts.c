@@ -0,0 +1,127 @@
+// tests/test_alerts.c - interpretação das regras, histerese, cooldown e taxa de variação
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/alerts.h"
+
+#define SEG 1000000000LL
+
+/* ==================== TESTE 1: SINTAXE ==================== */
+
+static int teste_sintaxe(void) {
+    printf("\n=== TESTE 1: Interpretação das regras ===\n");
+
+    alerta_regra_t r;
+    int erro = 0;
+
+    if (alerta_interpretar("cpu_processo_percent > 90 for 5s clear 80 cooldown 1min", &r) != 0 ||
+        r.op != ALERTA_MAIOR || r.limiar != 90.0 || r.limiar_normal != 80.0 ||
+        r.durante_ns != 5 * SEG || r.espera_ns != 60 * SEG || r.acao != ALERTA_ACAO_LOG) {
+        fprintf(stderr, "Regra de limiar interpretada incorretamente\n");
+        erro = 1;
+    }
+
+    // 10 MB/min em uma métrica em kB: 10240 kB / 60 s
+    if (alerta_interpretar("rss_kb rising > 10MB/min over 30s do exec:logger -t rm \"$1\"", &r) != 0 ||
+        r.tipo != ALERTA_SUBINDO || fabs(r.limiar - 10240.0 / 60.0) > 1e-9 ||
+        r.janela_ns != 30 * SEG || r.acao != ALERTA_ACAO_EXEC ||
+        strcmp(r.destino, "logger -t rm \"$1\"") != 0) {
+        fprintf(stderr, "Regra de taxa interpretada incorretamente\n");
+        erro = 1;
+    }
+
+    static const char *invalidas[] = {
+        "cpu > 90",                                 // métrica desconhecida
+        "rss_kb > 10MB/min",                        // unidade de tempo sem rising
+        "cpu_processo_percent > 90 clear 95",       // histerese do lado errado
+        "cpu_processo_percent = 90",
+        "cpu_processo_percent > 90 for",
+        "cpu_processo_percent > 90 do mail",
+    };
+    printf("(as mensagens de regra inválida abaixo são esperadas)\n");
+    for (size_t k = 0; k < sizeof(invalidas) / sizeof(invalidas[0]); k++) {
+        if (alerta_interpretar(invalidas[k], &r) == 0) {
+            fprintf(stderr, "Regra inválida aceita: %s\n", invalidas[k]);
+            erro = 1;
+        }
+    }
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 2: ESTADOS ==================== */
+
+static int teste_estados(void) {
+    printf("\n=== TESTE 2: for, histerese, cooldown e taxa ===\n");
+
+    alertas_t al;
+    memset(&al, 0, sizeof(al));
+    if (alertas_adicionar(&al, "cpu_processo_percent > 90 for 3s clear 80 cooldown 20s") != 0 ||
+        alertas_adicionar(&al, "rss_kb rising > 1MB/s over 2s") != 0) {
+        return -1;
+    }
+
+    // CPU a 1 Hz: pico curto (não dispara), alto por 4 s, oscila entre 80 e 90, cai, volta alto
+    static const double cpu[] = { 95, 50, 95, 95, 95, 95, 85, 91, 85, 70, 95, 95, 95, 95 };
+    int disparos[sizeof(cpu) / sizeof(cpu[0])];
+    alerta_estado_t estado[sizeof(cpu) / sizeof(cpu[0])];
+    for (size_t k = 0; k < sizeof(cpu) / sizeof(cpu[0]); k++) {
+        disparos[k] = alertas_observar(&al, 1, "cpu_processo_percent", (long long)(k + 1) * SEG, cpu[k]);
+        estado[k]   = al.regras[0].estado;
+    }
+
+    int erro = 0;
+    const alerta_regra_t *r = &al.regras[0];
+    // dispara na amostra 5 (95 desde a 2); 85/91/85 ficam acima do clear; 70 normaliza;
+    // volta a disparar na 13, mas dentro do cooldown de 20 s
+    if (disparos[1] || !disparos[5] || estado[8] != ALERTA_DISPARADO || estado[9] != ALERTA_OK ||
+        !disparos[13] || r->disparos != 2 || r->suprimidos != 1) {
+        fprintf(stderr, "CPU: disparos=%lu suprimidos=%lu\n", r->disparos, r->suprimidos);
+        erro = 1;
+    }
+
+    // RSS subindo 512 kB/s e depois 2 MB/s (taxa medida a cada 2 s)
+    double rss = 100000.0;
+    int disparou_em = -1;
+    for (int s = 0; s <= 10; s++) {
+        rss += s < 5 ? 512.0 : 2048.0;
+        if (alertas_observar(&al, 1, "rss_kb", (long long)s * SEG, rss) && disparou_em < 0) {
+            disparou_em = s;
+        }
+    }
+    if (disparou_em != 6 || al.regras[1].estado != ALERTA_DISPARADO) {
+        fprintf(stderr, "Taxa de RSS disparou em %d (esperado 6)\n", disparou_em);
+        erro = 1;
+    }
+
+    printf("CPU: %lu disparos (%lu suprimidos); RSS disparou no segundo %d\n",
+           r->disparos, r->suprimidos, disparou_em);
+    alertas_destruir(&al);
+    return erro ? -1 : 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DE ALERTAS - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_sintaxe() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (Sintaxe)\n");
+        erro = 1;
+    }
+    if (teste_estados() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (Estados)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes de alertas foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes de alertas falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
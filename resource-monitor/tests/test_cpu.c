@@ -196,6 +196,67 @@ static int teste_processo_inexistente(void)
     return 0;
 }
 
+/* ==================== TESTE 4: LATÊNCIA DE ESCALONAMENTO ==================== */
+
+static int teste_escalonamento(void)
+{
+    printf("=== TESTE 4: schedstat e trocas de contexto ===\n");
+
+    proc_sched_t p;
+    memset(&p, 0, sizeof(p));
+    if (cpu_interpretar_schedstat("123456789 4200000 57\n", &p) != 0 ||
+        p.run_ns != 123456789ULL || p.espera_ns != 4200000ULL || p.fatias != 57ULL) {
+        printf("ERRO: schedstat interpretado incorretamente\n");
+        return -1;
+    }
+    const char *status = "Name:\tx\nThreads:\t1\nvoluntary_ctxt_switches:\t150\n"
+                         "nonvoluntary_ctxt_switches:\t7\n";
+    if (cpu_interpretar_trocas_contexto(status, &p) != 0 ||
+        p.trocas_voluntarias != 150ULL || p.trocas_involuntarias != 7ULL) {
+        printf("ERRO: trocas de contexto interpretadas incorretamente\n");
+        return -1;
+    }
+
+    // filho dorme 30 vezes: cada sleep é uma troca voluntária
+    int canal[2];
+    if (pipe(canal) != 0) return -1;
+    pid_t filho = fork();
+    if (filho < 0) return -1;
+    if (filho == 0) {
+        char c;
+        close(canal[1]);
+        if (read(canal[0], &c, 1) != 1) _exit(1);
+        struct timespec ts = { 0, 2000000 };
+        for (int k = 0; k < 30; k++) nanosleep(&ts, NULL);
+        pause();
+        _exit(0);
+    }
+    close(canal[0]);
+
+    cpu_sched_t s;
+    proc_sched_t d;
+    int rc = -1;
+    if (cpu_sched_iniciar(&s, filho) == 0) {
+        if (write(canal[1], "x", 1) == 1) {
+            struct timespec espera = { 0, 300000000 };
+            nanosleep(&espera, NULL);
+            if (cpu_sched_delta(&s, &d) == 0) {
+                printf("Delta: trocas voluntárias=%llu, involuntárias=%llu, espera=%llu ns, threads=%d\n",
+                       d.trocas_voluntarias, d.trocas_involuntarias, d.espera_ns, d.threads);
+                rc = (d.trocas_voluntarias >= 30 && d.threads == 1) ? 0 : -1;
+                if (rc != 0) printf("ERRO: esperadas ao menos 30 trocas voluntárias em 1 thread\n");
+            }
+        }
+        cpu_sched_liberar(&s);
+    }
+    close(canal[1]);
+    kill(filho, SIGKILL);
+    waitpid(filho, NULL, 0);
+
+    if (rc == 0) printf("Teste 4 concluído.\n\n");
+    return rc;
+}
+
 /* ==================== FUNÇÃO PRINCIPAL ==================== */
 
 int main(int argc, char *argv[])
@@ -227,6 +288,11 @@ int main(int argc, char *argv[])
         erro = 1;
     }
 
+    if (teste_escalonamento() != 0) {
+        fprintf(stderr, "ERRO no Teste 4\n");
+        erro = 1;
+    }
+
     if (!erro) {
         printf("✅ Todos os testes de CPU foram executados com sucesso!\n");
         printf("📊 Confira o arquivo 'cpu_test_child.csv' para analisar as métricas.\n");
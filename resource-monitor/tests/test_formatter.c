@@ -0,0 +1,167 @@
+// tests/test_formatter.c - conversores próprios da camada de saída contra o printf
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/formatter.h"
+
+static const saida_campo_t CAMPOS[] = {
+    { "texto",   CAMPO_TEXTO, 0 },
+    { "inteiro", CAMPO_INT,   0 },
+    { "natural", CAMPO_UINT,  0 },
+    { "pct",     CAMPO_FIXO,  2 },
+    { "taxa",    CAMPO_FIXO,  0 },
+};
+#define NUM_CAMPOS 5
+
+/* Formata uma linha com saida_* e devolve o texto gerado em 'dest' */
+static int formatar_linha(saida_formato_t formato, const char *texto, long long i,
+                          unsigned long long u, double pct, double taxa,
+                          char *dest, size_t tam) {
+    FILE *tmp = tmpfile();
+    if (!tmp) return -1;
+
+    saida_t s;
+    if (saida_abrir(&s, fileno(tmp), formato, CAMPOS, NUM_CAMPOS, 0, 0) != 0) {
+        fclose(tmp);
+        return -1;
+    }
+    saida_texto(&s, texto);
+    saida_int(&s, i);
+    saida_uint(&s, u);
+    saida_fixo(&s, pct);
+    saida_fixo(&s, taxa);
+    saida_fim_linha(&s);
+    int rc = saida_fechar(&s);
+
+    rewind(tmp);
+    size_t n = fread(dest, 1, tam - 1, tmp);
+    dest[n] = '\0';
+    fclose(tmp);
+    return rc;
+}
+
+/* ==================== TESTE 1: CSV IGUAL AO PRINTF ==================== */
+
+static int teste_csv_printf(void) {
+    printf("\n=== TESTE 1: CSV igual ao printf ===\n");
+
+    static const long long inteiros[] = { 0, 1, -1, 42, -9223372036854775807LL - 1,
+                                          9223372036854775807LL };
+    static const double reais[] = { 0.0, 0.004, 0.005, 0.125, 5.5, 16.5, 99.999,
+                                    -0.25, -3.14159, 1e6 + 0.5, 123456789.987,
+                                    -0.0, -0.001, -0.1 };
+    char obtido[512], esperado[512];
+    int falhas = 0, casos = 0;
+
+    for (size_t a = 0; a < sizeof(inteiros) / sizeof(inteiros[0]); a++) {
+        for (size_t b = 0; b < sizeof(reais) / sizeof(reais[0]); b++) {
+            unsigned long long u = (unsigned long long)inteiros[a] * 7u;
+            double pct = reais[b], taxa = reais[b] * 3.0;
+            if (formatar_linha(SAIDA_CSV, "bash", inteiros[a], u, pct, taxa,
+                               obtido, sizeof(obtido)) != 0) {
+                return -1;
+            }
+            snprintf(esperado, sizeof(esperado), "bash,%lld,%llu,%.2f,%.0f\n",
+                     inteiros[a], u, pct, taxa);
+            casos++;
+            if (strcmp(obtido, esperado) != 0) {
+                fprintf(stderr, "Diverge: obtido '%s' esperado '%s'\n", obtido, esperado);
+                falhas++;
+            }
+        }
+    }
+    printf("%d casos, %d divergências\n", casos, falhas);
+    return falhas ? -1 : 0;
+}
+
+/* ==================== TESTE 2: ESCAPES ==================== */
+
+static int teste_escapes(void) {
+    printf("\n=== TESTE 2: Escapes de texto (CSV e JSON Lines) ===\n");
+
+    char obtido[512];
+    int erro = 0;
+
+    if (formatar_linha(SAIDA_CSV, "a,b\"c", 1, 2, 0.5, 1.0, obtido, sizeof(obtido)) != 0 ||
+        strcmp(obtido, "a_b_c,1,2,0.50,1\n") != 0) {
+        fprintf(stderr, "CSV: '%s'\n", obtido);
+        erro = 1;
+    }
+    if (formatar_linha(SAIDA_JSONL, "x\"y\\z\n", -3, 4, 1.0 / 0.0, 2.5, obtido,
+                       sizeof(obtido)) != 0 ||
+        strcmp(obtido, "{\"texto\":\"x\\\"y\\\\z\\u000a\",\"inteiro\":-3,\"natural\":4,"
+                       "\"pct\":null,\"taxa\":2}\n") != 0) {
+        fprintf(stderr, "JSON: '%s'\n", obtido);
+        erro = 1;
+    }
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 3: CAMPO AUSENTE ==================== */
+
+static int teste_nulo(void) {
+    printf("\n=== TESTE 3: Campo ausente (vazio no CSV, null no JSON) ===\n");
+
+    static const saida_campo_t dois[] = { { "a", CAMPO_UINT, 0 }, { "b", CAMPO_FIXO, 1 } };
+    static const char *const esperado[] = { "1,\n,2.5\n", "{\"a\":1,\"b\":null}\n{\"a\":null,\"b\":2.5}\n" };
+    int erro = 0;
+
+    for (int f = 0; f < 2; f++) {
+        FILE *tmp = tmpfile();
+        if (!tmp) return -1;
+        saida_t s;
+        if (saida_abrir(&s, fileno(tmp), f ? SAIDA_JSONL : SAIDA_CSV, dois, 2, 0, 0) != 0) {
+            fclose(tmp);
+            return -1;
+        }
+        saida_uint(&s, 1);
+        saida_nulo(&s);
+        saida_fim_linha(&s);
+        saida_nulo(&s);
+        saida_fixo(&s, 2.5);
+        saida_fim_linha(&s);
+        saida_fechar(&s);
+
+        char obtido[128];
+        rewind(tmp);
+        size_t n = fread(obtido, 1, sizeof(obtido) - 1, tmp);
+        obtido[n] = '\0';
+        fclose(tmp);
+        if (strcmp(obtido, esperado[f]) != 0) {
+            fprintf(stderr, "%s: '%s'\n", f ? "JSON" : "CSV", obtido);
+            erro = 1;
+        }
+    }
+    return erro ? -1 : 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DA CAMADA DE SAÍDA - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_csv_printf() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (CSV igual ao printf)\n");
+        erro = 1;
+    }
+    if (teste_escapes() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (Escapes)\n");
+        erro = 1;
+    }
+    if (teste_nulo() != 0) {
+        fprintf(stderr, "ERRO no Teste 3 (Campo ausente)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes da camada de saída foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes da camada de saída falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
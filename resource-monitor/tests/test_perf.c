@@ -0,0 +1,153 @@
+// tests/test_perf.c - contadores perf_event_open contra os relógios de CPU e o getrusage
+#define _GNU_SOURCE  // RUSAGE_SELF completo, usleep
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "../include/perf_counters.h"
+
+static volatile int thread_rodando = 0;
+
+static long long cpu_ns(clockid_t relogio) {
+    struct timespec ts;
+    clock_gettime(relogio, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* 200 ms de CPU e depois 50 sleeps curtos (trocas de contexto voluntárias) */
+static void *trabalhar(void *arg) {
+    (void)arg;
+    thread_rodando = 1;
+    while (thread_rodando == 1) {}  // espera a primeira leitura abrir o grupo desta thread
+
+    long long inicio = cpu_ns(CLOCK_THREAD_CPUTIME_ID);
+    volatile unsigned long long x = 0;
+    while (cpu_ns(CLOCK_THREAD_CPUTIME_ID) - inicio < 200000000LL) x++;
+    for (int k = 0; k < 50; k++) usleep(1000);
+    return NULL;
+}
+
+/* ==================== TESTE 1: TASK-CLOCK E THREADS ==================== */
+
+static int teste_task_clock(perf_contadores_t *pc) {
+    printf("\n=== TESTE 1: task-clock de uma thread que já terminou ===\n");
+
+    pthread_t th;
+    if (pthread_create(&th, NULL, trabalhar, NULL) != 0) return -1;
+    while (thread_rodando == 0) {}
+
+    perf_leitura_t antes, depois;
+    if (perf_ler(pc, &antes) != 0) return -1;
+    long long cpu_antes = cpu_ns(CLOCK_PROCESS_CPUTIME_ID);
+    thread_rodando = 2;
+
+    pthread_join(th, NULL);
+    if (perf_ler(pc, &depois) != 0) return -1;
+    long long cpu_depois = cpu_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    double perf_ms = (double)(depois.valores[PERF_EV_TASK_CLOCK] - antes.valores[PERF_EV_TASK_CLOCK]) / 1e6;
+    double rel_ms  = (double)(cpu_depois - cpu_antes) / 1e6;
+    unsigned long long trocas = depois.valores[PERF_EV_TROCAS_CONTEXTO] - antes.valores[PERF_EV_TROCAS_CONTEXTO];
+    printf("task-clock: %.2f ms | CLOCK_PROCESS_CPUTIME_ID: %.2f ms | trocas de contexto: %llu | "
+           "threads: %d -> %d\n", perf_ms, rel_ms, trocas, antes.threads, depois.threads);
+
+    int erro = 0;
+    if (perf_ms < 190.0 || perf_ms > rel_ms * 1.05 + 2.0 || perf_ms < rel_ms * 0.95 - 2.0) {
+        fprintf(stderr, "task-clock fora de 5%% do relógio de CPU do processo\n");
+        erro = 1;
+    }
+    if (!perf_evento_disponivel(pc, PERF_EV_TROCAS_CONTEXTO)) {
+        // só modo usuário: o evento é do kernel e o contador fica em 0
+        printf("trocas de contexto indisponíveis (só modo usuário); verificação ignorada\n");
+        if (trocas != 0 || perf_evento_disponivel(pc, PERF_EV_MIGRACOES)) {
+            fprintf(stderr, "Evento do kernel contado no modo só usuário\n");
+            erro = 1;
+        }
+    } else if (trocas < 50) {
+        fprintf(stderr, "Esperadas ao menos 50 trocas de contexto (sleeps)\n");
+        erro = 1;
+    }
+    // a thread terminou: o grupo foi fechado, mas a contagem continua no total
+    if (antes.threads < 2 || depois.threads != antes.threads - 1) {
+        fprintf(stderr, "Contagem de threads inesperada\n");
+        erro = 1;
+    }
+    for (int ev = 0; ev < PERF_NUM_EVENTOS; ev++) {
+        if (depois.valores[ev] < antes.valores[ev]) {
+            fprintf(stderr, "%s diminuiu\n", perf_nome_evento((perf_evento_t)ev));
+            erro = 1;
+        }
+    }
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 2: PAGE FAULTS ==================== */
+
+static int teste_faltas(perf_contadores_t *pc) {
+    printf("\n=== TESTE 2: page-faults contra getrusage ===\n");
+
+    perf_leitura_t antes, depois;
+    struct rusage ru_antes, ru_depois;
+    if (perf_ler(pc, &antes) != 0) return -1;
+    getrusage(RUSAGE_SELF, &ru_antes);
+
+    size_t tam = 16 * 1024 * 1024;
+    char *mem = (char *)malloc(tam);
+    if (!mem) return -1;
+    for (size_t k = 0; k < tam; k += 4096) mem[k] = (char)k;
+
+    getrusage(RUSAGE_SELF, &ru_depois);
+    if (perf_ler(pc, &depois) != 0) {
+        free(mem);
+        return -1;
+    }
+    free(mem);
+
+    double perf_f = (double)(depois.valores[PERF_EV_FALTAS] - antes.valores[PERF_EV_FALTAS]);
+    double ru_f   = (double)((ru_depois.ru_minflt + ru_depois.ru_majflt) -
+                             (ru_antes.ru_minflt + ru_antes.ru_majflt));
+    printf("page-faults: perf=%.0f getrusage=%.0f\n", perf_f, ru_f);
+
+    if (ru_f < 1.0 || perf_f < ru_f * 0.9 - 10.0 || perf_f > ru_f * 1.1 + 10.0) {
+        fprintf(stderr, "page-faults divergem do getrusage\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DE CONTADORES PERF - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    perf_contadores_t pc;
+    if (perf_abrir(&pc, getpid()) != 0) {
+        // kernel sem perf_event_open ou bloqueado (seccomp, paranoid = 3): nada a verificar
+        printf("\n⚠️  perf_event_open indisponível neste ambiente; testes ignorados.\n");
+        return EXIT_SUCCESS;
+    }
+    if (pc.so_usuario) printf("(perf_event_paranoid: contando só o modo usuário)\n");
+
+    int erro = 0;
+    if (teste_task_clock(&pc) != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (task-clock)\n");
+        erro = 1;
+    }
+    if (teste_faltas(&pc) != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (page-faults)\n");
+        erro = 1;
+    }
+    perf_fechar(&pc);
+
+    if (!erro) {
+        printf("\n✅ Todos os testes de contadores perf foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes de contadores perf falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
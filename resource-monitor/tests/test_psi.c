@@ -0,0 +1,136 @@
+// tests/test_psi.c - interpretação do PSI e gatilho POLLPRI com contenção de CPU real
+#define _GNU_SOURCE  // sched_setaffinity, CPU_SET
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../include/psi.h"
+
+/* ==================== TESTE 1: INTERPRETAÇÃO ==================== */
+
+static int teste_interpretar(void) {
+    printf("\n=== TESTE 1: psi_interpretar e psi_gatilho_interpretar ===\n");
+
+    psi_t p;
+    const char *com_full = "some avg10=12.50 avg60=3.25 avg300=0.75 total=123456789\n"
+                           "full avg10=1.00 avg60=0.50 avg300=0.10 total=4242\n";
+    if (psi_interpretar(com_full, &p) != 0 || !p.tem_full || p.some.avg10 != 12.5 ||
+        p.some.total_us != 123456789ULL || p.full.avg60 != 0.5 || p.full.total_us != 4242ULL) {
+        fprintf(stderr, "Arquivo com some/full interpretado incorretamente\n");
+        return -1;
+    }
+    // /proc/pressure/cpu em kernels < 5.13 só tem a linha some
+    if (psi_interpretar("some avg10=0.00 avg60=0.00 avg300=0.00 total=7\n", &p) != 0 ||
+        p.tem_full || p.some.total_us != 7ULL) {
+        fprintf(stderr, "Arquivo só com some interpretado incorretamente\n");
+        return -1;
+    }
+    if (psi_interpretar("lixo\n", &p) == 0) {
+        fprintf(stderr, "Conteúdo inválido aceito\n");
+        return -1;
+    }
+
+    psi_gatilho_t g;
+    if (psi_gatilho_interpretar("memory full 150ms 2s system.slice", &g) != 0 ||
+        g.recurso != PSI_MEMORIA || !g.full || g.limite_us != 150000U || g.janela_us != 2000000U ||
+        !g.de_cgroup || strcmp(g.cgroup, "system.slice") != 0) {
+        fprintf(stderr, "Gatilho válido interpretado incorretamente\n");
+        return -1;
+    }
+    printf("(as três mensagens a seguir são esperadas)\n");
+    if (psi_gatilho_interpretar("disk some 1ms 1s", &g) == 0 ||
+        psi_gatilho_interpretar("cpu some 100ms 20s", &g) == 0 ||
+        psi_gatilho_interpretar("cpu some 3s 2s", &g) == 0) {
+        fprintf(stderr, "Gatilho inválido aceito\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* ==================== TESTE 2: GATILHO ==================== */
+
+static pid_t queimar_cpu0(void) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(0, &cpus);
+        sched_setaffinity(0, sizeof(cpus), &cpus);
+        volatile unsigned long long x = 0;
+        for (;;) x++;
+    }
+    return pid;
+}
+
+static int teste_gatilho(void) {
+    printf("\n=== TESTE 2: gatilho cpu some acorda o poll sob contenção ===\n");
+
+    psi_t antes;
+    if (psi_ler_sistema(PSI_CPU, &antes) != 0) {
+        printf("⚠️  /proc/pressure indisponível (kernel sem PSI ou psi=0); teste ignorado.\n");
+        return 0;
+    }
+
+    psi_gatilho_t g;
+    if (psi_gatilho_interpretar("cpu some 50ms 2s", &g) != 0) return -1;
+    int fd = psi_gatilho_abrir(&g);
+    if (fd < 0) {
+        printf("⚠️  gatilho PSI não pôde ser registrado neste ambiente; teste ignorado.\n");
+        return 0;
+    }
+
+    // dois processos presos ao mesmo core: um sempre espera na run queue
+    pid_t a = queimar_cpu0(), b = queimar_cpu0();
+    struct pollfd pfd = { fd, POLLPRI, 0 };
+    int n = poll(&pfd, 1, 6000);
+
+    psi_t depois;
+    int lido = psi_ler_sistema(PSI_CPU, &depois);
+    if (a > 0) kill(a, SIGKILL);
+    if (b > 0) kill(b, SIGKILL);
+    if (a > 0) waitpid(a, NULL, 0);
+    if (b > 0) waitpid(b, NULL, 0);
+    close(fd);
+
+    printf("poll=%d revents=0x%x | cpu some total: +%.1f ms\n", n, pfd.revents,
+           lido == 0 ? (double)(depois.some.total_us - antes.some.total_us) / 1e3 : -1.0);
+    if (n != 1 || !(pfd.revents & POLLPRI)) {
+        fprintf(stderr, "Gatilho não disparou com contenção de CPU\n");
+        return -1;
+    }
+    if (lido != 0 || depois.some.total_us < antes.some.total_us + 50000ULL) {
+        fprintf(stderr, "total some não cresceu ao menos o limite do gatilho\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DE PRESSÃO (PSI) - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_interpretar() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (interpretação)\n");
+        erro = 1;
+    }
+    if (teste_gatilho() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (gatilho)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes de PSI foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes de PSI falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
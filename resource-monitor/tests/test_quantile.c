@@ -0,0 +1,134 @@
+// tests/test_quantile.c - precisão dos percentis contra a ordenação exata e mesclagem
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/quantile.h"
+
+#define N_AMOSTRAS 200000
+
+static int comparar_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Gerador fixo (xorshift): o teste é reprodutível */
+static unsigned long long estado_rng = 88172645463325252ULL;
+static double aleatorio(void) {
+    estado_rng ^= estado_rng << 13;
+    estado_rng ^= estado_rng >> 7;
+    estado_rng ^= estado_rng << 17;
+    return (double)(estado_rng >> 11) / 9007199254740992.0;  // [0, 1)
+}
+
+/* ==================== TESTE 1: ERRO RELATIVO ==================== */
+
+static int teste_precisao(void) {
+    printf("\n=== TESTE 1: Percentis contra a ordenação exata ===\n");
+
+    double *valores = (double *)malloc(N_AMOSTRAS * sizeof(double));
+    quantil_t q;
+    if (!valores || quantil_iniciar(&q) != 0) {
+        free(valores);
+        return -1;
+    }
+
+    // cauda longa (de ~1 a ~1e6), como RSS em kB ou taxas de I/O
+    for (int k = 0; k < N_AMOSTRAS; k++) {
+        valores[k] = exp(aleatorio() * 14.0);
+        quantil_registrar(&q, valores[k]);
+    }
+    qsort(valores, N_AMOSTRAS, sizeof(double), comparar_double);
+
+    static const double ps[] = { 0.01, 0.25, 0.50, 0.90, 0.99, 0.999 };
+    double pior = 0.0;
+    for (size_t k = 0; k < sizeof(ps) / sizeof(ps[0]); k++) {
+        size_t pos = (size_t)ceil(ps[k] * N_AMOSTRAS) - 1;
+        double exato = valores[pos];
+        double erro  = fabs(quantil_valor(&q, ps[k]) - exato) / exato;
+        if (erro > pior) pior = erro;
+    }
+
+    int erro = 0;
+    if (pior > 1.0 / (2.0 * QUANTIL_SUB) ||
+        quantil_valor(&q, 0.0) != valores[0] || quantil_valor(&q, 1.0) != valores[N_AMOSTRAS - 1]) {
+        fprintf(stderr, "Erro relativo %.4f%% acima do limite\n", pior * 100.0);
+        erro = 1;
+    }
+    printf("Pior erro relativo: %.3f%% (limite %.3f%%)\n", pior * 100.0, 50.0 / QUANTIL_SUB);
+
+    free(valores);
+    quantil_liberar(&q);
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 2: MESCLAGEM ==================== */
+
+static int teste_mesclagem(void) {
+    printf("\n=== TESTE 2: Mesclagem igual ao estimador único ===\n");
+
+    quantil_t unico, partes[4], total;
+    if (quantil_iniciar(&unico) != 0 || quantil_iniciar(&total) != 0) return -1;
+    for (int k = 0; k < 4; k++) {
+        if (quantil_iniciar(&partes[k]) != 0) return -1;
+    }
+
+    // zeros e percentuais de CPU, distribuídos entre quatro "threads"
+    for (int k = 0; k < 40000; k++) {
+        double v = (k % 10 == 0) ? 0.0 : aleatorio() * 100.0;
+        quantil_registrar(&unico, v);
+        quantil_registrar(&partes[k % 4], v);
+    }
+    for (int k = 0; k < 4; k++) quantil_mesclar(&total, &partes[k]);
+
+    int erro = 0;
+    if (total.contagem != unico.contagem || total.zeros != unico.zeros ||
+        total.min != unico.min || total.max != unico.max ||
+        memcmp(total.baldes, unico.baldes, QUANTIL_BALDES * sizeof(uint32_t)) != 0 ||
+        quantil_valor(&total, 0.05) != 0.0) {
+        fprintf(stderr, "Mesclagem diverge do estimador único\n");
+        erro = 1;
+    }
+
+    quantil_t vazio;
+    if (quantil_iniciar(&vazio) != 0) return -1;
+    if (quantil_valor(&vazio, 0.5) != 0.0 || quantil_mesclar(&total, &vazio) != 0 ||
+        total.contagem != 40000) {
+        fprintf(stderr, "Estimador vazio tratado incorretamente\n");
+        erro = 1;
+    }
+    printf("p50=%.2f p99=%.2f (%llu amostras, %llu zeros)\n",
+           quantil_valor(&total, 0.5), quantil_valor(&total, 0.99), total.contagem, total.zeros);
+
+    quantil_liberar(&vazio);
+    quantil_liberar(&unico);
+    quantil_liberar(&total);
+    for (int k = 0; k < 4; k++) quantil_liberar(&partes[k]);
+    return erro ? -1 : 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DE PERCENTIS - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_precisao() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (Precisão)\n");
+        erro = 1;
+    }
+    if (teste_mesclagem() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (Mesclagem)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes de percentis foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes de percentis falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
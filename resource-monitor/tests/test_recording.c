@@ -0,0 +1,191 @@
+// tests/test_recording.c - ida e volta do formato binário colunar
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/recording.h"
+
+static const gravacao_coluna_t COLUNAS[] = {
+    { "timestamp", GRAV_TEMPO, GRAV_DELTA2, 0 },
+    { "contador",  GRAV_INT,   GRAV_DELTA,  0 },
+    { "percent",   GRAV_FLOAT, GRAV_XOR,    2 },
+};
+#define NUM_COLUNAS 3
+
+/* Linhas suficientes para fechar um bloco cheio e deixar um parcial */
+#define NUM_LINHAS (GRAVACAO_LINHAS_BLOCO + 1234)
+
+static void gerar_linha(int k, gravacao_valor_t *linha) {
+    // relógio a 1 Hz com jitter, contador crescente com saltos, percentual que repete
+    linha[0].i = 1700000000000000000LL + (long long)k * 1000000000LL + (k % 7) * 1000;
+    linha[1].i = (k % 100 == 0) ? -(long long)k * 4096 : (long long)k * 3;
+    linha[2].f = (k % 5 == 0) ? 12.5 : (double)(k % 1000) / 7.0;
+}
+
+/* ==================== TESTE 1: IDA E VOLTA ==================== */
+
+static int teste_ida_e_volta(void) {
+    printf("\n=== TESTE 1: Ida e volta (%d linhas) ===\n", NUM_LINHAS);
+
+    FILE *arq = tmpfile();
+    if (!arq) {
+        perror("tmpfile");
+        return -1;
+    }
+
+    gravador_t g;
+    if (gravador_abrir(&g, arq, "teste", COLUNAS, NUM_COLUNAS) != 0) {
+        fclose(arq);
+        return -1;
+    }
+    gravacao_valor_t linha[NUM_COLUNAS];
+    for (int k = 0; k < NUM_LINHAS; k++) {
+        gerar_linha(k, linha);
+        if (gravador_linha(&g, linha) != 0) {
+            gravador_fechar(&g);
+            fclose(arq);
+            return -1;
+        }
+    }
+    if (gravador_fechar(&g) != 0) {
+        fclose(arq);
+        return -1;
+    }
+    printf("Gravados %llu bytes (%.2f bytes/linha)\n",
+           g.total_bytes, (double)g.total_bytes / NUM_LINHAS);
+
+    rewind(arq);
+    leitor_gravacao_t l;
+    if (leitor_abrir(&l, arq) != 0) {
+        fclose(arq);
+        return -1;
+    }
+
+    int erro = strcmp(l.descricao, "teste") != 0 || l.num_colunas != NUM_COLUNAS;
+    gravacao_valor_t lida[NUM_COLUNAS], esperada[NUM_COLUNAS];
+    int k = 0, rc;
+    while (!erro && (rc = leitor_proxima(&l, lida)) == 1) {
+        gerar_linha(k, esperada);
+        if (lida[0].i != esperada[0].i || lida[1].i != esperada[1].i ||
+            memcmp(&lida[2].f, &esperada[2].f, sizeof(double)) != 0) {
+            fprintf(stderr, "Linha %d diverge\n", k);
+            erro = 1;
+        }
+        k++;
+    }
+    if (!erro && (rc != 0 || k != NUM_LINHAS)) {
+        fprintf(stderr, "Lidas %d de %d linhas (rc=%d)\n", k, NUM_LINHAS, rc);
+        erro = 1;
+    }
+
+    leitor_fechar(&l);
+    fclose(arq);
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 2: VALORES EXTREMOS ==================== */
+
+static int teste_extremos(void) {
+    printf("\n=== TESTE 2: Valores extremos ===\n");
+
+    static const long long inteiros[] = { 0, -1, 9223372036854775807LL,
+                                          -9223372036854775807LL - 1, 42, 42 };
+    const double reais[] = { 0.0, -0.0, NAN, INFINITY, 1e-300, 1e300 };
+    const size_t n = sizeof(inteiros) / sizeof(inteiros[0]);
+
+    FILE *arq = tmpfile();
+    if (!arq) {
+        perror("tmpfile");
+        return -1;
+    }
+
+    gravador_t g;
+    if (gravador_abrir(&g, arq, NULL, COLUNAS, NUM_COLUNAS) != 0) {
+        fclose(arq);
+        return -1;
+    }
+    for (size_t k = 0; k < n; k++) {
+        gravacao_valor_t linha[NUM_COLUNAS];
+        linha[0].i = inteiros[k];
+        linha[1].i = inteiros[n - 1 - k];
+        linha[2].f = reais[k];
+        gravador_linha(&g, linha);
+    }
+    gravador_fechar(&g);
+
+    rewind(arq);
+    leitor_gravacao_t l;
+    if (leitor_abrir(&l, arq) != 0) {
+        fclose(arq);
+        return -1;
+    }
+
+    int erro = 0;
+    gravacao_valor_t lida[NUM_COLUNAS];
+    for (size_t k = 0; k < n && !erro; k++) {
+        if (leitor_proxima(&l, lida) != 1 || lida[0].i != inteiros[k] ||
+            lida[1].i != inteiros[n - 1 - k] ||
+            memcmp(&lida[2].f, &reais[k], sizeof(double)) != 0) {
+            fprintf(stderr, "Valor extremo %zu diverge\n", k);
+            erro = 1;
+        }
+    }
+    leitor_fechar(&l);
+    fclose(arq);
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 3: ARQUIVO INVÁLIDO ==================== */
+
+static int teste_arquivo_invalido(void) {
+    printf("\n=== TESTE 3: Arquivo inválido ===\n");
+
+    FILE *arq = tmpfile();
+    if (!arq) {
+        perror("tmpfile");
+        return -1;
+    }
+    fputs("timestamp,amostra\n", arq);
+    rewind(arq);
+
+    leitor_gravacao_t l;
+    int rc = leitor_abrir(&l, arq);
+    fclose(arq);
+    if (rc == 0) {
+        leitor_fechar(&l);
+        fprintf(stderr, "CSV aceito como gravação\n");
+        return -1;
+    }
+    printf("CSV rejeitado corretamente.\n");
+    return 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DA GRAVAÇÃO BINÁRIA - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_ida_e_volta() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (Ida e volta)\n");
+        erro = 1;
+    }
+    if (teste_extremos() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (Valores extremos)\n");
+        erro = 1;
+    }
+    if (teste_arquivo_invalido() != 0) {
+        fprintf(stderr, "ERRO no Teste 3 (Arquivo inválido)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes de gravação foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes de gravação falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}
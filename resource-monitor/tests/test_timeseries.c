@@ -0,0 +1,167 @@
+// tests/test_timeseries.c - agregação por nível, anel circular, limite de séries e tendência do histórico
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/timeseries.h"
+
+#define SEG 1000000000LL
+
+/* ==================== TESTE 1: AGREGAÇÃO 10 S / 1 MIN ==================== */
+
+static int teste_agregacao(void) {
+    printf("\n=== TESTE 1: Agregação nos níveis de 10 s e 1 min ===\n");
+
+    historico_t h;
+    if (hist_iniciar(&h, 0) != 0) return -1;
+
+    // 125 s a 1 Hz com valor = segundo; começa em um minuto cheio
+    long long base = 1700000040LL * SEG;
+    for (int s = 0; s < 125; s++) {
+        hist_registrar(&h, 42, "cpu_percent", base + s * SEG + 250000000LL, (double)s);
+    }
+    // fora de ordem: só o nível bruto guarda
+    hist_registrar(&h, 42, "cpu_percent", base + 5 * SEG, 1000.0);
+
+    hist_ponto_t p[32];
+    int erro = 0;
+
+    size_t n = hist_consultar(&h, 42, "cpu_percent", HIST_10S, 0, p, 32);
+    if (n != 13 || p[0].inicio_ns != base || p[0].contagem != 10 ||
+        p[0].min != 0.0 || p[0].max != 9.0 || hist_media(&p[0]) != 4.5 ||
+        p[12].contagem != 5 || p[12].ultimo != 124.0) {
+        fprintf(stderr, "10 s: %zu pontos, primeiro contagem=%u min=%.1f max=%.1f\n",
+                n, n ? p[0].contagem : 0, n ? p[0].min : 0, n ? p[0].max : 0);
+        erro = 1;
+    }
+
+    n = hist_consultar(&h, 42, "cpu_percent", HIST_1MIN, 0, p, 32);
+    if (n != 3 || p[1].inicio_ns != base + 60 * SEG || p[1].contagem != 60 ||
+        p[1].min != 60.0 || p[1].max != 119.0) {
+        fprintf(stderr, "1 min: %zu pontos\n", n);
+        erro = 1;
+    }
+
+    hist_ponto_t r;
+    if (hist_resumo(&h, 42, "cpu_percent", HIST_BRUTO, 0, &r) != 0 ||
+        r.contagem != 126 || r.max != 1000.0 || r.ultimo != 1000.0) {
+        fprintf(stderr, "Resumo bruto incorreto\n");
+        erro = 1;
+    }
+
+    // a amostra fora de ordem fica no fim do anel bruto, com o instante da anterior
+    n = hist_consultar(&h, 42, "cpu_percent", HIST_BRUTO, base + 120 * SEG, p, 32);
+    if (n != 6 || p[0].ultimo != 120.0 || p[5].ultimo != 1000.0 ||
+        p[5].inicio_ns != base + 124 * SEG + 250000000LL) {
+        fprintf(stderr, "Consulta bruta após amostra fora de ordem: %zu pontos\n", n);
+        erro = 1;
+    }
+
+    // consulta limitada: só os mais recentes, do mais antigo ao mais novo
+    n = hist_consultar(&h, 42, "cpu_percent", HIST_10S, base + 100 * SEG, p, 2);
+    if (n != 2 || p[0].inicio_ns != base + 110 * SEG || p[1].inicio_ns != base + 120 * SEG) {
+        fprintf(stderr, "Consulta com desde/max incorreta (%zu pontos)\n", n);
+        erro = 1;
+    }
+
+    printf("Níveis: 10 s com 13 intervalos, 1 min com 3\n");
+    hist_destruir(&h);
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 2: ANEL E LIMITES ==================== */
+
+static int teste_limites(void) {
+    printf("\n=== TESTE 2: Anel circular e limite de séries ===\n");
+
+    historico_t h;
+    if (hist_iniciar(&h, 2) != 0) return -1;
+    int erro = 0;
+
+    // o dobro da capacidade: sobram as HIST_CAP_BRUTO amostras mais novas
+    for (int k = 0; k < 2 * HIST_CAP_BRUTO; k++) {
+        hist_registrar(&h, 1, "rss_kb", (long long)k * SEG, (double)k);
+    }
+    hist_ponto_t r;
+    if (hist_resumo(&h, 1, "rss_kb", HIST_BRUTO, 0, &r) != 0 ||
+        r.contagem != HIST_CAP_BRUTO || r.min != (double)HIST_CAP_BRUTO ||
+        r.ultimo != 2.0 * HIST_CAP_BRUTO - 1) {
+        fprintf(stderr, "Anel bruto não descartou as amostras antigas\n");
+        erro = 1;
+    }
+
+    if (hist_registrar(&h, 1, "vsz_kb", 0, 1.0) != 0 ||
+        hist_registrar(&h, 2, "rss_kb", 0, 1.0) != -1 || h.recusadas != 1) {
+        fprintf(stderr, "Limite de séries não respeitado\n");
+        erro = 1;
+    }
+
+    hist_remover_alvo(&h, 1);
+    if (h.num_series != 0 || hist_registrar(&h, 2, "rss_kb", 0, 1.0) != 0) {
+        fprintf(stderr, "Remoção do alvo não liberou as séries\n");
+        erro = 1;
+    }
+
+    printf("Séries: %zu, recusadas: %lu\n", h.num_series, h.recusadas);
+    hist_destruir(&h);
+    return erro ? -1 : 0;
+}
+
+/* ==================== TESTE 3: LINHA DE TENDÊNCIA ==================== */
+
+static int teste_tendencia(void) {
+    printf("\n=== TESTE 3: Linha de tendência desde a 1ª leitura ===\n");
+
+    historico_t h;
+    if (hist_iniciar(&h, 0) != 0) return -1;
+    for (int k = 0; k < 5; k++) {
+        hist_registrar(&h, 7, "rss_kb", (long long)k * SEG, 100.0 + 10.0 * k);
+    }
+
+    char *texto = NULL;
+    size_t tam = 0;
+    FILE *out = open_memstream(&texto, &tam);
+    if (!out) {
+        hist_destruir(&h);
+        return -1;
+    }
+    hist_imprimir_tendencia(out, &h, 7, "rss_kb", "RSS", "KB");
+    fclose(out);
+    hist_destruir(&h);
+
+    printf("%s", texto);
+    // 100 -> 140 em 5 leituras: a variação é contra a mais antiga, não a mais nova
+    int erro = !strstr(texto, "5 leituras, +40.00 desde a 1ª");
+    if (erro) fprintf(stderr, "Tendência não compara com a primeira leitura\n");
+    free(texto);
+    return erro ? -1 : 0;
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf("  TESTES DO HISTÓRICO EM MEMÓRIA - RESOURCE MONITOR\n");
+    printf("============================================\n");
+
+    int erro = 0;
+    if (teste_agregacao() != 0) {
+        fprintf(stderr, "ERRO no Teste 1 (Agregação)\n");
+        erro = 1;
+    }
+    if (teste_limites() != 0) {
+        fprintf(stderr, "ERRO no Teste 2 (Anel e limites)\n");
+        erro = 1;
+    }
+    if (teste_tendencia() != 0) {
+        fprintf(stderr, "ERRO no Teste 3 (Tendência)\n");
+        erro = 1;
+    }
+
+    if (!erro) {
+        printf("\n✅ Todos os testes do histórico foram executados com sucesso!\n");
+    } else {
+        printf("\n❌ Alguns testes do histórico falharam.\n");
+    }
+    return erro ? EXIT_FAILURE : EXIT_SUCCESS;
+}